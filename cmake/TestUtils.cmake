@@ -15,7 +15,19 @@ macro (delphyne_build_tests)
     target_link_libraries(
       ${BINARY_NAME}
         ignition-common3::ignition-common3
+        delphyne_gui::field_index
+        delphyne_gui::frame_cache
+        delphyne_gui::field_path
         delphyne_gui::global_attributes
+        delphyne_gui::lane_index
+        delphyne_gui::log_index
+        delphyne_gui::log_stats
+        delphyne_gui::message_history
+        delphyne_gui::raw_recorder
+        delphyne_gui::road_mesh
+        delphyne_gui::subscription_hub
+        delphyne_gui::teleop_session
+        maliput::plugin
         pthread
     )
 
@@ -51,8 +51,11 @@ simulation.
 ##############################################################################
 
 import argparse
+import concurrent.futures
 import contextlib
+import hashlib
 import os
+import re
 import shutil
 import sys
 import tempfile
@@ -87,24 +90,272 @@ def is_log_file(path):
                 and BUNDLE_DIRNAME in members)
 
 
-@contextlib.contextmanager
-def open_log_file(path):
+def get_log_index_path(path):
+    """
+    Returns where the timeline index of the Delphyne log file at
+    `path` is cached. The index is keyed by the log file location,
+    size and modification time, so it survives across replays of
+    the same log and is rebuilt when the log changes.
+    """
+    if 'HOME' not in os.environ:
+        return None
+    stat = os.stat(path)
+    key = '{}:{}:{}'.format(os.path.abspath(path), stat.st_size,
+                            stat.st_mtime_ns)
+    index_dir = os.path.join(os.environ['HOME'], '.delphyne', 'cache',
+                             'log_index')
+    os.makedirs(index_dir, exist_ok=True)
+    return os.path.join(
+        index_dir, hashlib.sha1(key.encode()).hexdigest() + '.index')
+
+
+# Default disk budget of the extraction cache, in GiB.
+DEFAULT_CACHE_BUDGET_GB = 8
+# Buffer size used to stream members out of log files.
+EXTRACTION_BUFFER_SIZE = 1 << 20
+
+
+def get_extraction_cache_dir():
+    """
+    Returns where Delphyne log files are extracted to be reused
+    across replays, or None if there is no such location.
+    """
+    if 'HOME' not in os.environ:
+        return None
+    cache_dir = os.path.join(os.environ['HOME'], '.delphyne', 'cache',
+                             'extracted')
+    os.makedirs(cache_dir, exist_ok=True)
+    return cache_dir
+
+
+def get_log_content_key(archive):
+    """
+    Returns a key of the content of the log file `archive`, out of
+    its members names, CRCs and sizes. Logs with the same content
+    share the key wherever they are.
+    """
+    key = hashlib.sha1()
+    for info in sorted(archive.infolist(), key=lambda info: info.filename):
+        key.update('{}:{:08x}:{}\n'.format(
+            info.filename, info.CRC, info.file_size).encode())
+    return key.hexdigest()
+
+
+def get_directory_size(path):
+    """Returns the size of the files under `path`, in bytes."""
+    size = 0
+    for root, _, filenames in os.walk(path):
+        for filename in filenames:
+            with contextlib.suppress(OSError):
+                size += os.path.getsize(os.path.join(root, filename))
+    return size
+
+
+def get_in_use_dir(cache_dir):
+    """
+    Returns where replays mark the entries of the extraction cache
+    at `cache_dir` they use.
+    """
+    return os.path.join(os.path.dirname(cache_dir), 'in_use')
+
+
+def is_process_running(pid):
+    """Returns whether a process with `pid` is running."""
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        return True
+    return True
+
+
+def mark_in_use(cache_dir, entry_path):
+    """
+    Marks the extraction cache entry at `entry_path` as in use by this
+    process, so that no replay evicts it. Returns the marker path, to
+    be removed once the entry is not used anymore.
+    """
+    in_use_dir = get_in_use_dir(cache_dir)
+    os.makedirs(in_use_dir, exist_ok=True)
+    marker_path = os.path.join(in_use_dir, '{}.{}'.format(
+        os.path.basename(entry_path), os.getpid()))
+    open(marker_path, 'w').close()
+    return marker_path
+
+
+def is_in_use(cache_dir, entry_path):
+    """
+    Returns whether a running replay marked the extraction cache entry
+    at `entry_path` as in use. Markers of replays that are gone, e.g.
+    killed ones, are removed.
+    """
+    in_use_dir = get_in_use_dir(cache_dir)
+    prefix = os.path.basename(entry_path) + '.'
+    in_use = False
+    with contextlib.suppress(OSError):
+        for name in os.listdir(in_use_dir):
+            if not name.startswith(prefix):
+                continue
+            pid = name[len(prefix):]
+            if pid.isdigit() and is_process_running(int(pid)):
+                in_use = True
+            else:
+                with contextlib.suppress(OSError):
+                    os.remove(os.path.join(in_use_dir, name))
+    return in_use
+
+
+def get_partial_pid(name):
+    """
+    Returns the pid of the replay that extracts the partial file or
+    directory `name` of an extraction cache entry, see
+    extract_topic_log() and extract_bundle(), or None if `name` is
+    not a partial one.
+    """
+    match = re.fullmatch(
+        re.escape(TOPIC_LOG_FILENAME) + r'\.(\d+)\.partial', name)
+    if match is None:
+        match = re.fullmatch(r'partial\.(\d+)', name)
+    return int(match.group(1)) if match is not None else None
+
+
+def remove_stale_partials(cache_dir):
+    """
+    Removes the partial extractions in the entries of `cache_dir` that
+    no running replay is filling, e.g. those of killed replays.
+    """
+    with contextlib.suppress(OSError):
+        for entry_name in os.listdir(cache_dir):
+            entry_path = os.path.join(cache_dir, entry_name)
+            if not os.path.isdir(entry_path):
+                continue
+            for name in os.listdir(entry_path):
+                pid = get_partial_pid(name)
+                if pid is None or is_process_running(pid):
+                    continue
+                partial_path = os.path.join(entry_path, name)
+                if os.path.isdir(partial_path):
+                    shutil.rmtree(partial_path, ignore_errors=True)
+                else:
+                    with contextlib.suppress(OSError):
+                        os.remove(partial_path)
+
+
+def evict_extraction_cache(cache_dir, budget):
+    """
+    Removes the least recently used entries of `cache_dir` until it
+    fits `budget` bytes. Entries in use by a running replay, see
+    mark_in_use(), are never removed.
     """
-    Extracts the Delphyne log file at `path` at a temporary
-    location and returns, in order of appearance, ignition
-    transport topic logs and Delphyne bundled package as a
-    a tuple.
+    entries = []
+    for name in os.listdir(cache_dir):
+        entry_path = os.path.join(cache_dir, name)
+        with contextlib.suppress(OSError):
+            entries.append((os.path.getmtime(entry_path), entry_path,
+                            get_directory_size(entry_path)))
+    total_size = sum(size for _, _, size in entries)
+    for _, entry_path, size in sorted(entries):
+        if total_size <= budget:
+            break
+        if not is_in_use(cache_dir, entry_path):
+            shutil.rmtree(entry_path, ignore_errors=True)
+            total_size -= size
 
-    Upon context exit, extracted content is dropped.
+
+def extract_topic_log(path, entry_path):
+    """
+    Streams the topic log of the Delphyne log file at `path` into
+    `entry_path`, unless it is there already.
     """
+    topic_log_path = os.path.join(entry_path, TOPIC_LOG_FILENAME)
+    if os.path.isfile(topic_log_path):
+        return
+    partial_path = '{}.{}.partial'.format(topic_log_path, os.getpid())
     with zipfile.ZipFile(path) as archive:
-        tempdir = tempfile.mkdtemp()
-        try:
-            archive.extractall(tempdir)
-            yield (os.path.join(tempdir, TOPIC_LOG_FILENAME),
-                   os.path.join(tempdir, BUNDLE_DIRNAME))
-        finally:
-            shutil.rmtree(tempdir)
+        with archive.open(TOPIC_LOG_FILENAME) as source, \
+                open(partial_path, 'wb') as destination:
+            shutil.copyfileobj(source, destination, EXTRACTION_BUFFER_SIZE)
+    os.replace(partial_path, topic_log_path)
+
+
+def extract_bundle(path, entry_path):
+    """
+    Extracts the bundled package of the Delphyne log file at `path`
+    into `entry_path`, unless it is there already.
+    """
+    bundle_path = os.path.join(entry_path, BUNDLE_DIRNAME)
+    if os.path.isdir(bundle_path):
+        return
+    partial_path = os.path.join(entry_path, 'partial.{}'.format(os.getpid()))
+    with zipfile.ZipFile(path) as archive:
+        members = [name for name in archive.namelist()
+                   if name.startswith(BUNDLE_DIRNAME)]
+        archive.extractall(partial_path, members)
+    try:
+        os.rename(os.path.join(partial_path, BUNDLE_DIRNAME), bundle_path)
+    except OSError:
+        # Another replay extracted it first.
+        if not os.path.isdir(bundle_path):
+            raise
+    finally:
+        shutil.rmtree(partial_path, ignore_errors=True)
+
+
+def extract_log_file(path, entry_path, with_bundle):
+    """
+    Extracts the topic log and, if `with_bundle`, the bundled package
+    of the Delphyne log file at `path` into `entry_path`, in parallel.
+    """
+    os.makedirs(entry_path, exist_ok=True)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=2) as executor:
+        futures = [executor.submit(extract_topic_log, path, entry_path)]
+        if with_bundle:
+            futures.append(executor.submit(extract_bundle, path, entry_path))
+        for future in futures:
+            future.result()
+
+
+@contextlib.contextmanager
+def open_log_file(path, with_bundle=True,
+                  cache_budget=DEFAULT_CACHE_BUDGET_GB << 30):
+    """
+    Extracts the Delphyne log file at `path` and returns, in order of
+    appearance, ignition transport topic logs and Delphyne bundled
+    package (None unless `with_bundle`) as a tuple.
+
+    Extracted content is cached by the log file content, so replaying
+    the same log again does not extract it again. The least recently
+    used entries are dropped to keep the cache within `cache_budget`
+    bytes, except those in use by this or other running replays.
+    Without a cache location, or with a zero budget, content is
+    extracted at a temporary location and dropped upon context exit.
+    """
+    cache_dir = get_extraction_cache_dir() if cache_budget > 0 else None
+    if cache_dir is None:
+        entry_path = tempfile.mkdtemp()
+    else:
+        remove_stale_partials(cache_dir)
+        with zipfile.ZipFile(path) as archive:
+            entry_path = os.path.join(cache_dir, get_log_content_key(archive))
+        # Marked before extracting, so that no replay evicts the entry
+        # while it is being filled.
+        marker_path = mark_in_use(cache_dir, entry_path)
+    try:
+        extract_log_file(path, entry_path, with_bundle)
+        if cache_dir is not None:
+            # Entries modification time tracks their last use.
+            os.utime(entry_path)
+            evict_extraction_cache(cache_dir, cache_budget)
+        bundle_path = os.path.join(entry_path, BUNDLE_DIRNAME)
+        yield (os.path.join(entry_path, TOPIC_LOG_FILENAME),
+               bundle_path if with_bundle else None)
+    finally:
+        if cache_dir is None:
+            shutil.rmtree(entry_path)
+        else:
+            with contextlib.suppress(OSError):
+                os.remove(marker_path)
 
 
 def parse_arguments():
@@ -133,6 +384,12 @@ def parse_arguments():
         '-b', '--bare', action='store_true', default=False,
         help="If true, replay without visualization (default: False)."
     )
+    parser.add_argument(
+        '--cache-budget', type=float, default=DEFAULT_CACHE_BUDGET_GB,
+        help=("Disk budget in GiB of the extracted logs cache at"
+              " $HOME/.delphyne/cache/extracted, 0 disables it"
+              " (default: {}).".format(DEFAULT_CACHE_BUDGET_GB))
+    )
     return parser.parse_args()
 
 
@@ -164,7 +421,9 @@ def main():
         quit()
     print("Replaying logs at {}.".format(args.log_file))
 
-    with open_log_file(args.log_file) as (topic_log_path, bundle_path):
+    with open_log_file(args.log_file, with_bundle=not args.bare,
+                       cache_budget=int(args.cache_budget * (1 << 30))) as (
+                           topic_log_path, bundle_path):
         launch_manager = delphyne_gui.launcher.Launcher()
         try:
             replayer = "delphyne_replayer"
@@ -174,6 +433,8 @@ def main():
                     launch_manager, bundle_path=bundle_path,
                     ign_visualizer="visualizer",
                     layout="layout_for_playback.config",
+                    playback_log=topic_log_path,
+                    playback_index=get_log_index_path(args.log_file),
                 )
                 launch_manager.wait(float("Inf"))
         except RuntimeError as error_msg:
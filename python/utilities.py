@@ -84,10 +84,13 @@ def launch_interactive_simulation(simulation_runner,
 
 def launch_visualizer(launcher_manager, layout=None,
                       plugin_injection=None, plugin_name=None, bundle_path=None,
-                      ign_visualizer=None):
+                      ign_visualizer=None, playback_log=None,
+                      playback_index=None):
     """
     Launches the project's visualizer with a given layout and using the
-    given bundled package, if any.
+    given bundled package, if any. When replaying, `playback_log` and
+    `playback_index` point the playback plugin to the ignition transport log
+    and to the location of its timeline index.
     """
     if ign_visualizer is None:
         ign_visualizer = "visualizer"
@@ -103,6 +106,9 @@ def launch_visualizer(launcher_manager, layout=None,
         ign_visualizer_args.append("--plugin-name=" + plugin_name)
     if bundle_path:
         ign_visualizer_args.append("--package=" + bundle_path)
+    if playback_log and playback_index:
+        ign_visualizer_args.append("--playback-log=" + playback_log)
+        ign_visualizer_args.append("--playback-index=" + playback_index)
     launcher_manager.launch([ign_visualizer] + ign_visualizer_args)
 
 
@@ -0,0 +1,105 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "deferred_plugin.hh"
+
+#include <iostream>
+
+#include <ignition/common/Console.hh>
+#include <ignition/gui/Application.hh>
+#include <ignition/gui/qt.h>
+#include <ignition/plugin/Register.hh>
+#include <tinyxml2.h>
+
+namespace delphyne {
+namespace gui {
+
+void DeferredPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
+  if (!_pluginElem) {
+    ignerr << "Error reading plugin XML element " << std::endl;
+    return;
+  }
+  const tinyxml2::XMLElement* wrappedElem = _pluginElem->FirstChildElement("plugin");
+  if (wrappedElem == nullptr || wrappedElem->Attribute("filename") == nullptr) {
+    ignerr << "DeferredPlugin expects a nested <plugin filename=\"...\"> element." << std::endl;
+    return;
+  }
+  pluginFilename = wrappedElem->Attribute("filename");
+
+  tinyxml2::XMLPrinter printer;
+  wrappedElem->Accept(&printer);
+  pluginXml = printer.CStr();
+
+  if (title.empty()) {
+    title = pluginFilename;
+  }
+  // The card is created, and its configured state applied, once the plugin
+  // is added to the window, after this call.
+  QTimer::singleShot(0, this, &DeferredPlugin::WatchCardState);
+}
+
+void DeferredPlugin::WatchCardState() {
+  QQuickItem* card = CardItem();
+  if (card == nullptr) {
+    ignwarn << "DeferredPlugin [" << pluginFilename << "] has no card, use its load button." << std::endl;
+    return;
+  }
+  connect(card, &QQuickItem::stateChanged, this, &DeferredPlugin::OnCardStateChanged);
+  OnCardStateChanged(card->state());
+}
+
+void DeferredPlugin::OnCardStateChanged(const QString& _state) {
+  if (_state != kCollapsedState) {
+    OnShown();
+  }
+}
+
+void DeferredPlugin::OnShown() {
+  if (isLoaded || pluginFilename.empty()) {
+    return;
+  }
+  isLoaded = true;
+
+  tinyxml2::XMLDocument doc;
+  doc.Parse(pluginXml.c_str());
+  if (!ignition::gui::App()->LoadPlugin(pluginFilename, doc.FirstChildElement("plugin"))) {
+    ignerr << "Failed to load deferred plugin [" << pluginFilename << "]." << std::endl;
+    return;
+  }
+  // The placeholder cannot be removed while its own slot runs.
+  const std::string name = objectName().toStdString();
+  QTimer::singleShot(0, ignition::gui::App(), [name]() { ignition::gui::App()->RemovePlugin(name); });
+}
+
+}  // namespace gui
+}  // namespace delphyne
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(delphyne::gui::DeferredPlugin, ignition::gui::Plugin)
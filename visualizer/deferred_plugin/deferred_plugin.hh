@@ -0,0 +1,104 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <string>
+
+#include <ignition/gui/Plugin.hh>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Placeholder that loads another plugin the first time it is shown.
+/// @details The wrapped plugin is described by a nested `<plugin>` element,
+///          exactly as it would be written at the top level of the layout:
+///          @code{.xml}
+///          <plugin filename="DeferredPlugin">
+///            <ignition-gui>
+///              <title>Topics stats</title>
+///              <property key="state" type="string">docked_collapsed</property>
+///            </ignition-gui>
+///            <plugin filename="TopicsStats"/>
+///          </plugin>
+///          @endcode
+///          Until then, only the placeholder card exists: the wrapped plugin
+///          creates no transport node, no subscription and no QML. When the
+///          card leaves the `docked_collapsed` state, i.e. it is expanded or
+///          undocked, or its load button clicked, the wrapped plugin is
+///          loaded and the placeholder removes itself. A card that does not
+///          start collapsed loads its plugin right away. The loaded plugin is
+///          added after the rest of the plugins of the layout.
+///
+///          Only panels that start collapsed and have no work to do until
+///          shown should be wrapped, e.g. not those collecting data in the
+///          background.
+class DeferredPlugin : public ignition::gui::Plugin {
+  Q_OBJECT
+
+  Q_PROPERTY(QString pluginName READ PluginName CONSTANT)
+
+ public:
+  DeferredPlugin() = default;
+
+  /// @brief Stores the nested `<plugin>` element to load it later.
+  void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
+
+  /// @return The filename of the wrapped plugin.
+  Q_INVOKABLE QString PluginName() const { return QString::fromStdString(pluginFilename); }
+
+ public slots:
+  /// @brief Loads the wrapped plugin and removes the placeholder. Subsequent
+  ///        calls do nothing.
+  void OnShown();
+
+ private slots:
+  /// @brief Starts following the card state, once the card is set up.
+  void WatchCardState();
+
+  /// @brief Loads the wrapped plugin unless @p _state is the collapsed one.
+  void OnCardStateChanged(const QString& _state);
+
+ private:
+  /// @brief Card state of collapsed docked cards.
+  static constexpr char kCollapsedState[]{"docked_collapsed"};
+
+  // Filename of the wrapped plugin.
+  std::string pluginFilename;
+
+  // The nested `<plugin>` element, serialized.
+  std::string pluginXml;
+
+  // Whether the wrapped plugin was already loaded.
+  bool isLoaded{false};
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -32,7 +32,9 @@
 #include <iomanip>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <sstream>
+#include <utility>
 
 #include <delphyne/protobuf/agent_state_v.pb.h>
 #include <ignition/common/Console.hh>
@@ -40,14 +42,25 @@
 #include <ignition/gui/GuiEvents.hh>
 #include <ignition/gui/MainWindow.hh>
 #include <ignition/plugin/Register.hh>
-#include <ignition/rendering/RenderEngine.hh>
-#include <ignition/rendering/RenderingIface.hh>
 #include <ignition/rendering/Scene.hh>
 #include <ignition/rendering/Text.hh>
 #include <ignition/rendering/Visual.hh>
 
+#include "scene_notifier.hh"
+#include "visualizer/plugin_metrics.hh"
+
 namespace delphyne {
 namespace gui {
+namespace {
+
+// Time spent on each Render event, where the agent labels are drawn, and on
+// agent state updates.
+const PluginMetrics::CounterHandle kRenderMetrics = PluginMetrics::Instance()->Register("AgentInfoDisplay", "render");
+const PluginMetrics::CounterHandle kAgentStateMetrics =
+    PluginMetrics::Instance()->Register("AgentInfoDisplay", "agent_state");
+
+}  // namespace
+
 struct AgentInfoText {
   /// \brief The text display
   ignition::rendering::TextPtr text;
@@ -56,6 +69,9 @@ struct AgentInfoText {
 
 static constexpr double charHeight = 0.3;
 
+/// \brief Maximum distance from an agent position to its lane, in meters.
+static constexpr double kMaxLaneDistance = 0.5;
+
 /////////////////////////////////////////////////
 void AgentInfoDisplay::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   title = "Agent Info Display";
@@ -73,22 +89,25 @@ void AgentInfoDisplay::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   }
 
   ignition::gui::App()->findChild<ignition::gui::MainWindow*>()->installEventFilter(this);
+
+  SceneNotifier::Instance()->OnSceneAvailable(this, kEngineName, this->sceneName,
+                                              [this](ignition::rendering::ScenePtr _scene) {
+                                                this->scenePtr = _scene;
+                                                // Subscribe to agent info once the scene pointer is found
+                                                this->agentStateSubscription = SubscriptionHub::Instance()->Subscribe(
+                                                    "agents/state",
+                                                    [this](const SubscriptionHub::MessagePtr& _msg,
+                                                           const ignition::transport::MessageInfo&) {
+                                                      this->OnAgentState(_msg);
+                                                    });
+                                              });
 }
 
 /////////////////////////////////////////////////
 bool AgentInfoDisplay::eventFilter(QObject* _obj, QEvent* _event) {
   if (_event->type() == ignition::gui::events::Render::kType) {
-    if (nullptr == this->scenePtr) {
-      auto engine = ignition::rendering::engine(kEngineName);
-      this->scenePtr = engine->SceneByName(this->sceneName);
-      if (nullptr == this->scenePtr) {
-        ignwarn << "Scene \"" << this->sceneName << "\" not found, "
-                << "agent info display plugin won't work until the scene is created." << std::endl;
-      } else {
-        // Subscribe to agent info once the scene pointer is found
-        this->node.Subscribe("agents/state", &AgentInfoDisplay::OnAgentState, this);
-      }
-    } else if (this->dirty) {
+    const PluginMetrics::Scope metrics(kRenderMetrics);
+    if (nullptr != this->scenePtr && this->dirty) {
       this->ProcessMsg();
     }
   }
@@ -98,10 +117,15 @@ bool AgentInfoDisplay::eventFilter(QObject* _obj, QEvent* _event) {
 }
 
 /////////////////////////////////////////////////
-void AgentInfoDisplay::OnAgentState(const ignition::msgs::AgentState_V& _msg) {
+void AgentInfoDisplay::OnAgentState(const SubscriptionHub::MessagePtr& _msg) {
+  const PluginMetrics::Scope metrics(kAgentStateMetrics);
+  auto agentStates = std::dynamic_pointer_cast<const ignition::msgs::AgentState_V>(_msg);
+  if (agentStates == nullptr) {
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
-  this->msg.CopyFrom(_msg);
+  this->msg = std::move(agentStates);
   this->dirty = true;
 }
 
@@ -109,8 +133,12 @@ void AgentInfoDisplay::OnAgentState(const ignition::msgs::AgentState_V& _msg) {
 void AgentInfoDisplay::ProcessMsg() {
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
-  for (int i = 0; i < this->msg.states_size(); ++i) {
-    ignition::msgs::AgentState agent = this->msg.states(i);
+  if (this->msg == nullptr) {
+    return;
+  }
+  const std::shared_ptr<const LaneIndex> laneIndex = SharedLaneIndex::Get();
+  for (int i = 0; i < this->msg->states_size(); ++i) {
+    ignition::msgs::AgentState agent = this->msg->states(i);
     std::shared_ptr<AgentInfoText> agentInfoText;
     const std::string agentName = NameFromAgent(agent);
 
@@ -121,7 +149,7 @@ void AgentInfoDisplay::ProcessMsg() {
       agentInfoText = this->mapAgentInfoText[agentName];
     }
 
-    UpdateAgentLabel(agent, agentName, agentInfoText);
+    UpdateAgentLabel(agent, agentName, agentInfoText, laneIndex.get());
   }
 
   ChangeAgentInfoVisibility();
@@ -164,7 +192,7 @@ std::shared_ptr<AgentInfoText> AgentInfoDisplay::CreateAgentText(const std::stri
 
 /////////////////////////////////////////////////
 void AgentInfoDisplay::UpdateAgentLabel(const ignition::msgs::AgentState& _agent, const std::string& _agentName,
-                                        std::shared_ptr<AgentInfoText> _agentInfoText) {
+                                        std::shared_ptr<AgentInfoText> _agentInfoText, const LaneIndex* _laneIndex) {
   ignition::math::Vector3d pos;
   double roll = 0.0;
   double pitch = 0.0;
@@ -186,6 +214,12 @@ void AgentInfoDisplay::UpdateAgentLabel(const ignition::msgs::AgentState& _agent
   std::stringstream ss;
   ss << std::setprecision(2);
   ss << _agentName << ":\n pos:(" << pos << "), yaw:(" << yaw << ")\n vel:(" << linear_velocity << ")";
+  if (_laneIndex != nullptr) {
+    if (const std::optional<LaneIndex::Hit> hit = _laneIndex->FindLane(pos, kMaxLaneDistance)) {
+      ss << std::fixed << std::setprecision(1) << "\n lane: " << hit->lane->id().string() << " s:(" << hit->position.s()
+         << "), r:(" << hit->position.r() << ")";
+    }
+  }
   _agentInfoText->text->SetTextString(ss.str());
   _agentInfoText->textVis->SetLocalPose(ignition::math::Pose3d(pos.X(), pos.Y(), pos.Z() + 2.6, roll, pitch, yaw));
 }
@@ -38,6 +38,9 @@
 #include <ignition/rendering/RenderTypes.hh>
 #include <ignition/transport.hh>
 
+#include "visualizer/lane_index.hh"
+#include "visualizer/subscription_hub.hh"
+
 namespace delphyne {
 namespace gui {
 
@@ -47,13 +50,15 @@ struct AgentInfoText;
 /// @details ign-gui3 does not have DisplayPlugins, so this plugin
 ///          implements a slightly different logic to what the original ign-gui0
 ///          DisplayPlugin did. It subscribes to events emitted by the MainWindow and
-///          checks for `ignition::gui::events::Render` to make rendering calls. On its
-///          first Render event, it gets a pointer to the scene and subscribes to the
-///          agent info topic. On subsequent Render events, it checks for new agent info
+///          checks for `ignition::gui::events::Render` to make rendering calls. Once the
+///          SceneNotifier provides a pointer to the scene, it subscribes to the agent
+///          info topic. On subsequent Render events, it checks for new agent info
 ///          data and creates or updates a text geometry to display this data.
 ///          Typically, this plugin goes hand in hand with the Scene3D plugin.
 ///          The plugin UI has a checkbox to toggle visibility. It is paired
-///          with `isVisible`
+///          with `isVisible`.
+///          When a RoadNetworkViewer shows a road, the labels also show the
+///          lane each agent is on, found in the SharedLaneIndex.
 class AgentInfoDisplay : public ignition::gui::Plugin {
   Q_OBJECT
 
@@ -82,10 +87,9 @@ class AgentInfoDisplay : public ignition::gui::Plugin {
   void IsVisibleChanged();
 
  private:
-  /// @brief Callback for all installed event filters. On Render events, if the scene pointer
-  /// is not yet available, it will try to get it and then subscibe to the agent info topic if
-  /// successful. On subsequent calls, it will create and update text geometries if new data
-  /// is available (indicated by the dirty flag).
+  /// @brief Callback for all installed event filters. On Render events, once the scene pointer
+  /// is available, it will create and update text geometries if new data is available
+  /// (indicated by the dirty flag).
   /// @param[in] _obj Object that received the event
   /// @param[in] _event Event
   bool eventFilter(QObject* _obj, QEvent* _event) override;
@@ -105,8 +109,9 @@ class AgentInfoDisplay : public ignition::gui::Plugin {
   /// @brief Flag to indicate that new data is available for rendering.
   bool dirty{false};
 
-  /// @brief Message holding latest agent states
-  ignition::msgs::AgentState_V msg;
+  /// @brief Message holding latest agent states, shared with the other
+  ///        subscribers.
+  std::shared_ptr<const ignition::msgs::AgentState_V> msg;
 
   /// @brief Mutex to protect msg
   std::recursive_mutex mutex;
@@ -114,14 +119,14 @@ class AgentInfoDisplay : public ignition::gui::Plugin {
   /// @brief Map from agent name to AgentInfoText.
   std::map<std::string, std::shared_ptr<AgentInfoText>> mapAgentInfoText;
 
-  /// \brief A transport node.
-  ignition::transport::Node node;
+  /// \brief Subscription to the agent info topic.
+  std::unique_ptr<SubscriptionHub::Subscription> agentStateSubscription;
 
   /// @brief Toggles the visibility of the agent info.
   void ChangeAgentInfoVisibility();
 
   /// @brief Callback for agent info subscriber
-  void OnAgentState(const ignition::msgs::AgentState_V& _msg);
+  void OnAgentState(const SubscriptionHub::MessagePtr& _msg);
 
   /// @brief Extract the agent name from the topic name.
   std::string NameFromAgent(const ignition::msgs::AgentState& agent);
@@ -131,8 +136,10 @@ class AgentInfoDisplay : public ignition::gui::Plugin {
                                                  ignition::rendering::ScenePtr _scenePtr);
 
   /// @brief Update pose and content of floating text visuals.
+  /// @param _laneIndex Index of the shown road, to find the agent lane. It
+  ///        may be nullptr.
   void UpdateAgentLabel(const ignition::msgs::AgentState& _agent, const std::string& _agentName,
-                        std::shared_ptr<AgentInfoText> _agentInfoText);
+                        std::shared_ptr<AgentInfoText> _agentInfoText, const LaneIndex* _laneIndex);
 };
 
 }  // namespace gui
@@ -38,13 +38,21 @@
 #include <ignition/math/Color.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/plugin/Register.hh>
-#include <ignition/rendering/RenderEngine.hh>
-#include <ignition/rendering/RenderingIface.hh>
 #include <ignition/rendering/Scene.hh>
 #include <ignition/rendering/Visual.hh>
 
+#include "scene_notifier.hh"
+#include "visualizer/plugin_metrics.hh"
+
 namespace delphyne {
 namespace gui {
+namespace {
+
+// Time spent on each Render event, where the axes are drawn and shown or
+// hidden.
+const PluginMetrics::CounterHandle kRenderMetrics = PluginMetrics::Instance()->Register("OriginDisplay", "render");
+
+}  // namespace
 
 void OriginDisplay::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   title = "Origin Display";
@@ -63,14 +71,16 @@ void OriginDisplay::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   // Install event filter.
   ignition::gui::App()->findChild<ignition::gui::MainWindow*>()->installEventFilter(this);
 
-  // Set timer to get the scene.
-  timer.start(kTimerPeriodInMs, this);
+  // Get notified when the scene is available.
+  SceneNotifier::Instance()->OnSceneAvailable(this, kEngineName, sceneName,
+                                              [this](ignition::rendering::ScenePtr _scene) { scene = _scene; });
 }
 
 bool OriginDisplay::eventFilter(QObject* _obj, QEvent* _event) {
   // Hooking to the Render event to safely make rendering calls.
   // See https://github.com/ignitionrobotics/ign-gui/blob/ign-gui3/include/ignition/gui/GuiEvents.hh#L36-L37
   if (_event->type() == ignition::gui::events::Render::kType) {
+    const PluginMetrics::Scope metrics(kRenderMetrics);
     if (scene != nullptr) {
       if (!areAxesDrawn) {
         this->DrawAxes(scene);
@@ -86,23 +96,6 @@ bool OriginDisplay::eventFilter(QObject* _obj, QEvent* _event) {
   return QObject::eventFilter(_obj, _event);
 }
 
-void OriginDisplay::timerEvent(QTimerEvent* _event) {
-  if (_event->timerId() != timer.timerId()) {
-    return;
-  }
-
-  // Get the render engine.
-  // Note: we don't support other engines than Ogre.
-  auto engine = ignition::rendering::engine(kEngineName);
-  scene = engine->SceneByName(sceneName);
-  if (!scene) {
-    ignwarn << "Scene \"" << sceneName << "\" not found yet. Trying again in "
-            << " Trying again in " << kTimerPeriodInMs << "ms" << std::endl;
-    return;
-  }
-  timer.stop();
-}
-
 void OriginDisplay::SetIsVisible(bool _isVisible) {
   isVisible = _isVisible;
   IsVisibleChanged();
@@ -44,9 +44,9 @@ namespace gui {
 /// @details ign-gui3 does not have DisplayPlugins, so this plugin
 ///          implements a slightly different logic to what the original ign-gui0
 ///          DisplayPlugin did. It gets the scene name from the plugin
-///          configuration and tries to get a pointer to it. If the scene is not
-///          available, then it starts a timer and tries periodically to
-///          retrieve the scene.
+///          configuration and asks the SceneNotifier for a pointer to it. The
+///          axes are drawn on the first Render event after the scene becomes
+///          available.
 ///          Typically, this plugin goes hand in hand with the Scene3D plugin.
 ///          The plugin UI has a checkbox to toggle visibility. It is paired
 ///          with `isVisible`
@@ -58,11 +58,9 @@ class OriginDisplay : public ignition::gui::Plugin {
  public:
   OriginDisplay() = default;
 
-  /// @brief Loads the plugin configuration and tries to load the axes in the
-  ///        scene.
-  /// @details When the scene is not available, a timer is started to try every
-  ///          `kTimerPeriodInMs` ms to load the axes.
-  ///          It only works with ogre rendering engine.
+  /// @brief Loads the plugin configuration and requests the scene to draw the
+  ///        axes into.
+  /// @details It only works with ogre rendering engine.
   void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
 
   /// @{ isVisible accessors.
@@ -75,18 +73,12 @@ class OriginDisplay : public ignition::gui::Plugin {
   void IsVisibleChanged();
 
  protected:
-  /// @brief Timer event callback which handles the logic to get the scene.
-  void timerEvent(QTimerEvent* _event) override;
-
   /// \brief Filters ignition::gui::events::Render events to update the visualization of the axis if needed.
   /// \details To make this method be called by Qt Event System, install the event filter in target object.
   ///          \see QObject::installEventFilter() method.
   bool eventFilter(QObject* _obj, QEvent* _event) override;
 
  private:
-  /// @brief The period in milliseconds of the timer to try to draw the axes.
-  static constexpr int kTimerPeriodInMs{500};
-
   /// @brief The rendering engine name.
   const std::string kEngineName{"ogre"};
 
@@ -97,9 +89,6 @@ class OriginDisplay : public ignition::gui::Plugin {
   /// @brief Toggles the visibility of the axes.
   void ChangeAxesVisibility();
 
-  /// @brief Triggers an event every `kTimerPeriodInMs` to try to get the scene.
-  QBasicTimer timer;
-
   /// @brief The scene name.
   std::string sceneName{"scene"};
 
@@ -0,0 +1,110 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "scene_notifier.hh"
+
+#include <ignition/common/Console.hh>
+#include <ignition/gui/Application.hh>
+#include <ignition/gui/GuiEvents.hh>
+#include <ignition/gui/MainWindow.hh>
+#include <ignition/rendering/RenderEngine.hh>
+#include <ignition/rendering/RenderingIface.hh>
+#include <ignition/rendering/Scene.hh>
+
+namespace delphyne {
+namespace gui {
+
+SceneNotifier* SceneNotifier::Instance() {
+  // The instance is never deleted on purpose: it must outlive every plugin and
+  // must not be destroyed after the QApplication during static deinitialization.
+  static SceneNotifier* instance = new SceneNotifier();
+  return instance;
+}
+
+void SceneNotifier::OnSceneAvailable(QObject* _receiver, const std::string& _engineName, const std::string& _sceneName,
+                                     std::function<void(ignition::rendering::ScenePtr)> _callback) {
+  const auto sceneIt = scenes.find(_sceneName);
+  if (sceneIt != scenes.end()) {
+    const ignition::rendering::ScenePtr scene = sceneIt->second;
+    QMetaObject::invokeMethod(
+        _receiver, [scene, _callback]() { _callback(scene); }, Qt::QueuedConnection);
+    return;
+  }
+
+  const QString sceneName = QString::fromStdString(_sceneName);
+  connect(this, &SceneNotifier::SceneAvailable, _receiver, [this, sceneName, _callback](const QString& _name) {
+    if (_name == sceneName) {
+      _callback(Scene(_name.toStdString()));
+    }
+  });
+
+  pendingScenes.emplace(_sceneName, _engineName);
+  if (!isFilterInstalled) {
+    ignition::gui::App()->findChild<ignition::gui::MainWindow*>()->installEventFilter(this);
+    isFilterInstalled = true;
+  }
+}
+
+ignition::rendering::ScenePtr SceneNotifier::Scene(const std::string& _sceneName) const {
+  const auto sceneIt = scenes.find(_sceneName);
+  return sceneIt != scenes.end() ? sceneIt->second : nullptr;
+}
+
+bool SceneNotifier::eventFilter(QObject* _obj, QEvent* _event) {
+  // Render events are only sent once Scene3D is rendering, so there is no need
+  // to look for scenes at any other moment.
+  if (_event->type() == ignition::gui::events::Render::kType && !pendingScenes.empty()) {
+    ResolvePendingScenes();
+    if (pendingScenes.empty()) {
+      _obj->removeEventFilter(this);
+      isFilterInstalled = false;
+    }
+  }
+  // Standard event processing
+  return QObject::eventFilter(_obj, _event);
+}
+
+void SceneNotifier::ResolvePendingScenes() {
+  for (auto it = pendingScenes.begin(); it != pendingScenes.end();) {
+    auto engine = ignition::rendering::engine(it->second);
+    ignition::rendering::ScenePtr scene = engine != nullptr ? engine->SceneByName(it->first) : nullptr;
+    if (scene == nullptr) {
+      ++it;
+      continue;
+    }
+    ignmsg << "Scene \"" << it->first << "\" is available." << std::endl;
+    const QString sceneName = QString::fromStdString(it->first);
+    scenes.emplace(it->first, scene);
+    it = pendingScenes.erase(it);
+    emit SceneAvailable(sceneName);
+  }
+}
+
+}  // namespace gui
+}  // namespace delphyne
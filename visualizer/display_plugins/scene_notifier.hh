@@ -0,0 +1,108 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include <ignition/gui/qt.h>
+#include <ignition/rendering/RenderTypes.hh>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Resolves rendering scenes once and notifies every interested plugin.
+/// @details Display plugins need a pointer to the scene created by the Scene3D
+///          plugin, which is not available until the first frame is rendered.
+///          Instead of each plugin polling the render engine, they register a
+///          callback here. The notifier installs a single event filter on the
+///          MainWindow and only tries to resolve the pending scenes when an
+///          `ignition::gui::events::Render` event arrives, which is the moment
+///          Scene3D has a scene to render. Once every pending scene has been
+///          resolved the event filter is removed.
+///          Resolved scenes are cached, so plugins loaded later get notified
+///          right away.
+///          This class is not thread safe, it must be used from the Qt GUI
+///          thread only.
+class SceneNotifier : public QObject {
+  Q_OBJECT
+
+ public:
+  /// @return The process wide instance.
+  static SceneNotifier* Instance();
+
+  /// @brief Calls @p _callback with the scene @p _sceneName once it is
+  ///        available.
+  /// @details When the scene is still unknown, @p _callback is executed within
+  ///          the first Render event in which the scene is found, so rendering
+  ///          calls are safe. Otherwise, it is queued to the next event loop
+  ///          iteration.
+  /// @param _receiver The object whose lifetime bounds @p _callback. When it is
+  ///        destroyed, @p _callback is no longer called.
+  /// @param _engineName The rendering engine name, e.g. "ogre".
+  /// @param _sceneName The scene name, it must match the one in Scene3D.
+  /// @param _callback The function to call with the scene pointer.
+  void OnSceneAvailable(QObject* _receiver, const std::string& _engineName, const std::string& _sceneName,
+                        std::function<void(ignition::rendering::ScenePtr)> _callback);
+
+  /// @param _sceneName The scene name.
+  /// @return The scene called @p _sceneName or nullptr when it has not been
+  ///         resolved yet.
+  ignition::rendering::ScenePtr Scene(const std::string& _sceneName) const;
+
+ signals:
+  /// @brief Emitted once per scene, when @p _sceneName gets resolved.
+  void SceneAvailable(const QString& _sceneName);
+
+ protected:
+  /// @brief Filters ignition::gui::events::Render events to resolve the
+  ///        pending scenes.
+  bool eventFilter(QObject* _obj, QEvent* _event) override;
+
+ private:
+  SceneNotifier() = default;
+
+  /// @brief Tries to get every pending scene from its render engine.
+  void ResolvePendingScenes();
+
+  /// @brief Scenes waiting to be resolved, indexed by scene name. The value is
+  ///        the rendering engine name.
+  std::map<std::string, std::string> pendingScenes;
+
+  /// @brief Resolved scenes, indexed by scene name.
+  std::map<std::string, ignition::rendering::ScenePtr> scenes;
+
+  /// @brief Whether the event filter is installed in the MainWindow.
+  bool isFilterInstalled{false};
+};
+
+}  // namespace gui
+}  // namespace delphyne
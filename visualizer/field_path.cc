@@ -0,0 +1,255 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "visualizer/field_path.hh"
+
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace delphyne {
+namespace gui {
+
+namespace {
+
+// Separator between path elements.
+constexpr char kSeparator[]{"::"};
+
+// Splits @p _path by kSeparator.
+std::vector<std::string> SplitPath(const std::string& _path) {
+  std::vector<std::string> elements;
+  std::string::size_type begin{0};
+  while (true) {
+    const std::string::size_type end = _path.find(kSeparator, begin);
+    elements.push_back(_path.substr(begin, end - begin));
+    if (end == std::string::npos) {
+      break;
+    }
+    begin = end + sizeof(kSeparator) - 1;
+  }
+  return elements;
+}
+
+// @returns True when @p _str is a non-empty sequence of decimal digits.
+bool IsIndex(const std::string& _str) {
+  if (_str.empty()) {
+    return false;
+  }
+  for (const char c : _str) {
+    if (!std::isdigit(static_cast<unsigned char>(c))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+FieldPath::FieldPath(const google::protobuf::Descriptor* _descriptor, const std::string& _path)
+    : path(_path), descriptor(_descriptor) {
+  if (!descriptor) {
+    throw std::runtime_error("Field path \"" + path + "\" needs a message type.");
+  }
+  const std::vector<std::string> elements = SplitPath(path);
+  const google::protobuf::Descriptor* messageType = descriptor;
+  for (std::size_t i = 0; i < elements.size(); ++i) {
+    if (!messageType) {
+      throw std::runtime_error("Field path \"" + path + "\" goes through scalar field \"" + steps.back().field->name() +
+                               "\".");
+    }
+    Step step;
+    step.field = messageType->FindFieldByName(elements[i]);
+    if (!step.field) {
+      throw std::runtime_error("Field path \"" + path + "\": " + messageType->full_name() + " has no field \"" +
+                               elements[i] + "\".");
+    }
+    if (step.field->is_repeated()) {
+      if (i + 1 == elements.size() || !IsIndex(elements[i + 1])) {
+        throw std::runtime_error("Field path \"" + path + "\": repeated field \"" + elements[i] +
+                                 "\" must be followed by an index.");
+      }
+      try {
+        step.index = std::stoi(elements[++i]);
+      } catch (const std::out_of_range&) {
+        throw std::runtime_error("Field path \"" + path + "\": index " + elements[i] + " is out of range.");
+      }
+    }
+    messageType = step.field->message_type();
+    steps.push_back(step);
+  }
+  if (messageType) {
+    throw std::runtime_error("Field path \"" + path + "\" ends at message field \"" + steps.back().field->name() +
+                             "\".");
+  }
+}
+
+std::shared_ptr<const FieldPath> FieldPath::Compiled(const google::protobuf::Descriptor* _descriptor,
+                                                     const std::string& _path) {
+  static std::mutex mutex;
+  static std::map<std::pair<const google::protobuf::Descriptor*, std::string>, std::shared_ptr<const FieldPath>>
+      cache;
+
+  const std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find({_descriptor, _path});
+  if (it == cache.end()) {
+    it = cache.emplace(std::make_pair(_descriptor, _path), std::make_shared<const FieldPath>(_descriptor, _path))
+             .first;
+  }
+  return it->second;
+}
+
+const google::protobuf::Message* FieldPath::Parent(const google::protobuf::Message& _msg) const {
+  if (_msg.GetDescriptor() != descriptor) {
+    throw std::runtime_error("Field path \"" + path + "\" was compiled for " + descriptor->full_name() + ", not for " +
+                             _msg.GetDescriptor()->full_name() + ".");
+  }
+  const google::protobuf::Message* msg = &_msg;
+  for (std::size_t i = 0; i + 1 < steps.size(); ++i) {
+    const Step& step = steps[i];
+    const google::protobuf::Reflection* reflection = msg->GetReflection();
+    if (step.index < 0) {
+      msg = &reflection->GetMessage(*msg, step.field);
+    } else if (step.index < reflection->FieldSize(*msg, step.field)) {
+      msg = &reflection->GetRepeatedMessage(*msg, step.field, step.index);
+    } else {
+      return nullptr;
+    }
+  }
+  return msg;
+}
+
+std::optional<FieldPath::Value> FieldPath::Read(const google::protobuf::Message& _msg) const {
+  using google::protobuf::FieldDescriptor;
+
+  const google::protobuf::Message* msg = Parent(_msg);
+  if (!msg) {
+    return std::nullopt;
+  }
+  const google::protobuf::Reflection* reflection = msg->GetReflection();
+  const Step& step = steps.back();
+  if (step.index < 0) {
+    switch (step.field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        return Value{reflection->GetDouble(*msg, step.field)};
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        return Value{static_cast<double>(reflection->GetFloat(*msg, step.field))};
+      case FieldDescriptor::CPPTYPE_INT64:
+        return Value{static_cast<int64_t>(reflection->GetInt64(*msg, step.field))};
+      case FieldDescriptor::CPPTYPE_INT32:
+        return Value{static_cast<int64_t>(reflection->GetInt32(*msg, step.field))};
+      case FieldDescriptor::CPPTYPE_UINT64:
+        return Value{static_cast<uint64_t>(reflection->GetUInt64(*msg, step.field))};
+      case FieldDescriptor::CPPTYPE_UINT32:
+        return Value{static_cast<uint64_t>(reflection->GetUInt32(*msg, step.field))};
+      case FieldDescriptor::CPPTYPE_BOOL:
+        return Value{reflection->GetBool(*msg, step.field)};
+      case FieldDescriptor::CPPTYPE_STRING:
+        return Value{reflection->GetString(*msg, step.field)};
+      case FieldDescriptor::CPPTYPE_ENUM:
+        return Value{reflection->GetEnum(*msg, step.field)->name()};
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        break;
+    }
+    return std::nullopt;
+  }
+  if (step.index >= reflection->FieldSize(*msg, step.field)) {
+    return std::nullopt;
+  }
+  switch (step.field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return Value{reflection->GetRepeatedDouble(*msg, step.field, step.index)};
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return Value{static_cast<double>(reflection->GetRepeatedFloat(*msg, step.field, step.index))};
+    case FieldDescriptor::CPPTYPE_INT64:
+      return Value{static_cast<int64_t>(reflection->GetRepeatedInt64(*msg, step.field, step.index))};
+    case FieldDescriptor::CPPTYPE_INT32:
+      return Value{static_cast<int64_t>(reflection->GetRepeatedInt32(*msg, step.field, step.index))};
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return Value{static_cast<uint64_t>(reflection->GetRepeatedUInt64(*msg, step.field, step.index))};
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return Value{static_cast<uint64_t>(reflection->GetRepeatedUInt32(*msg, step.field, step.index))};
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return Value{reflection->GetRepeatedBool(*msg, step.field, step.index)};
+    case FieldDescriptor::CPPTYPE_STRING:
+      return Value{reflection->GetRepeatedString(*msg, step.field, step.index)};
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return Value{reflection->GetRepeatedEnum(*msg, step.field, step.index)->name()};
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      break;
+  }
+  return std::nullopt;
+}
+
+std::optional<double> FieldPath::ReadDouble(const google::protobuf::Message& _msg) const {
+  using google::protobuf::FieldDescriptor;
+
+  if (Field()->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    const google::protobuf::Message* msg = Parent(_msg);
+    if (!msg) {
+      return std::nullopt;
+    }
+    const google::protobuf::Reflection* reflection = msg->GetReflection();
+    const Step& step = steps.back();
+    if (step.index < 0) {
+      return static_cast<double>(reflection->GetEnumValue(*msg, step.field));
+    }
+    if (step.index >= reflection->FieldSize(*msg, step.field)) {
+      return std::nullopt;
+    }
+    return static_cast<double>(reflection->GetRepeatedEnumValue(*msg, step.field, step.index));
+  }
+
+  const std::optional<Value> value = Read(_msg);
+  if (!value || std::holds_alternative<std::string>(*value)) {
+    return std::nullopt;
+  }
+  return std::visit(
+      [](auto&& arg) -> double {
+        if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::string>) {
+          return 0.;
+        } else {
+          return static_cast<double>(arg);
+        }
+      },
+      *value);
+}
+
+std::string FieldPath::ToString(const Value& _value) {
+  std::ostringstream os;
+  std::visit([&os](auto&& arg) { os << arg; }, _value);
+  return os.str();
+}
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,124 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+
+namespace delphyne {
+namespace gui {
+
+/// \brief A field path compiled against a protobuf message type.
+///
+/// \details Paths use the same syntax the topic interface shows, field names
+///          and repeated field indices separated by "::", e.g.
+///          `state::3::position::x`. Compiling resolves every name to its
+///          field descriptor once, so reading a value from a message only
+///          walks the path, without building any intermediate tree.
+///
+///          Repeated fields must be followed by an index, and the path must
+///          end at a scalar (numeric, boolean, string or enum) field.
+class FieldPath {
+ public:
+  /// \brief A field value. Enums are read as their value name and all integers
+  ///        are widened to 64 bits.
+  using Value = std::variant<bool, int64_t, uint64_t, double, std::string>;
+
+  /// \brief Compiles @p _path for messages described by @p _descriptor.
+  /// \throws std::runtime_error When @p _descriptor is null or @p _path does
+  ///         not name a scalar field of it.
+  FieldPath(const google::protobuf::Descriptor* _descriptor, const std::string& _path);
+
+  /// \brief Returns the compiled @p _path for @p _descriptor, compiling it
+  ///        only the first time it is asked for. It is thread safe.
+  /// \throws std::runtime_error Under the same conditions the constructor
+  ///         does.
+  static std::shared_ptr<const FieldPath> Compiled(const google::protobuf::Descriptor* _descriptor,
+                                                   const std::string& _path);
+
+  /// \return The compiled path.
+  const std::string& Path() const { return path; }
+
+  /// \return The message type the path was compiled for.
+  const google::protobuf::Descriptor* MessageType() const { return descriptor; }
+
+  /// \return The descriptor of the field the path ends at.
+  const google::protobuf::FieldDescriptor* Field() const { return steps.back().field; }
+
+  /// \brief Reads the field from @p _msg.
+  /// \return The value, or std::nullopt when a repeated field index is out of
+  ///         range in @p _msg.
+  /// \throws std::runtime_error When @p _msg is not of the compiled type.
+  std::optional<Value> Read(const google::protobuf::Message& _msg) const;
+
+  /// \brief Reads a numeric or boolean field from @p _msg as a double, enums
+  ///        are read as their value number.
+  /// \return The value, or std::nullopt when a repeated field index is out of
+  ///         range in @p _msg or the field is a string.
+  /// \throws std::runtime_error When @p _msg is not of the compiled type.
+  std::optional<double> ReadDouble(const google::protobuf::Message& _msg) const;
+
+  /// \brief Formats @p _value the way the topic interface shows it.
+  static std::string ToString(const Value& _value);
+
+ private:
+  /// \brief One path step.
+  struct Step {
+    /// Field to read.
+    const google::protobuf::FieldDescriptor* field{nullptr};
+    /// Index within the repeated field, -1 if it is not repeated.
+    int index{-1};
+  };
+
+  /// \brief Walks all steps but the last one from @p _msg.
+  /// \return The message holding the last field, or nullptr when a repeated
+  ///         field index is out of range.
+  const google::protobuf::Message* Parent(const google::protobuf::Message& _msg) const;
+
+  /// \brief The compiled path.
+  std::string path;
+
+  /// \brief The message type the path was compiled for.
+  const google::protobuf::Descriptor* descriptor{nullptr};
+
+  /// \brief Steps from the root message down to the field.
+  std::vector<Step> steps;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,416 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "lane_index.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include <maliput/api/junction.h>
+#include <maliput/api/segment.h>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Margin added around the lane pieces boxes, in meters. It covers the lane
+// curvature between the samples of a piece and points slightly below the
+// road surface.
+constexpr double kBoxPadding{0.5};
+
+// Cells are at least this large, in meters.
+constexpr double kMinCellSize{1.};
+
+// The grid has at most this many cells per lane piece, on top of
+// kExtraCells. Sparse maps get larger cells instead of many empty ones.
+constexpr size_t kCellsPerEntry{4};
+constexpr size_t kExtraCells{64};
+
+// Ray queries stop refining a surface crossing once it is known within this
+// distance along the ray, in meters.
+constexpr double kRayResolution{1e-4};
+constexpr int kMaxBisections{64};
+
+// Ray crossings further than this from the lane bounds, in meters, belong
+// to another lane.
+constexpr double kRayTolerance{1e-2};
+
+maliput::api::InertialPosition ToInertial(const ignition::math::Vector3d& _point) {
+  return maliput::api::InertialPosition(_point.X(), _point.Y(), _point.Z());
+}
+
+ignition::math::Vector3d FromInertial(const maliput::api::InertialPosition& _position) {
+  return ignition::math::Vector3d(_position.x(), _position.y(), _position.z());
+}
+
+// Grows @p _box to contain @p _point.
+void Expand(const ignition::math::Vector3d& _point, LaneIndex::Box* _box) {
+  _box->min.Set(std::min(_box->min.X(), _point.X()), std::min(_box->min.Y(), _point.Y()),
+                std::min(_box->min.Z(), _point.Z()));
+  _box->max.Set(std::max(_box->max.X(), _point.X()), std::max(_box->max.Y(), _point.Y()),
+                std::max(_box->max.Z(), _point.Z()));
+}
+
+// Bounds the part of @p _lane between @p _s0 and @p _s1, its lane bounds and
+// its elevation bounds.
+LaneIndex::Box BoxOf(const maliput::api::Lane& _lane, double _s0, double _s1) {
+  constexpr double kInf{std::numeric_limits<double>::infinity()};
+  LaneIndex::Box box{{kInf, kInf, kInf}, {-kInf, -kInf, -kInf}};
+  for (const double s : {_s0, (_s0 + _s1) / 2., _s1}) {
+    const maliput::api::RBounds laneBounds = _lane.lane_bounds(s);
+    for (const double r : {laneBounds.min(), 0., laneBounds.max()}) {
+      const maliput::api::HBounds elevationBounds = _lane.elevation_bounds(s, r);
+      for (const double h : {0., elevationBounds.max()}) {
+        Expand(FromInertial(_lane.ToInertialPosition(maliput::api::LanePosition(s, r, h))), &box);
+      }
+    }
+  }
+  const ignition::math::Vector3d padding(kBoxPadding, kBoxPadding, kBoxPadding);
+  box.min -= padding;
+  box.max += padding;
+  return box;
+}
+
+bool Contains(const LaneIndex::Box& _box, const ignition::math::Vector3d& _point) {
+  return _point.X() >= _box.min.X() && _point.X() <= _box.max.X() && _point.Y() >= _box.min.Y() &&
+         _point.Y() <= _box.max.Y() && _point.Z() >= _box.min.Z() && _point.Z() <= _box.max.Z();
+}
+
+// Narrows [@p _t0, @p _t1] down to the part of the ray, along one axis from
+// @p _origin in @p _direction, between @p _min and @p _max.
+// @return False when nothing is left.
+bool ClipToSlab(double _origin, double _direction, double _min, double _max, double* _t0, double* _t1) {
+  if (_direction == 0.) {
+    return _origin >= _min && _origin <= _max;
+  }
+  double tMin = (_min - _origin) / _direction;
+  double tMax = (_max - _origin) / _direction;
+  if (tMin > tMax) {
+    std::swap(tMin, tMax);
+  }
+  *_t0 = std::max(*_t0, tMin);
+  *_t1 = std::min(*_t1, tMax);
+  return *_t0 <= *_t1;
+}
+
+// Narrows [@p _t0, @p _t1] down to the part of the ray inside @p _box.
+// @return False when the ray misses @p _box.
+bool ClipToBox(const LaneIndex::Box& _box, const ignition::math::Vector3d& _origin,
+               const ignition::math::Vector3d& _direction, double* _t0, double* _t1) {
+  return ClipToSlab(_origin.X(), _direction.X(), _box.min.X(), _box.max.X(), _t0, _t1) &&
+         ClipToSlab(_origin.Y(), _direction.Y(), _box.min.Y(), _box.max.Y(), _t0, _t1) &&
+         ClipToSlab(_origin.Z(), _direction.Z(), _box.min.Z(), _box.max.Z(), _t0, _t1);
+}
+
+// @return How far outside of @p _lane bounds @p _position is, along r.
+double DistanceToLaneBounds(const maliput::api::Lane& _lane, const maliput::api::LanePosition& _position) {
+  const maliput::api::RBounds laneBounds = _lane.lane_bounds(_position.s());
+  return std::max({0., _position.r() - laneBounds.max(), laneBounds.min() - _position.r()});
+}
+
+// @return The height of @p _point above the surface of @p _lane, negative
+//         below it. It is measured along z, as lane positions below the
+//         surface get their h clamped to the elevation bounds.
+double HeightAboveSurface(const maliput::api::Lane& _lane, const ignition::math::Vector3d& _point) {
+  const maliput::api::LanePosition position = _lane.ToLanePosition(ToInertial(_point)).lane_position;
+  const maliput::api::InertialPosition surface =
+      _lane.ToInertialPosition(maliput::api::LanePosition(position.s(), position.r(), 0.));
+  return _point.Z() - surface.z();
+}
+
+// Cell coordinate of @p _value along an axis, clamped to the grid.
+size_t CellCoordinate(double _value, double _origin, double _cellSize, size_t _cells) {
+  const double coordinate = std::floor((_value - _origin) / _cellSize);
+  return static_cast<size_t>(std::clamp(coordinate, 0., static_cast<double>(_cells - 1)));
+}
+
+}  // namespace
+
+std::unique_ptr<LaneIndex> LaneIndex::Build(const maliput::api::RoadGeometry& _roadGeometry, double _step) {
+  std::vector<Entry> entries;
+  for (int i = 0; i < _roadGeometry.num_junctions(); ++i) {
+    const maliput::api::Junction* junction = _roadGeometry.junction(i);
+    for (int j = 0; j < junction->num_segments(); ++j) {
+      const maliput::api::Segment* segment = junction->segment(j);
+      for (int k = 0; k < segment->num_lanes(); ++k) {
+        const maliput::api::Lane* lane = segment->lane(k);
+        const double length = lane->length();
+        const int pieces = std::max(1, static_cast<int>(std::ceil(length / _step)));
+        for (int piece = 0; piece < pieces; ++piece) {
+          const double s0 = length * piece / pieces;
+          const double s1 = length * (piece + 1) / pieces;
+          entries.push_back(Entry{lane, s0, s1, BoxOf(*lane, s0, s1)});
+        }
+      }
+    }
+  }
+  return std::make_unique<LaneIndex>(std::move(entries));
+}
+
+LaneIndex::LaneIndex(std::vector<Entry> _entries) : entries(std::move(_entries)) {
+  if (entries.empty()) {
+    cellStarts.assign(1, 0);
+    return;
+  }
+
+  // Cells are about as large as the average box, so that a box is found in
+  // a few cells and a cell holds a few boxes.
+  double maxX = entries.front().box.max.X();
+  double maxY = entries.front().box.max.Y();
+  originX = entries.front().box.min.X();
+  originY = entries.front().box.min.Y();
+  double extents{0.};
+  for (const Entry& entry : entries) {
+    originX = std::min(originX, entry.box.min.X());
+    originY = std::min(originY, entry.box.min.Y());
+    maxX = std::max(maxX, entry.box.max.X());
+    maxY = std::max(maxY, entry.box.max.Y());
+    extents += std::max(entry.box.max.X() - entry.box.min.X(), entry.box.max.Y() - entry.box.min.Y());
+  }
+  cellSize = std::max(extents / entries.size(), kMinCellSize);
+  const size_t maxCells = kCellsPerEntry * entries.size() + kExtraCells;
+  while (true) {
+    cellsX = static_cast<size_t>((maxX - originX) / cellSize) + 1;
+    cellsY = static_cast<size_t>((maxY - originY) / cellSize) + 1;
+    if (cellsX * cellsY <= maxCells) {
+      break;
+    }
+    cellSize *= 2.;
+  }
+
+  // Two passes: count the entries of each cell, then fill them in.
+  cellStarts.assign(cellsX * cellsY + 1, 0);
+  const auto forEachCell = [this](const Box& _box, auto _callback) {
+    const size_t x0 = CellCoordinate(_box.min.X(), originX, cellSize, cellsX);
+    const size_t x1 = CellCoordinate(_box.max.X(), originX, cellSize, cellsX);
+    const size_t y0 = CellCoordinate(_box.min.Y(), originY, cellSize, cellsY);
+    const size_t y1 = CellCoordinate(_box.max.Y(), originY, cellSize, cellsY);
+    for (size_t y = y0; y <= y1; ++y) {
+      for (size_t x = x0; x <= x1; ++x) {
+        _callback(y * cellsX + x);
+      }
+    }
+  };
+  for (const Entry& entry : entries) {
+    forEachCell(entry.box, [this](size_t _cell) { ++cellStarts[_cell + 1]; });
+  }
+  for (size_t i = 1; i < cellStarts.size(); ++i) {
+    cellStarts[i] += cellStarts[i - 1];
+  }
+  cellEntries.resize(cellStarts.back());
+  std::vector<uint32_t> cursors(cellStarts.begin(), cellStarts.end() - 1);
+  for (uint32_t i = 0; i < entries.size(); ++i) {
+    forEachCell(entries[i].box, [this, &cursors, i](size_t _cell) { cellEntries[cursors[_cell]++] = i; });
+  }
+}
+
+std::optional<size_t> LaneIndex::CellAt(double _x, double _y) const {
+  if (entries.empty() || _x < originX || _y < originY) {
+    return std::nullopt;
+  }
+  const size_t x = static_cast<size_t>((_x - originX) / cellSize);
+  const size_t y = static_cast<size_t>((_y - originY) / cellSize);
+  if (x >= cellsX || y >= cellsY) {
+    return std::nullopt;
+  }
+  return y * cellsX + x;
+}
+
+std::vector<const LaneIndex::Entry*> LaneIndex::EntriesAt(const ignition::math::Vector3d& _point) const {
+  std::vector<const Entry*> result;
+  const std::optional<size_t> cell = CellAt(_point.X(), _point.Y());
+  if (!cell.has_value()) {
+    return result;
+  }
+  for (uint32_t i = cellStarts[cell.value()]; i < cellStarts[cell.value() + 1]; ++i) {
+    const Entry& entry = entries[cellEntries[i]];
+    if (Contains(entry.box, _point)) {
+      result.push_back(&entry);
+    }
+  }
+  return result;
+}
+
+std::vector<std::pair<double, const LaneIndex::Entry*>> LaneIndex::EntriesAlong(
+    const ignition::math::Vector3d& _origin, const ignition::math::Vector3d& _direction, double _maxDistance) const {
+  std::vector<std::pair<double, const Entry*>> result;
+  if (entries.empty()) {
+    return result;
+  }
+  // Clips the ray to the grid, then walks the cells it crosses in order.
+  double t0{0.};
+  double t1{_maxDistance};
+  if (!ClipToSlab(_origin.X(), _direction.X(), originX, originX + cellsX * cellSize, &t0, &t1) ||
+      !ClipToSlab(_origin.Y(), _direction.Y(), originY, originY + cellsY * cellSize, &t0, &t1)) {
+    return result;
+  }
+  const ignition::math::Vector3d start = _origin + _direction * t0;
+  size_t x = CellCoordinate(start.X(), originX, cellSize, cellsX);
+  size_t y = CellCoordinate(start.Y(), originY, cellSize, cellsY);
+
+  constexpr double kInf{std::numeric_limits<double>::infinity()};
+  const auto nextBoundary = [this](double _origin, double _direction, double _gridOrigin, size_t _cell) {
+    if (_direction == 0.) {
+      return kInf;
+    }
+    const double boundary = _gridOrigin + (_cell + (_direction > 0. ? 1 : 0)) * cellSize;
+    return (boundary - _origin) / _direction;
+  };
+  double tNextX = nextBoundary(_origin.X(), _direction.X(), originX, x);
+  double tNextY = nextBoundary(_origin.Y(), _direction.Y(), originY, y);
+  const double tDeltaX = _direction.X() == 0. ? kInf : cellSize / std::abs(_direction.X());
+  const double tDeltaY = _direction.Y() == 0. ? kInf : cellSize / std::abs(_direction.Y());
+
+  std::vector<uint32_t> candidates;
+  while (true) {
+    const size_t cell = y * cellsX + x;
+    candidates.insert(candidates.end(), cellEntries.begin() + cellStarts[cell],
+                      cellEntries.begin() + cellStarts[cell + 1]);
+    if (tNextX < tNextY) {
+      if (tNextX > t1 || (_direction.X() > 0. ? x + 1 >= cellsX : x == 0)) {
+        break;
+      }
+      x = _direction.X() > 0. ? x + 1 : x - 1;
+      tNextX += tDeltaX;
+    } else {
+      if (tNextY > t1 || (_direction.Y() > 0. ? y + 1 >= cellsY : y == 0)) {
+        break;
+      }
+      y = _direction.Y() > 0. ? y + 1 : y - 1;
+      tNextY += tDeltaY;
+    }
+  }
+
+  // Boxes span several cells.
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  for (const uint32_t i : candidates) {
+    double tEnter{0.};
+    double tExit{_maxDistance};
+    if (ClipToBox(entries[i].box, _origin, _direction, &tEnter, &tExit)) {
+      result.emplace_back(tEnter, &entries[i]);
+    }
+  }
+  std::sort(result.begin(), result.end(),
+            [](const auto& _lhs, const auto& _rhs) { return _lhs.first < _rhs.first; });
+  return result;
+}
+
+std::optional<LaneIndex::Hit> LaneIndex::FindLane(const ignition::math::Vector3d& _point, double _maxDistance) const {
+  std::optional<Hit> best;
+  std::vector<const maliput::api::Lane*> visited;
+  for (const Entry* entry : EntriesAt(_point)) {
+    // Several pieces of a lane may contain the point.
+    if (std::find(visited.begin(), visited.end(), entry->lane) != visited.end()) {
+      continue;
+    }
+    visited.push_back(entry->lane);
+    const maliput::api::LanePositionResult result = entry->lane->ToLanePosition(ToInertial(_point));
+    const double distance = result.distance + DistanceToLaneBounds(*entry->lane, result.lane_position);
+    if (distance <= _maxDistance && (!best.has_value() || distance < best->distance)) {
+      best = Hit{entry->lane, result.lane_position, FromInertial(result.nearest_position), distance};
+    }
+  }
+  return best;
+}
+
+std::optional<LaneIndex::Hit> LaneIndex::CastRay(const ignition::math::Vector3d& _origin,
+                                                 const ignition::math::Vector3d& _direction,
+                                                 double _maxDistance) const {
+  std::optional<Hit> best;
+  for (const auto& [tEnter, entry] : EntriesAlong(_origin, _direction, _maxDistance)) {
+    if (best.has_value() && best->distance < tEnter) {
+      break;
+    }
+    double tNear{0.};
+    double tFar{_maxDistance};
+    ClipToBox(entry->box, _origin, _direction, &tNear, &tFar);
+
+    // Bisects the stretch of ray inside the box down to the surface crossing.
+    const maliput::api::Lane& lane = *entry->lane;
+    const bool nearAbove = HeightAboveSurface(lane, _origin + _direction * tNear) > 0.;
+    if (nearAbove == (HeightAboveSurface(lane, _origin + _direction * tFar) > 0.)) {
+      continue;
+    }
+    for (int i = 0; i < kMaxBisections && tFar - tNear > kRayResolution; ++i) {
+      const double t = (tNear + tFar) / 2.;
+      if ((HeightAboveSurface(lane, _origin + _direction * t) > 0.) == nearAbove) {
+        tNear = t;
+      } else {
+        tFar = t;
+      }
+    }
+
+    const double t = (tNear + tFar) / 2.;
+    const ignition::math::Vector3d point = _origin + _direction * t;
+    const maliput::api::LanePositionResult result = lane.ToLanePosition(ToInertial(point));
+    if (result.distance + DistanceToLaneBounds(lane, result.lane_position) > kRayTolerance) {
+      continue;
+    }
+    if (!best.has_value() || t < best->distance) {
+      best = Hit{&lane, result.lane_position, point, t};
+    }
+  }
+  return best;
+}
+
+namespace {
+
+std::mutex& SharedLaneIndexMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::shared_ptr<const LaneIndex>& SharedLaneIndexInstance() {
+  static std::shared_ptr<const LaneIndex> laneIndex;
+  return laneIndex;
+}
+
+}  // namespace
+
+std::shared_ptr<const LaneIndex> SharedLaneIndex::Get() {
+  std::lock_guard<std::mutex> lock(SharedLaneIndexMutex());
+  return SharedLaneIndexInstance();
+}
+
+void SharedLaneIndex::Set(std::shared_ptr<const LaneIndex> _laneIndex) {
+  std::shared_ptr<const LaneIndex> previous;
+  {
+    std::lock_guard<std::mutex> lock(SharedLaneIndexMutex());
+    previous = std::exchange(SharedLaneIndexInstance(), std::move(_laneIndex));
+  }
+  // The previous index may hold the last reference to its road, released
+  // outside the lock.
+}
+
+}  // namespace gui
+}  // namespace delphyne
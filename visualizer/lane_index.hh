@@ -0,0 +1,166 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+#include <maliput/api/lane.h>
+#include <maliput/api/lane_data.h>
+#include <maliput/api/road_geometry.h>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Spatial index of the lanes of a road geometry, to find the lane at a
+///        point or along a ray without querying every lane.
+/// @details Each lane is split into pieces no longer than a few meters and
+///          each piece gets an inertial frame axis aligned box around its
+///          lane bounds and elevation. The boxes are bulk loaded into a
+///          uniform grid over the xy plane, sized so that a box spans a few
+///          cells. Queries visit the cells under the point, or along the ray,
+///          and only resolve (s, r, h) coordinates with maliput for the lanes
+///          whose boxes are hit, a handful even on large maps.
+///
+///          The index holds raw lane pointers: the road geometry must outlive
+///          it. Queries are const and may run on any thread.
+class LaneIndex {
+ public:
+  /// @brief Axis aligned box in the inertial frame.
+  struct Box {
+    ignition::math::Vector3d min;
+    ignition::math::Vector3d max;
+  };
+
+  /// @brief Piece of a lane and its bounding box.
+  struct Entry {
+    const maliput::api::Lane* lane{nullptr};
+    double s0{0.};
+    double s1{0.};
+    Box box;
+  };
+
+  /// @brief Lane found by a query.
+  struct Hit {
+    const maliput::api::Lane* lane{nullptr};
+    /// @brief (s, r, h) coordinates of the hit in `lane`.
+    maliput::api::LanePosition position;
+    /// @brief Hit point in the inertial frame.
+    ignition::math::Vector3d point;
+    /// @brief Distance from the query point to the lane, or along the ray
+    ///        to the hit.
+    double distance{0.};
+  };
+
+  /// @brief Length of the lane pieces, in meters.
+  static constexpr double kDefaultStep{5.};
+
+  /// @brief Indexes every lane of @p _roadGeometry.
+  /// @param _roadGeometry Road geometry to index. It must outlive the index.
+  /// @param _step Maximum length of the lane pieces, in meters. It must be
+  ///        positive.
+  static std::unique_ptr<LaneIndex> Build(const maliput::api::RoadGeometry& _roadGeometry,
+                                          double _step = kDefaultStep);
+
+  /// @brief Bulk loads @p _entries.
+  explicit LaneIndex(std::vector<Entry> _entries);
+
+  /// @return The number of indexed lane pieces.
+  size_t Size() const { return entries.size(); }
+
+  /// @return The lane pieces whose box contains @p _point.
+  std::vector<const Entry*> EntriesAt(const ignition::math::Vector3d& _point) const;
+
+  /// @return The lane pieces whose box is hit by the ray from @p _origin
+  ///         along @p _direction within @p _maxDistance, with the distance
+  ///         along the ray at which the box is entered, nearest first.
+  ///         @p _direction must be a unit vector.
+  std::vector<std::pair<double, const Entry*>> EntriesAlong(const ignition::math::Vector3d& _origin,
+                                                            const ignition::math::Vector3d& _direction,
+                                                            double _maxDistance) const;
+
+  /// @brief Finds the lane at @p _point.
+  /// @details When lanes overlap, e.g. within a segment or a junction, the
+  ///          one whose lane bounds contain the point is preferred, then the
+  ///          nearest one.
+  /// @param _point Point in the inertial frame.
+  /// @param _maxDistance Maximum distance from @p _point to the lane.
+  /// @return The lane at @p _point, or std::nullopt when there is none.
+  std::optional<Hit> FindLane(const ignition::math::Vector3d& _point, double _maxDistance = 0.1) const;
+
+  /// @brief Finds the first lane surface crossed by a ray.
+  /// @param _origin Ray origin in the inertial frame.
+  /// @param _direction Ray unit direction.
+  /// @param _maxDistance Ray length.
+  /// @return The nearest crossing of a lane surface, h = 0, within the lane
+  ///         bounds, or std::nullopt when there is none.
+  std::optional<Hit> CastRay(const ignition::math::Vector3d& _origin, const ignition::math::Vector3d& _direction,
+                             double _maxDistance) const;
+
+ private:
+  /// @return The cell index of @p _x, @p _y, or std::nullopt when it is off
+  ///         the grid.
+  std::optional<size_t> CellAt(double _x, double _y) const;
+
+  /// @brief Lane pieces.
+  std::vector<Entry> entries;
+
+  /// @brief Grid origin, the lowest x and y of all boxes.
+  double originX{0.};
+  double originY{0.};
+  /// @brief Side of the square grid cells.
+  double cellSize{1.};
+  /// @brief Number of cells along x and y.
+  size_t cellsX{0};
+  size_t cellsY{0};
+  /// @brief Entries of cell i are cellEntries[cellStarts[i]:cellStarts[i + 1]].
+  std::vector<uint32_t> cellStarts;
+  std::vector<uint32_t> cellEntries;
+};
+
+/// @brief Lane index of the road shown by the RoadNetworkViewer, shared with
+///        the plugins that annotate the scene with lanes.
+class SharedLaneIndex {
+ public:
+  /// @return The shown road lane index, or nullptr when no road is shown.
+  static std::shared_ptr<const LaneIndex> Get();
+
+  /// @brief Replaces the shown road lane index with @p _laneIndex.
+  static void Set(std::shared_ptr<const LaneIndex> _laneIndex);
+};
+
+}  // namespace gui
+}  // namespace delphyne
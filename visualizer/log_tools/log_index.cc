@@ -0,0 +1,291 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "log_index.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+
+#include <ignition/common/Console.hh>
+#include <ignition/transport/log/Log.hh>
+#include <maliput/common/maliput_throw.h>
+
+namespace delphyne {
+namespace gui {
+
+struct LogIndex::Header {
+  char magic[4];
+  uint32_t version;
+  uint64_t logSize;
+  int64_t duration;
+  int64_t bucketDuration;
+  uint32_t bucketCount;
+  uint32_t topicCount;
+};
+
+struct LogIndex::TopicRecord {
+  uint32_t nameOffset;
+  uint32_t nameLength;
+};
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'L', 'I', 'X'};
+constexpr uint32_t kVersion{1};
+
+// @return The size of the file at @p _path, if it exists.
+std::optional<uint64_t> FileSize(const std::string& _path) {
+  struct stat st;
+  if (stat(_path.c_str(), &st) != 0) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(st.st_size);
+}
+
+}  // namespace
+
+bool LogIndex::Build(const std::string& _logPath, const std::string& _indexPath, int _bucketCount,
+                     const std::atomic<bool>* _stopRequested) {
+  MALIPUT_THROW_UNLESS(_bucketCount > 0);
+  const std::optional<uint64_t> logSize = FileSize(_logPath);
+  ignition::transport::log::Log log;
+  if (!logSize.has_value() || !log.Open(_logPath)) {
+    ignerr << "Unable to open log [" << _logPath << "] to index it." << std::endl;
+    return false;
+  }
+
+  const std::chrono::nanoseconds start = log.StartTime();
+  const int64_t duration = std::max<int64_t>((log.EndTime() - start).count(), 1);
+  const int64_t bucketDuration = (duration + _bucketCount - 1) / _bucketCount;
+
+  // Topics are sorted by name so the index does not depend on the log order.
+  std::map<std::string, std::vector<Bucket>> topicBuckets;
+  for (const ignition::transport::log::Message& msg : log.QueryMessages()) {
+    if (_stopRequested != nullptr && _stopRequested->load()) {
+      return false;
+    }
+    auto it = topicBuckets.find(msg.Topic());
+    if (it == topicBuckets.end()) {
+      it = topicBuckets.emplace(msg.Topic(), std::vector<Bucket>(_bucketCount)).first;
+    }
+    const int64_t offset = std::max<int64_t>((msg.TimeReceived() - start).count(), 0);
+    const int bucket = std::min<int64_t>(offset / bucketDuration, _bucketCount - 1);
+    Bucket& dst = it->second[bucket];
+    ++dst.count;
+    const uint64_t bytes = static_cast<uint64_t>(dst.bytes) + msg.Data().size();
+    dst.bytes = static_cast<uint32_t>(std::min<uint64_t>(bytes, std::numeric_limits<uint32_t>::max()));
+  }
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.logSize = logSize.value();
+  header.duration = duration;
+  header.bucketDuration = bucketDuration;
+  header.bucketCount = static_cast<uint32_t>(_bucketCount);
+  header.topicCount = static_cast<uint32_t>(topicBuckets.size());
+
+  std::vector<TopicRecord> records;
+  std::string names;
+  for (const auto& topic : topicBuckets) {
+    records.push_back(TopicRecord{static_cast<uint32_t>(names.size()), static_cast<uint32_t>(topic.first.size())});
+    names += topic.first;
+  }
+
+  const std::string tmpPath = _indexPath + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TopicRecord));
+    for (const auto& topic : topicBuckets) {
+      file.write(reinterpret_cast<const char*>(topic.second.data()), topic.second.size() * sizeof(Bucket));
+    }
+    file.write(names.data(), names.size());
+    if (!file) {
+      ignerr << "Unable to write log index [" << tmpPath << "]." << std::endl;
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpPath.c_str(), _indexPath.c_str()) != 0) {
+    ignerr << "Unable to write log index [" << _indexPath << "]." << std::endl;
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<LogIndex> LogIndex::Open(const std::string& _indexPath, const std::string& _logPath) {
+  const int fd = open(_indexPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping outlives the descriptor.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  // LogIndex's constructor is private.
+  std::unique_ptr<LogIndex> index(new LogIndex(data, size));
+
+  const Header& header = *index->header;
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+      header.bucketCount == 0 || header.bucketDuration <= 0) {
+    return nullptr;
+  }
+  if (!_logPath.empty() && FileSize(_logPath) != std::optional<uint64_t>(header.logSize)) {
+    return nullptr;
+  }
+  const size_t bucketsOffset = sizeof(Header) + header.topicCount * sizeof(TopicRecord);
+  const size_t namesOffset =
+      bucketsOffset + static_cast<size_t>(header.topicCount) * header.bucketCount * sizeof(Bucket);
+  if (namesOffset > size) {
+    return nullptr;
+  }
+  const auto* records = reinterpret_cast<const TopicRecord*>(static_cast<const char*>(data) + sizeof(Header));
+  const char* names = static_cast<const char*>(data) + namesOffset;
+  for (uint32_t i = 0; i < header.topicCount; ++i) {
+    if (namesOffset + records[i].nameOffset + records[i].nameLength > size) {
+      return nullptr;
+    }
+    index->topics.emplace_back(names + records[i].nameOffset, records[i].nameLength);
+  }
+  index->buckets = reinterpret_cast<const Bucket*>(static_cast<const char*>(data) + bucketsOffset);
+  index->burstStarts = index->BurstStarts();
+  return index;
+}
+
+std::unique_ptr<LogIndex> LogIndex::OpenOrBuild(const std::string& _logPath, const std::string& _indexPath,
+                                                int _bucketCount, const std::atomic<bool>* _stopRequested) {
+  std::unique_ptr<LogIndex> index = Open(_indexPath, _logPath);
+  if (index != nullptr && index->BucketCount() == _bucketCount) {
+    return index;
+  }
+  if (!Build(_logPath, _indexPath, _bucketCount, _stopRequested)) {
+    return nullptr;
+  }
+  return Open(_indexPath, _logPath);
+}
+
+LogIndex::LogIndex(void* _data, size_t _size)
+    : data(_data), size(_size), header(reinterpret_cast<const Header*>(_data)) {}
+
+LogIndex::~LogIndex() { munmap(data, size); }
+
+std::chrono::nanoseconds LogIndex::Duration() const { return std::chrono::nanoseconds(header->duration); }
+
+std::chrono::nanoseconds LogIndex::BucketDuration() const {
+  return std::chrono::nanoseconds(header->bucketDuration);
+}
+
+int LogIndex::BucketCount() const { return static_cast<int>(header->bucketCount); }
+
+const std::vector<std::string>& LogIndex::Topics() const { return topics; }
+
+const LogIndex::Bucket& LogIndex::At(int _topic, int _bucket) const {
+  MALIPUT_THROW_UNLESS(_topic >= 0 && _topic < static_cast<int>(topics.size()));
+  MALIPUT_THROW_UNLESS(_bucket >= 0 && _bucket < BucketCount());
+  return buckets[_topic * BucketCount() + _bucket];
+}
+
+std::vector<uint32_t> LogIndex::TotalCounts() const {
+  std::vector<uint32_t> counts(BucketCount(), 0);
+  for (int topic = 0; topic < static_cast<int>(topics.size()); ++topic) {
+    for (int bucket = 0; bucket < BucketCount(); ++bucket) {
+      counts[bucket] += At(topic, bucket).count;
+    }
+  }
+  return counts;
+}
+
+std::vector<int> LogIndex::BurstStarts() const {
+  const std::vector<uint32_t> counts = TotalCounts();
+  uint64_t total{0};
+  int nonEmpty{0};
+  for (const uint32_t count : counts) {
+    total += count;
+    nonEmpty += count > 0 ? 1 : 0;
+  }
+  std::vector<int> starts;
+  if (nonEmpty == 0) {
+    return starts;
+  }
+  const double threshold = 2. * static_cast<double>(total) / nonEmpty;
+  bool inBurst{false};
+  for (int bucket = 0; bucket < static_cast<int>(counts.size()); ++bucket) {
+    const bool isBurst = counts[bucket] >= threshold;
+    if (isBurst && !inBurst) {
+      starts.push_back(bucket);
+    }
+    inBurst = isBurst;
+  }
+  return starts;
+}
+
+std::optional<std::chrono::nanoseconds> LogIndex::NextBurst(const std::chrono::nanoseconds& _time) const {
+  for (const int bucket : burstStarts) {
+    const std::chrono::nanoseconds start = bucket * BucketDuration();
+    if (start > _time) {
+      return start;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::chrono::nanoseconds> LogIndex::PreviousBurst(const std::chrono::nanoseconds& _time) const {
+  // Skips the burst being played, so repeated pushes keep going back.
+  for (auto it = burstStarts.rbegin(); it != burstStarts.rend(); ++it) {
+    const std::chrono::nanoseconds start = *it * BucketDuration();
+    if (start + BucketDuration() < _time) {
+      return start;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace gui
+}  // namespace delphyne
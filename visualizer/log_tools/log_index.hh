@@ -0,0 +1,155 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Per topic message density over time of an ignition transport log.
+/// @details The log span is split in equal time buckets, each one holding the
+///          number of messages and payload bytes received per topic. The index
+///          is built once out of the `topic.db` of a replay bundle, stored in a
+///          compact binary file and memory mapped afterwards, so reopening it
+///          costs no parsing. All times are offsets from the log start, as the
+///          replayer seek offsets are.
+class LogIndex {
+ public:
+  /// @brief Message count and payload bytes of a topic in a time bucket.
+  struct Bucket {
+    uint32_t count{0};
+    uint32_t bytes{0};
+  };
+
+  /// @brief Default number of time buckets of an index.
+  static constexpr int kDefaultBucketCount{1024};
+
+  /// @brief Builds the index of the log at @p _logPath and writes it to
+  ///        @p _indexPath.
+  /// @param _logPath Path to an ignition transport log, i.e. a `topic.db`.
+  /// @param _indexPath Path to the index file to write. It is replaced
+  ///        atomically, so concurrent readers never see a partial index.
+  /// @param _bucketCount Number of time buckets. It must be positive.
+  /// @param _stopRequested When not nullptr, the log scan stops as soon as it
+  ///        is set, leaving no index behind.
+  /// @return false when the log cannot be read, the index cannot be written
+  ///         or the build was stopped.
+  static bool Build(const std::string& _logPath, const std::string& _indexPath,
+                    int _bucketCount = kDefaultBucketCount, const std::atomic<bool>* _stopRequested = nullptr);
+
+  /// @brief Maps the index at @p _indexPath.
+  /// @param _indexPath Path to an index file written by Build().
+  /// @param _logPath Path to the indexed log. When not empty, an index built
+  ///        out of a log of a different size is considered stale.
+  /// @return The mapped index, or nullptr when the file is missing, invalid
+  ///         or stale.
+  static std::unique_ptr<LogIndex> Open(const std::string& _indexPath, const std::string& _logPath = "");
+
+  /// @brief Opens the index at @p _indexPath, building it first when it is
+  ///        missing or stale.
+  /// @see Build() and Open().
+  static std::unique_ptr<LogIndex> OpenOrBuild(const std::string& _logPath, const std::string& _indexPath,
+                                               int _bucketCount = kDefaultBucketCount,
+                                               const std::atomic<bool>* _stopRequested = nullptr);
+
+  ~LogIndex();
+
+  LogIndex(const LogIndex&) = delete;
+  LogIndex& operator=(const LogIndex&) = delete;
+
+  /// @return The span of the log.
+  std::chrono::nanoseconds Duration() const;
+
+  /// @return The span of each time bucket.
+  std::chrono::nanoseconds BucketDuration() const;
+
+  /// @return The number of time buckets.
+  int BucketCount() const;
+
+  /// @return The indexed topic names, in index order.
+  const std::vector<std::string>& Topics() const;
+
+  /// @return The bucket @p _bucket of the topic @p _topic.
+  /// @throws maliput::common::assertion_error When any index is out of range.
+  const Bucket& At(int _topic, int _bucket) const;
+
+  /// @return The number of messages of all topics in each bucket.
+  std::vector<uint32_t> TotalCounts() const;
+
+  /// @return The start of the first burst after @p _time, if any.
+  std::optional<std::chrono::nanoseconds> NextBurst(const std::chrono::nanoseconds& _time) const;
+
+  /// @return The start of the last burst before @p _time, if any.
+  std::optional<std::chrono::nanoseconds> PreviousBurst(const std::chrono::nanoseconds& _time) const;
+
+ private:
+  // Binary layout of the index file header. It is followed by a
+  // `TopicRecord` per topic, by the buckets of each topic and by the topic
+  // names.
+  struct Header;
+  struct TopicRecord;
+
+  // Takes ownership of the mapping at @p _data of @p _size bytes.
+  LogIndex(void* _data, size_t _size);
+
+  // @return The first bucket of each burst. A burst is a run of buckets with
+  //         at least twice the mean message count of the non empty buckets.
+  std::vector<int> BurstStarts() const;
+
+  // The mapped file.
+  void* data{nullptr};
+
+  // Size of the mapped file.
+  size_t size{0};
+
+  // Points into `data`.
+  const Header* header{nullptr};
+
+  // Points into `data`, `topics.size()` rows of `BucketCount()` buckets.
+  const Bucket* buckets{nullptr};
+
+  // Topic names, copied out of the mapping.
+  std::vector<std::string> topics;
+
+  // Cached result of BurstStarts().
+  std::vector<int> burstStarts;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,84 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "log_index.hh"
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+void PrintUsage(const char* _program) {
+  std::cerr << "Usage: " << _program << " <topic.db> <index file> [bucket count]" << std::endl
+            << "Builds, when missing or stale, the timeline index of an ignition transport log and prints a summary."
+            << std::endl;
+}
+
+int Main(int argc, char** argv) {
+  if (argc < 3 || argc > 4) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+  const int bucketCount = argc == 4 ? std::atoi(argv[3]) : LogIndex::kDefaultBucketCount;
+  if (bucketCount <= 0) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  const std::unique_ptr<LogIndex> index = LogIndex::OpenOrBuild(argv[1], argv[2], bucketCount);
+  if (index == nullptr) {
+    return 1;
+  }
+
+  std::cout << "Duration: " << index->Duration().count() / 1e9 << " s in " << index->BucketCount() << " buckets of "
+            << index->BucketDuration().count() / 1e6 << " ms" << std::endl;
+  for (int topic = 0; topic < static_cast<int>(index->Topics().size()); ++topic) {
+    uint64_t count{0};
+    uint64_t bytes{0};
+    for (int bucket = 0; bucket < index->BucketCount(); ++bucket) {
+      count += index->At(topic, bucket).count;
+      bytes += index->At(topic, bucket).bytes;
+    }
+    std::cout << "  " << index->Topics()[topic] << ": " << count << " messages, " << bytes << " bytes" << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace gui
+}  // namespace delphyne
+
+int main(int argc, char** argv) { return delphyne::gui::Main(argc, argv); }
@@ -0,0 +1,269 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "log_stats.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+#include <delphyne/protobuf/agent_state_v.pb.h>
+#include <ignition/common/Console.hh>
+#include <ignition/transport/log/Log.hh>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Accumulates the statistics of a topic in constant space, logs may hold
+// millions of messages per topic.
+struct TopicAccumulator {
+  uint64_t count{0};
+  uint64_t bytes{0};
+  std::chrono::nanoseconds first{0};
+  std::chrono::nanoseconds last{0};
+  std::chrono::nanoseconds maxInterval{0};
+  uint64_t gaps{0};
+
+  // Adds a message of @p _size bytes received at @p _time, after the
+  // previous ones.
+  void Add(const std::chrono::nanoseconds& _time, size_t _size) {
+    if (count == 0) {
+      first = _time;
+    } else {
+      const std::chrono::nanoseconds interval = _time - last;
+      // Messages are received in order, the mean interval so far is the
+      // span over the intervals count.
+      if (count > 1 && interval.count() > LogStats::kGapFactor * (last - first).count() / (count - 1)) {
+        ++gaps;
+      }
+      maxInterval = std::max(maxInterval, interval);
+    }
+    ++count;
+    bytes += _size;
+    last = _time;
+  }
+};
+
+// Accumulates the statistics of an agent.
+struct AgentAccumulator {
+  uint64_t samples{0};
+  double speedSum{0.};
+  double maxSpeed{0.};
+  uint64_t accelerations{0};
+  double accelerationSum{0.};
+  double minAcceleration{0.};
+  double maxAcceleration{0.};
+  double lastSpeed{0.};
+  std::chrono::nanoseconds last{0};
+};
+
+// @return True when @p _topic is LogStats::kAgentStateTopic, with or without
+//         a leading "/".
+bool IsAgentStateTopic(const std::string& _topic) {
+  const std::string topic = !_topic.empty() && _topic[0] == '/' ? _topic.substr(1) : _topic;
+  return topic == LogStats::kAgentStateTopic;
+}
+
+// Adds the states of @p _msg, received at @p _time, to @p _agents.
+void AccumulateAgents(const ignition::msgs::AgentState_V& _msg, const std::chrono::nanoseconds& _time,
+                      std::map<std::string, AgentAccumulator>* _agents) {
+  for (const ignition::msgs::AgentState& state : _msg.states()) {
+    if (!state.has_linear_velocity()) {
+      continue;
+    }
+    const double speed = std::sqrt(state.linear_velocity().x() * state.linear_velocity().x() +
+                                   state.linear_velocity().y() * state.linear_velocity().y() +
+                                   state.linear_velocity().z() * state.linear_velocity().z());
+    AgentAccumulator& agent = (*_agents)[state.name()];
+    if (agent.samples > 0 && _time > agent.last) {
+      const double acceleration = (speed - agent.lastSpeed) / std::chrono::duration<double>(_time - agent.last).count();
+      agent.minAcceleration = agent.accelerations == 0 ? acceleration : std::min(agent.minAcceleration, acceleration);
+      agent.maxAcceleration = agent.accelerations == 0 ? acceleration : std::max(agent.maxAcceleration, acceleration);
+      agent.accelerationSum += acceleration;
+      ++agent.accelerations;
+    }
+    ++agent.samples;
+    agent.speedSum += speed;
+    agent.maxSpeed = std::max(agent.maxSpeed, speed);
+    agent.lastSpeed = speed;
+    agent.last = _time;
+  }
+}
+
+// @return The summary of @p _topic out of @p _acc, over @p _duration.
+LogStats::TopicSummary SummarizeTopic(const std::string& _topic, const TopicAccumulator& _acc,
+                                      const std::chrono::nanoseconds& _duration) {
+  LogStats::TopicSummary summary;
+  summary.topic = _topic;
+  summary.count = _acc.count;
+  summary.bytes = _acc.bytes;
+  summary.rate = _duration.count() > 0 ? _acc.count / std::chrono::duration<double>(_duration).count() : 0.;
+  if (_acc.count > 1) {
+    summary.meanInterval = (_acc.last - _acc.first) / (_acc.count - 1);
+    summary.maxInterval = _acc.maxInterval;
+    summary.gaps = _acc.gaps;
+  }
+  return summary;
+}
+
+// @return The summary of @p _name out of @p _acc.
+LogStats::AgentSummary SummarizeAgent(const std::string& _name, const AgentAccumulator& _acc) {
+  LogStats::AgentSummary summary;
+  summary.name = _name;
+  summary.samples = _acc.samples;
+  summary.meanSpeed = _acc.samples > 0 ? _acc.speedSum / _acc.samples : 0.;
+  summary.maxSpeed = _acc.maxSpeed;
+  summary.meanAcceleration = _acc.accelerations > 0 ? _acc.accelerationSum / _acc.accelerations : 0.;
+  summary.minAcceleration = _acc.minAcceleration;
+  summary.maxAcceleration = _acc.maxAcceleration;
+  return summary;
+}
+
+// @return @p _value quoted as a CSV field when needed.
+std::string CsvField(const std::string& _value) {
+  if (_value.find_first_of(",\"\n") == std::string::npos) {
+    return _value;
+  }
+  std::string quoted{"\""};
+  for (const char c : _value) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// @return @p _duration in milliseconds.
+double ToMs(const std::chrono::nanoseconds& _duration) {
+  return std::chrono::duration<double, std::milli>(_duration).count();
+}
+
+}  // namespace
+
+std::optional<LogStats::Summary> LogStats::Analyze(const std::string& _logPath) {
+  ignition::transport::log::Log log;
+  if (!log.Open(_logPath)) {
+    ignerr << "Unable to open log [" << _logPath << "]." << std::endl;
+    return std::nullopt;
+  }
+
+  Summary summary;
+  summary.path = _logPath;
+  summary.duration = std::max(log.EndTime() - log.StartTime(), std::chrono::nanoseconds(0));
+
+  // Both maps are sorted by name, so the summary does not depend on the log
+  // order.
+  std::map<std::string, TopicAccumulator> topics;
+  std::map<std::string, AgentAccumulator> agents;
+  ignition::msgs::AgentState_V agentStates;
+  for (const ignition::transport::log::Message& msg : log.QueryMessages()) {
+    const std::chrono::nanoseconds time = msg.TimeReceived();
+    topics[msg.Topic()].Add(time, msg.Data().size());
+
+    if (IsAgentStateTopic(msg.Topic())) {
+      if (agentStates.ParseFromString(msg.Data())) {
+        AccumulateAgents(agentStates, time, &agents);
+      } else {
+        ++summary.decodeErrors;
+      }
+    }
+  }
+
+  for (const auto& topic : topics) {
+    summary.topics.push_back(SummarizeTopic(topic.first, topic.second, summary.duration));
+  }
+  for (const auto& agent : agents) {
+    summary.agents.push_back(SummarizeAgent(agent.first, agent.second));
+  }
+  return summary;
+}
+
+std::vector<std::optional<LogStats::Summary>> LogStats::AnalyzeAll(const std::vector<std::string>& _logPaths,
+                                                                   size_t _jobs) {
+  std::vector<std::optional<Summary>> summaries(_logPaths.size());
+  const size_t jobs =
+      std::min(_jobs > 0 ? _jobs : std::max<size_t>(std::thread::hardware_concurrency(), 1), _logPaths.size());
+
+  // Logs are handed out one at a time, so a long log does not hold up the
+  // logs behind it.
+  std::atomic<size_t> next{0};
+  const auto worker = [&]() {
+    for (size_t i = next++; i < _logPaths.size(); i = next++) {
+      summaries[i] = Analyze(_logPaths[i]);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < jobs; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+  return summaries;
+}
+
+void LogStats::WriteTopicsCsv(const std::vector<Summary>& _summaries, std::ostream* _os) {
+  std::ostream& os = *_os;
+  os << "log,topic,duration_s,count,bytes,rate_hz,mean_interval_ms,max_interval_ms,gaps\n";
+  os << std::setprecision(6);
+  for (const Summary& summary : _summaries) {
+    const std::string log = CsvField(summary.path);
+    const double duration = std::chrono::duration<double>(summary.duration).count();
+    for (const TopicSummary& topic : summary.topics) {
+      os << log << "," << CsvField(topic.topic) << "," << duration << "," << topic.count << "," << topic.bytes << ","
+         << topic.rate << "," << ToMs(topic.meanInterval) << "," << ToMs(topic.maxInterval) << "," << topic.gaps
+         << "\n";
+    }
+  }
+}
+
+void LogStats::WriteAgentsCsv(const std::vector<Summary>& _summaries, std::ostream* _os) {
+  std::ostream& os = *_os;
+  os << "log,agent,duration_s,samples,mean_speed,max_speed,mean_acceleration,min_acceleration,max_acceleration\n";
+  os << std::setprecision(6);
+  for (const Summary& summary : _summaries) {
+    const std::string log = CsvField(summary.path);
+    const double duration = std::chrono::duration<double>(summary.duration).count();
+    for (const AgentSummary& agent : summary.agents) {
+      os << log << "," << CsvField(agent.name) << "," << duration << "," << agent.samples << "," << agent.meanSpeed
+         << "," << agent.maxSpeed << "," << agent.meanAcceleration << "," << agent.minAcceleration << ","
+         << agent.maxAcceleration << "\n";
+    }
+  }
+}
+
+}  // namespace gui
+}  // namespace delphyne
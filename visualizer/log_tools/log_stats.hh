@@ -0,0 +1,118 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Summary statistics of ignition transport logs, computed straight
+///        out of their `topic.db` without replaying them.
+class LogStats {
+ public:
+  /// @brief Intervals longer than this many times the mean of the previous
+  ///        intervals of a topic count as gaps.
+  static constexpr double kGapFactor{3.};
+
+  /// @brief Topic whose ignition::msgs::AgentState_V messages are summarized
+  ///        per agent. Log topics are matched regardless of a leading "/".
+  static constexpr char kAgentStateTopic[]{"agents/state"};
+
+  /// @brief Message statistics of a topic.
+  struct TopicSummary {
+    std::string topic;
+    uint64_t count{0};
+    uint64_t bytes{0};
+    /// Messages per second over the log span.
+    double rate{0.};
+    /// Mean and maximum time between consecutive messages.
+    std::chrono::nanoseconds meanInterval{0};
+    std::chrono::nanoseconds maxInterval{0};
+    /// Intervals longer than kGapFactor times the mean of the previous ones.
+    uint64_t gaps{0};
+  };
+
+  /// @brief Motion statistics of an agent. Speed is the norm of the linear
+  ///        velocity and acceleration its change between consecutive states.
+  struct AgentSummary {
+    std::string name;
+    uint64_t samples{0};
+    double meanSpeed{0.};
+    double maxSpeed{0.};
+    double meanAcceleration{0.};
+    double minAcceleration{0.};
+    double maxAcceleration{0.};
+  };
+
+  /// @brief Statistics of a log.
+  struct Summary {
+    std::string path;
+    /// Span between the first and the last message.
+    std::chrono::nanoseconds duration{0};
+    /// Sorted by topic name.
+    std::vector<TopicSummary> topics;
+    /// Sorted by agent name.
+    std::vector<AgentSummary> agents;
+    /// Agent state messages that could not be parsed.
+    uint64_t decodeErrors{0};
+  };
+
+  /// @brief Computes the statistics of the log at @p _logPath.
+  /// @param _logPath Path to an ignition transport log, i.e. a `topic.db`.
+  /// @return The statistics, or std::nullopt when the log cannot be read.
+  static std::optional<Summary> Analyze(const std::string& _logPath);
+
+  /// @brief Computes the statistics of the logs at @p _logPaths on a pool of
+  ///        @p _jobs threads, each one analyzing a log at a time.
+  /// @param _logPaths Paths to ignition transport logs.
+  /// @param _jobs Number of threads, the number of cores when zero.
+  /// @return The statistics of each log, in @p _logPaths order, std::nullopt
+  ///         for the ones that cannot be read.
+  static std::vector<std::optional<Summary>> AnalyzeAll(const std::vector<std::string>& _logPaths, size_t _jobs = 0);
+
+  /// @brief Writes the topics of @p _summaries to @p _os as a CSV table, one
+  ///        row per log topic.
+  static void WriteTopicsCsv(const std::vector<Summary>& _summaries, std::ostream* _os);
+
+  /// @brief Writes the agents of @p _summaries to @p _os as a CSV table, one
+  ///        row per log agent.
+  static void WriteAgentsCsv(const std::vector<Summary>& _summaries, std::ostream* _os);
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,154 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+#include "log_stats.hh"
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Name of the ignition transport log in an extracted Delphyne log.
+constexpr char kTopicLogName[]{"topic.db"};
+
+// Names of the tables in the output directory.
+constexpr char kTopicsCsvName[]{"topics.csv"};
+constexpr char kAgentsCsvName[]{"agents.csv"};
+
+void PrintUsage(const char* _program) {
+  std::cerr << "Usage: " << _program << " [-j jobs] [-o output_directory] <topic.db or directory>..." << std::endl
+            << "Summarizes ignition transport logs, in parallel, into two CSV tables: per topic counts, rates and "
+            << "gaps into " << kTopicsCsvName << ", and per agent speed and acceleration into " << kAgentsCsvName
+            << "." << std::endl
+            << "Without an output directory, both tables are printed, separated by an empty line." << std::endl
+            << "Directories are searched recursively for " << kTopicLogName << " files, e.g. the replay cache at "
+            << "$HOME/.delphyne/cache/extracted." << std::endl;
+}
+
+// Appends the logs found at @p _path to @p _logPaths.
+void FindLogs(const std::string& _path, std::vector<std::string>* _logPaths) {
+  if (!ignition::common::isDirectory(_path)) {
+    _logPaths->push_back(_path);
+    return;
+  }
+  for (ignition::common::DirIter it(_path); it != ignition::common::DirIter(); ++it) {
+    const std::string entry = *it;
+    if (ignition::common::isDirectory(entry)) {
+      FindLogs(entry, _logPaths);
+    } else if (ignition::common::basename(entry) == kTopicLogName) {
+      _logPaths->push_back(entry);
+    }
+  }
+}
+
+int Main(int argc, char** argv) {
+  size_t jobs{0};
+  std::string outputPath;
+  std::vector<std::string> logPaths;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "-j" || arg == "-o") && i + 1 == argc) {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    if (arg == "-j") {
+      const int value = std::atoi(argv[++i]);
+      if (value <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      jobs = static_cast<size_t>(value);
+    } else if (arg == "-o") {
+      outputPath = argv[++i];
+    } else {
+      FindLogs(arg, &logPaths);
+    }
+  }
+  if (logPaths.empty()) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<LogStats::Summary> summaries;
+  int failures{0};
+  for (std::optional<LogStats::Summary>& summary : LogStats::AnalyzeAll(logPaths, jobs)) {
+    if (summary.has_value()) {
+      summaries.push_back(std::move(summary.value()));
+    } else {
+      ++failures;
+    }
+  }
+
+  if (outputPath.empty()) {
+    LogStats::WriteTopicsCsv(summaries, &std::cout);
+    std::cout << std::endl;
+    LogStats::WriteAgentsCsv(summaries, &std::cout);
+  } else {
+    if (!ignition::common::createDirectories(outputPath)) {
+      ignerr << "Unable to create [" << outputPath << "]." << std::endl;
+      return 1;
+    }
+    const std::string topicsPath = ignition::common::joinPaths(outputPath, kTopicsCsvName);
+    std::ofstream topicsOutput(topicsPath);
+    LogStats::WriteTopicsCsv(summaries, &topicsOutput);
+    if (!topicsOutput) {
+      ignerr << "Unable to write [" << topicsPath << "]." << std::endl;
+      return 1;
+    }
+    const std::string agentsPath = ignition::common::joinPaths(outputPath, kAgentsCsvName);
+    std::ofstream agentsOutput(agentsPath);
+    LogStats::WriteAgentsCsv(summaries, &agentsOutput);
+    if (!agentsOutput) {
+      ignerr << "Unable to write [" << agentsPath << "]." << std::endl;
+      return 1;
+    }
+  }
+  if (failures > 0) {
+    ignerr << failures << " of " << logPaths.size() << " logs could not be read." << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace gui
+}  // namespace delphyne
+
+int main(int argc, char** argv) { return delphyne::gui::Main(argc, argv); }
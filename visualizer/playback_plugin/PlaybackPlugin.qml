@@ -35,8 +35,8 @@ import QtQuick.Layouts 1.3
 
 Rectangle {
   id: playbackWidget
-  Layout.minimumWidth: 460
-  Layout.minimumHeight: 175
+  Layout.minimumWidth: 620
+  Layout.minimumHeight: 250
 
   /**
    * True when is playing.
@@ -63,6 +63,11 @@ Rectangle {
    */
   property string stepIcon: "\u25B8\u25B8"
 
+  /**
+   * Step back icon
+   */
+  property string stepBackIcon: "\u25C2\u25C2"
+
   /**
    * Rewind
    */
@@ -108,6 +113,27 @@ Rectangle {
     Material.background: Material.primary
   }
 
+  /**
+   * Step back
+   */
+  RoundButton {
+    id: stepBackButton
+    text: stepBackIcon
+    checkable: true
+    height: playButton.height * 0.8
+    width: playButton.width * 0.8
+    Layout.minimumWidth: width
+    Layout.leftMargin: 10
+    enabled: isPlaying ? false : true
+    anchors.left : playButton.right
+    anchors.leftMargin : 10
+    anchors.verticalCenter : playButton.verticalCenter
+    onClicked: {
+      PlaybackPlugin.OnStepBackButtonPush(spinBox.value);
+    }
+    Material.background: Material.primary
+  }
+
   /**
    * Step
    */
@@ -120,7 +146,7 @@ Rectangle {
     Layout.minimumWidth: width
     Layout.leftMargin: 10
     enabled: isPlaying ? false : true
-    anchors.left : playButton.right
+    anchors.left : stepBackButton.right
     anchors.leftMargin : 10
     anchors.verticalCenter : playButton.verticalCenter
     onClicked: {
@@ -144,6 +170,7 @@ Rectangle {
    * ms text
    */
   Text {
+    id: msText
     anchors.left : spinBox.right
     anchors.verticalCenter : spinBox.verticalCenter
     font.pointSize: 11
@@ -151,6 +178,55 @@ Rectangle {
     styleColor: "gray"
   }
 
+  /**
+   * Pending request indicator, running until the replayer answers.
+   */
+  BusyIndicator {
+    id: requestIndicator
+    running: PlaybackPlugin.isRequestPending
+    height: stepButton.height
+    width: stepButton.height
+    anchors.left : msText.right
+    anchors.leftMargin : 10
+    anchors.verticalCenter : spinBox.verticalCenter
+  }
+
+  /**
+   * Previous burst
+   */
+  Button {
+    id: previousBurstButton
+    text: "\u25C2|"
+    width: 40
+    visible: PlaybackPlugin.timelineDensity.length > 0
+    anchors.left : requestIndicator.right
+    anchors.leftMargin : 10
+    anchors.verticalCenter : spinBox.verticalCenter
+    ToolTip.visible: hovered
+    ToolTip.text: "Previous burst of messages"
+    onClicked: {
+      PlaybackPlugin.OnPreviousBurstButtonPush();
+    }
+  }
+
+  /**
+   * Next burst
+   */
+  Button {
+    id: nextBurstButton
+    text: "|\u25B8"
+    width: 40
+    visible: PlaybackPlugin.timelineDensity.length > 0
+    anchors.left : previousBurstButton.right
+    anchors.leftMargin : 5
+    anchors.verticalCenter : spinBox.verticalCenter
+    ToolTip.visible: hovered
+    ToolTip.text: "Next burst of messages"
+    onClicked: {
+      PlaybackPlugin.OnNextBurstButtonPush();
+    }
+  }
+
   /**
    * Current time text
    */
@@ -182,10 +258,29 @@ Rectangle {
     }
 
     from: 0
-    value: !pressed ? PlaybackPlugin.sliderValue : PlaybackPlugin.OnSliderDrop(slider.value)
     to: 100
     stepSize: 0.01
+    // Seeks are throttled while the slider is held and a precise one is sent
+    // on release.
+    onMoved: {
+      PlaybackPlugin.OnSliderMoved(slider.value);
+    }
+    onPressedChanged: {
+      PlaybackPlugin.isSliderPressed = pressed;
+      if (!pressed) {
+        PlaybackPlugin.OnSliderDrop(slider.value);
+      }
+    }
+  }
 
+  /**
+   * Keeps the slider in sync with the playback while it is not held.
+   */
+  Binding {
+    target: slider
+    property: "value"
+    value: PlaybackPlugin.sliderValue
+    when: !slider.pressed
   }
 
   /**
@@ -197,4 +292,72 @@ Rectangle {
     anchors.verticalCenter : slider.verticalCenter
     font.pointSize: 10; text: PlaybackPlugin.simTime ; styleColor: "gray"
   }
+
+  /**
+   * Message density of the log over the timeline, when indexed.
+   */
+  Row {
+    id: densityStrip
+    height: 12
+    x: slider.x + slider.leftPadding
+    width: slider.availableWidth
+    anchors.top : slider.bottom
+    visible: PlaybackPlugin.timelineDensity.length > 0
+    Repeater {
+      model: PlaybackPlugin.timelineDensity
+      Rectangle {
+        width: densityStrip.width / PlaybackPlugin.timelineDensity.length
+        height: densityStrip.height
+        color: Qt.rgba(0.2, 0.4, 0.8, modelData)
+      }
+    }
+  }
+
+  /**
+   * Frame cache stats text.
+   */
+  Text {
+    id: frameCacheStatsText
+    anchors.left : currentTimeText.left
+    anchors.top : densityStrip.bottom
+    anchors.topMargin : 4
+    font.pointSize: 9; text: PlaybackPlugin.frameCacheStats ; styleColor: "gray"
+  }
+
+  /**
+   * Playback rate selector, a rate of 0 plays as fast as possible.
+   */
+  ComboBox {
+    id: rateComboBox
+    width: 110
+    anchors.left : currentTimeText.left
+    anchors.top : frameCacheStatsText.bottom
+    anchors.topMargin : 4
+    textRole: "text"
+    currentIndex: 3
+    model: ListModel {
+      ListElement { text: "0.1x"; rate: 0.1 }
+      ListElement { text: "0.25x"; rate: 0.25 }
+      ListElement { text: "0.5x"; rate: 0.5 }
+      ListElement { text: "1x"; rate: 1 }
+      ListElement { text: "2x"; rate: 2 }
+      ListElement { text: "4x"; rate: 4 }
+      ListElement { text: "8x"; rate: 8 }
+      ListElement { text: "max"; rate: 0 }
+    }
+    onActivated: {
+      PlaybackPlugin.OnRateSelected(model.get(index).rate);
+    }
+  }
+
+  /**
+   * Requested and achieved playback rates.
+   */
+  Text {
+    id: rateStatsText
+    anchors.left : rateComboBox.right
+    anchors.leftMargin : 10
+    anchors.verticalCenter : rateComboBox.verticalCenter
+    font.pointSize: 9; text: PlaybackPlugin.playbackRateStats ; styleColor: "gray"
+  }
 }
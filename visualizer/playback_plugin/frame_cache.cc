@@ -0,0 +1,101 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "frame_cache.hh"
+
+#include <map>
+#include <utility>
+
+namespace delphyne {
+namespace gui {
+
+FrameCache::FrameCache(const std::chrono::nanoseconds& _window, size_t _maxBytes)
+    : window(_window), maxBytes(_maxBytes) {}
+
+void FrameCache::Add(Entry _entry) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!entries.empty() && _entry.time < entries.back().time) {
+    // The playback jumped backwards, cached entries belong to another timeline.
+    entries.clear();
+    bytes = 0;
+  }
+  bytes += _entry.data.size();
+  entries.push_back(std::move(_entry));
+  Trim();
+}
+
+void FrameCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  bytes = 0;
+}
+
+bool FrameCache::Contains(const std::chrono::nanoseconds& _time) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return !entries.empty() && entries.front().time <= _time && _time <= entries.back().time;
+}
+
+std::vector<FrameCache::Entry> FrameCache::FrameAt(const std::chrono::nanoseconds& _time) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  // Walks backwards from the newest entry, so the first entry found for each
+  // topic is the latest one.
+  std::map<std::string, const Entry*> latestEntries;
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->time <= _time) {
+      latestEntries.emplace(it->topic, &(*it));
+    }
+  }
+  std::vector<Entry> frame;
+  frame.reserve(latestEntries.size());
+  for (const auto& topicEntry : latestEntries) {
+    frame.push_back(*topicEntry.second);
+  }
+  return frame;
+}
+
+std::chrono::nanoseconds FrameCache::Span() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.empty() ? std::chrono::nanoseconds::zero() : entries.back().time - entries.front().time;
+}
+
+size_t FrameCache::Bytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return bytes;
+}
+
+void FrameCache::Trim() {
+  const std::chrono::nanoseconds newestTime = entries.back().time;
+  while (!entries.empty() && (bytes > maxBytes || newestTime - entries.front().time > window)) {
+    bytes -= entries.front().data.size();
+    entries.pop_front();
+  }
+}
+
+}  // namespace gui
+}  // namespace delphyne
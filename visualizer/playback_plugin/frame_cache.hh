@@ -0,0 +1,112 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Memory bounded ring of the latest serialized messages received
+///        during playback, indexed by playback time.
+/// @details Entries must be added in non decreasing time order. An entry older
+///          than the newest one means that the playback jumped backwards, in
+///          which case the cache is cleared. The cache keeps at most the last
+///          `window` of playback time and never more than `maxBytes` of
+///          payload; the oldest entries are dropped first.
+///          All methods are thread safe.
+class FrameCache {
+ public:
+  /// @brief A serialized message and the playback time it belongs to.
+  struct Entry {
+    /// Playback time at which the message was received.
+    std::chrono::nanoseconds time{0};
+    /// Topic the message was published in.
+    std::string topic;
+    /// Message type name.
+    std::string msgType;
+    /// Serialized message.
+    std::string data;
+  };
+
+  /// @brief Constructs an empty cache.
+  /// @param _window The span of playback time to keep. It must be non negative.
+  /// @param _maxBytes The maximum number of payload bytes to keep.
+  FrameCache(const std::chrono::nanoseconds& _window, size_t _maxBytes);
+
+  /// @brief Adds @p _entry to the cache, dropping the entries that fall out of
+  ///        the time window or the memory budget.
+  void Add(Entry _entry);
+
+  /// @brief Drops all the entries.
+  void Clear();
+
+  /// @return Whether @p _time is within the cached span of playback time.
+  bool Contains(const std::chrono::nanoseconds& _time) const;
+
+  /// @return The latest entry of each topic whose time is not greater than
+  ///         @p _time, i.e. what was last shown at @p _time.
+  std::vector<Entry> FrameAt(const std::chrono::nanoseconds& _time) const;
+
+  /// @return The span of playback time currently cached.
+  std::chrono::nanoseconds Span() const;
+
+  /// @return The number of payload bytes currently cached.
+  size_t Bytes() const;
+
+ private:
+  // Drops the oldest entries out of the window or the memory budget.
+  // `mutex` must be locked.
+  void Trim();
+
+  // The span of playback time to keep.
+  const std::chrono::nanoseconds window;
+
+  // The maximum number of payload bytes to keep.
+  const size_t maxBytes;
+
+  // Entries in time order.
+  std::deque<Entry> entries;
+
+  // Payload bytes in `entries`.
+  size_t bytes{0};
+
+  // Mutex to protect the entries between threads.
+  mutable std::mutex mutex;
+};
+
+}  // namespace gui
+}  // namespace delphyne
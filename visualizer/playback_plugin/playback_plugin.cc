@@ -30,7 +30,9 @@
 
 #include "playback_plugin.hh"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -41,6 +43,9 @@
 #include <ignition/plugin/Register.hh>
 #include <maliput/common/maliput_throw.h>
 
+#include "visualizer/global_attributes.hh"
+#include "visualizer/plugin_metrics.hh"
+
 Q_DECLARE_METATYPE(ignition::msgs::PlaybackStatus)
 
 namespace delphyne {
@@ -75,21 +80,105 @@ void ChronoToDuration(const std::chrono::nanoseconds& _src, ignition::msgs::Dura
   dst->set_nsec((_src - src_in_seconds).count());
 }
 
+// Time spent on playback status messages, on copying played back messages
+// into the frame cache, counting their payload, and on the request, display
+// and scrub timers.
+const PluginMetrics::CounterHandle kStatusMetrics = PluginMetrics::Instance()->Register("PlaybackPlugin", "status");
+const PluginMetrics::CounterHandle kCachedMessageMetrics =
+    PluginMetrics::Instance()->Register("PlaybackPlugin", "cached_message");
+const PluginMetrics::CounterHandle kTimerMetrics = PluginMetrics::Instance()->Register("PlaybackPlugin", "timer");
+
 }  // namespace
 
-PlaybackPlugin::PlaybackPlugin() : ignition::gui::Plugin() { qRegisterMetaType<ignition::msgs::PlaybackStatus>(); }
+PlaybackPlugin::PlaybackPlugin()
+    : ignition::gui::Plugin(),
+      stepPacer(std::bind(&PlaybackPlugin::SendPacedStep, this, std::placeholders::_1, std::placeholders::_2),
+                std::chrono::milliseconds(kPacerPeriodInMs), std::chrono::milliseconds(kMaxRateStepInMs),
+                std::chrono::milliseconds(kRequestTimeoutInMs)) {
+  qRegisterMetaType<ignition::msgs::PlaybackStatus>();
+  // Replayer answers arrive in a transport thread, the connection queues them
+  // into the GUI thread.
+  connect(this, &PlaybackPlugin::RequestCompleted, this, &PlaybackPlugin::OnRequestCompleted, Qt::QueuedConnection);
+  connect(this, &PlaybackPlugin::LogIndexLoaded, this, &PlaybackPlugin::OnLogIndexLoaded, Qt::QueuedConnection);
+}
+
+PlaybackPlugin::~PlaybackPlugin() {
+  stepPacer.Stop();
+  // Indexing a long log is abandoned rather than waited for.
+  stopLogIndex = true;
+  if (logIndexThread.joinable()) {
+    logIndexThread.join();
+  }
+}
 
 void PlaybackPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   title = "PlaybackWidget";
 
+  int frameCacheSeconds{kDefaultFrameCacheSeconds};
+  int frameCacheMegabytes{kDefaultFrameCacheMegabytes};
   if (!_pluginElem) {
     ignerr << "Error reading plugin XML element " << std::endl;
+  } else {
+    if (auto elem = _pluginElem->FirstChildElement("scrub_interval_ms")) {
+      if (elem->QueryIntText(&scrubIntervalInMs) != tinyxml2::XML_SUCCESS) {
+        ignwarn << "Invalid <scrub_interval_ms>, using " << kDefaultScrubIntervalInMs << std::endl;
+        scrubIntervalInMs = kDefaultScrubIntervalInMs;
+      } else if (scrubIntervalInMs < kMinScrubIntervalInMs) {
+        ignwarn << "<scrub_interval_ms> is below " << kMinScrubIntervalInMs << ", using " << kMinScrubIntervalInMs
+                << std::endl;
+        scrubIntervalInMs = kMinScrubIntervalInMs;
+      }
+    }
+    if (auto frameCacheElem = _pluginElem->FirstChildElement("frame_cache")) {
+      if (auto elem = frameCacheElem->FirstChildElement("seconds")) {
+        elem->QueryIntText(&frameCacheSeconds);
+      }
+      if (auto elem = frameCacheElem->FirstChildElement("max_megabytes")) {
+        elem->QueryIntText(&frameCacheMegabytes);
+      }
+      for (auto elem = frameCacheElem->FirstChildElement("topic"); elem != nullptr;
+           elem = elem->NextSiblingElement("topic")) {
+        if (elem->GetText() != nullptr) {
+          frameCacheTopics.push_back(elem->GetText());
+        }
+      }
+    }
+  }
+  if (frameCacheTopics.empty()) {
+    frameCacheTopics = {kAgentsTopicName, kPoseUpdateTopicName};
   }
 
   if (!node.Subscribe(kStatusTopicName, &PlaybackPlugin::OnStatusMessage, this)) {
     ignerr << "Error subscribing to topic "
            << "[" << kStatusTopicName << "]" << std::endl;
   }
+
+  if (frameCacheSeconds > 0 && frameCacheMegabytes > 0) {
+    frameCache = std::make_unique<FrameCache>(std::chrono::seconds(frameCacheSeconds),
+                                              static_cast<size_t>(frameCacheMegabytes) * 1024 * 1024);
+    for (const std::string& topic : frameCacheTopics) {
+      auto subscription = SubscriptionHub::Instance()->SubscribeRaw(
+          topic, [this](const SubscriptionHub::DataPtr& _msgData, const ignition::transport::MessageInfo& _info) {
+            OnCachedTopicMessage(_msgData->data(), _msgData->size(), _info);
+          });
+      if (subscription != nullptr) {
+        frameCacheSubscriptions.push_back(std::move(subscription));
+      }
+    }
+  }
+  UpdateFrameCacheStats();
+
+  if (GlobalAttributes::HasArgument("playback-log") && GlobalAttributes::HasArgument("playback-index")) {
+    const std::string logPath = GlobalAttributes::GetArgument("playback-log");
+    const std::string indexPath = GlobalAttributes::GetArgument("playback-index");
+    // Indexing a long log takes seconds, it must not stall the GUI.
+    logIndexThread = std::thread([this, logPath, indexPath]() {
+      loadedLogIndex = LogIndex::OpenOrBuild(logPath, indexPath, LogIndex::kDefaultBucketCount, &stopLogIndex);
+      emit LogIndexLoaded();
+    });
+  }
+
+  displayTimer.start(kDisplayPeriodInMs, this);
 }
 
 QString PlaybackPlugin::SimTime() const { return simTime; }
@@ -98,6 +187,16 @@ QString PlaybackPlugin::CurrentTime() const { return currentTime; }
 
 QString PlaybackPlugin::SliderValue() const { return sliderValue; }
 
+bool PlaybackPlugin::IsSliderPressed() const { return isSliderPressed; }
+
+bool PlaybackPlugin::IsRequestPending() const { return isRequestPending; }
+
+QString PlaybackPlugin::FrameCacheStats() const { return frameCacheStats; }
+
+QVariantList PlaybackPlugin::TimelineDensity() const { return timelineDensity; }
+
+QString PlaybackPlugin::PlaybackRateStats() const { return playbackRateStats; }
+
 void PlaybackPlugin::SetSimTime(const QString& _simTime) {
   simTime = _simTime;
   SimTimeChanged();
@@ -113,71 +212,456 @@ void PlaybackPlugin::SetSliderValue(const QString& _sliderValue) {
   SliderValueChanged();
 }
 
+void PlaybackPlugin::SetIsSliderPressed(bool _isSliderPressed) {
+  isSliderPressed = _isSliderPressed;
+  IsSliderPressedChanged();
+}
+
 void PlaybackPlugin::OnStatusMessage(const ignition::msgs::PlaybackStatus& _msg) {
-  timeStatus.current_time = IgnitionTimeToChrono(_msg.current_time());
-  timeStatus.start_time = IgnitionTimeToChrono(_msg.start_time());
-  timeStatus.end_time = IgnitionTimeToChrono(_msg.end_time());
-  SetSimTime(ChronoToQString(timeStatus.current_time) + " / " + ChronoToQString(timeStatus.end_time));
-  SetCurrentTime(ChronoToQString(timeStatus.current_time));
-  SetSliderValue(QString::fromStdString(std::to_string(timeStatus.current_time.count() * 100. /
-                                                       (timeStatus.end_time.count() - timeStatus.start_time.count()))));
+  const PluginMetrics::Scope metrics(kStatusMetrics);
+  SimTimes newTimeStatus;
+  newTimeStatus.current_time = IgnitionTimeToChrono(_msg.current_time());
+  newTimeStatus.start_time = IgnitionTimeToChrono(_msg.start_time());
+  newTimeStatus.end_time = IgnitionTimeToChrono(_msg.end_time());
+  {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    receivedTimeStatus = newTimeStatus;
+  }
+  latestStatusTime = newTimeStatus.current_time.count();
+  hasNewTimeStatus = true;
+}
+
+void PlaybackPlugin::OnCachedTopicMessage(const char* _msgData, const size_t _size,
+                                          const ignition::transport::MessageInfo& _info) {
+  const PluginMetrics::Scope metrics(kCachedMessageMetrics, _size);
+  // Messages republished from the cache are not new frames.
+  if (isServingCachedFrame) {
+    return;
+  }
+  frameCache->Add(FrameCache::Entry{std::chrono::nanoseconds(latestStatusTime.load()), _info.Topic(), _info.Type(),
+                                    std::string(_msgData, _size)});
+}
+
+void PlaybackPlugin::UpdateTimeStatus() {
+  if (!hasNewTimeStatus.exchange(false)) {
+    return;
+  }
+  SimTimes newTimeStatus;
+  {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    newTimeStatus = receivedTimeStatus;
+  }
+  const bool hasCurrentTimeChanged = newTimeStatus.current_time != timeStatus.current_time;
+  const bool hasTimeSpanChanged =
+      newTimeStatus.start_time != timeStatus.start_time || newTimeStatus.end_time != timeStatus.end_time;
+  if (!hasCurrentTimeChanged && !hasTimeSpanChanged) {
+    return;
+  }
+  timeStatus = newTimeStatus;
+  RefreshTimeProperties();
+}
+
+void PlaybackPlugin::RefreshTimeProperties() {
+  // While a cached frame is shown the replayer sits at the newest frame.
+  const std::chrono::nanoseconds shownTime = cachedFrameTime.value_or(timeStatus.current_time);
+  const QString newCurrentTime = ChronoToQString(shownTime);
+  const QString newSimTime = newCurrentTime + " / " + ChronoToQString(timeStatus.end_time);
+  if (newSimTime != simTime) {
+    SetSimTime(newSimTime);
+  }
+  if (newCurrentTime != currentTime) {
+    SetCurrentTime(newCurrentTime);
+  }
+  // The slider follows the user while it is held.
+  if (isSliderPressed) {
+    return;
+  }
+  SetSliderValue(QString::fromStdString(
+      std::to_string(shownTime.count() * 100. / (timeStatus.end_time.count() - timeStatus.start_time.count()))));
+}
+
+bool PlaybackPlugin::ServeFromCache(const std::chrono::nanoseconds& _time) {
+  if (!frameCache) {
+    return false;
+  }
+  if (!frameCache->Contains(_time)) {
+    ++frameCacheMisses;
+    UpdateFrameCacheStats();
+    return false;
+  }
+  isServingCachedFrame = true;
+  for (const FrameCache::Entry& entry : frameCache->FrameAt(_time)) {
+    auto it = frameCachePublishers.find(entry.topic);
+    if (it == frameCachePublishers.end()) {
+      it = frameCachePublishers.emplace(entry.topic, node.Advertise(entry.topic, entry.msgType)).first;
+    }
+    if (!it->second.PublishRaw(entry.data, entry.msgType)) {
+      ignerr << "Failed to republish a cached message on topic [" << entry.topic << "]" << std::endl;
+    }
+  }
+  cachedFrameTime = _time;
+  ++frameCacheHits;
+  UpdateFrameCacheStats();
+  RefreshTimeProperties();
+  return true;
+}
+
+void PlaybackPlugin::LeaveCachedFrame() {
+  if (!cachedFrameTime.has_value()) {
+    return;
+  }
+  cachedFrameTime.reset();
+  isServingCachedFrame = false;
+  RefreshTimeProperties();
+}
+
+void PlaybackPlugin::UpdateFrameCacheStats() {
+  QString newFrameCacheStats;
+  if (frameCache) {
+    const uint64_t steps = frameCacheHits + frameCacheMisses;
+    const double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(frameCache->Span()).count() / 1000.;
+    const double megabytes = static_cast<double>(frameCache->Bytes()) / (1024. * 1024.);
+    newFrameCacheStats = "Cache: " + QString::number(seconds, 'f', 1) + " s, " + QString::number(megabytes, 'f', 1) +
+                         " MB, hits " + QString::number(frameCacheHits) + "/" + QString::number(steps);
+    if (steps > 0) {
+      newFrameCacheStats += " (" + QString::number(100. * frameCacheHits / steps, 'f', 0) + "%)";
+    }
+  }
+  if (newFrameCacheStats == frameCacheStats) {
+    return;
+  }
+  frameCacheStats = newFrameCacheStats;
+  FrameCacheStatsChanged();
 }
 
 void PlaybackPlugin::OnRewindButtonPush() {
+  LeaveCachedFrame();
+  RequestSeek(std::chrono::nanoseconds::zero());
+}
+
+void PlaybackPlugin::OnPauseButtonPush() {
+  isPlaying = false;
+  ApplyPlaybackRate();
+}
+
+void PlaybackPlugin::OnPlayButtonPush() {
+  if (cachedFrameTime.has_value()) {
+    // The replayer must resume from the frame shown, not from where it paused.
+    RequestSeek(cachedFrameTime.value());
+    LeaveCachedFrame();
+  }
+  isPlaying = true;
+  ApplyPlaybackRate();
+}
+
+void PlaybackPlugin::OnRateSelected(double _rate) {
+  if (_rate == playbackRate) {
+    return;
+  }
+  playbackRate = _rate;
+  rateSamples.clear();
+  if (isPlaying) {
+    ApplyPlaybackRate();
+  }
+}
+
+void PlaybackPlugin::ApplyPlaybackRate() {
+  if (!isPlaying) {
+    stepPacer.Stop();
+    RequestPause();
+    return;
+  }
+  if (playbackRate == 1.) {
+    stepPacer.Stop();
+    RequestResume();
+    return;
+  }
+  // The replayer is held paused and stepped from the pacer thread.
+  RequestPause();
+  stepPacer.Start(playbackRate);
+}
+
+bool PlaybackPlugin::SendPacedStep(const std::chrono::nanoseconds& _stepSize, const StepPacer::DoneCallback& _done) {
   ignition::msgs::Duration msg;
-  msg.set_sec(0);
-  msg.set_nsec(0);
-  RequestSeek(msg);
+  ChronoToDuration(_stepSize, &msg);
+  // The callback does not capture the plugin, answers may arrive after it
+  // is gone.
+  std::function<void(const ignition::msgs::Empty&, const bool)> callback =
+      [_done](const ignition::msgs::Empty& /* _reply */, const bool _result) { _done(_result); };
+  return pacerNode.Request(kStepServiceName, msg, callback);
 }
 
-void PlaybackPlugin::OnPauseButtonPush() { RequestPause(); }
+void PlaybackPlugin::UpdatePlaybackRateStats() {
+  const auto now = std::chrono::steady_clock::now();
+  // Seeking backwards makes older samples meaningless.
+  if (!rateSamples.empty() && timeStatus.current_time < rateSamples.back().second) {
+    rateSamples.clear();
+  }
+  rateSamples.emplace_back(now, timeStatus.current_time);
+  while (rateSamples.size() > 2 && now - rateSamples.front().first > std::chrono::milliseconds(kRateWindowInMs)) {
+    rateSamples.pop_front();
+  }
 
-void PlaybackPlugin::OnPlayButtonPush() { RequestResume(); }
+  QString newPlaybackRateStats = "Rate: " + (playbackRate > 0. ? QString::number(playbackRate) + "x" : "max");
+  if (isPlaying && playbackRate != 1. && !stepPacer.IsRunning()) {
+    // The pacer stops by itself when a step fails or times out.
+    newPlaybackRateStats += ", stalled";
+  } else if (isPlaying && rateSamples.size() > 1) {
+    const double wallSeconds =
+        std::chrono::duration<double>(rateSamples.back().first - rateSamples.front().first).count();
+    const double playedSeconds =
+        std::chrono::duration<double>(rateSamples.back().second - rateSamples.front().second).count();
+    if (wallSeconds > 0.) {
+      newPlaybackRateStats += ", achieved: " + QString::number(playedSeconds / wallSeconds, 'f', 2) + "x";
+    }
+  }
+  if (newPlaybackRateStats == playbackRateStats) {
+    return;
+  }
+  playbackRateStats = newPlaybackRateStats;
+  PlaybackRateStatsChanged();
+}
 
 void PlaybackPlugin::OnStepButtonPush(const QString& _stepValue) {
   const std::chrono::milliseconds time_step(_stepValue.toInt());
-  ignition::msgs::Duration time_step_msg;
-  ChronoToDuration(time_step, &time_step_msg);
-  RequestStep(time_step_msg);
+  if (!cachedFrameTime.has_value()) {
+    RequestStep(time_step);
+    return;
+  }
+  const std::chrono::nanoseconds target_time = cachedFrameTime.value() + time_step;
+  if (ServeFromCache(target_time)) {
+    return;
+  }
+  // Past the newest cached frame, the replayer takes over from there.
+  LeaveCachedFrame();
+  RequestSeek(target_time);
+}
+
+void PlaybackPlugin::OnStepBackButtonPush(const QString& _stepValue) {
+  const std::chrono::milliseconds time_step(_stepValue.toInt());
+  const std::chrono::nanoseconds target_time =
+      std::max(cachedFrameTime.value_or(timeStatus.current_time) - time_step, std::chrono::nanoseconds::zero());
+  if (ServeFromCache(target_time)) {
+    return;
+  }
+  LeaveCachedFrame();
+  RequestSeek(target_time);
+}
+
+void PlaybackPlugin::OnNextBurstButtonPush() {
+  if (!logIndex) {
+    return;
+  }
+  const std::optional<std::chrono::nanoseconds> burstTime =
+      logIndex->NextBurst(cachedFrameTime.value_or(timeStatus.current_time));
+  if (burstTime.has_value()) {
+    LeaveCachedFrame();
+    RequestSeek(burstTime.value());
+  }
+}
+
+void PlaybackPlugin::OnPreviousBurstButtonPush() {
+  if (!logIndex) {
+    return;
+  }
+  const std::optional<std::chrono::nanoseconds> burstTime =
+      logIndex->PreviousBurst(cachedFrameTime.value_or(timeStatus.current_time));
+  if (burstTime.has_value()) {
+    LeaveCachedFrame();
+    RequestSeek(burstTime.value());
+  }
+}
+
+void PlaybackPlugin::OnLogIndexLoaded() {
+  logIndexThread.join();
+  logIndex = std::move(loadedLogIndex);
+  if (!logIndex) {
+    ignwarn << "No log index available, the timeline density is disabled." << std::endl;
+    return;
+  }
+
+  // Buckets are folded into the strip columns, keeping the busiest one.
+  const std::vector<uint32_t> counts = logIndex->TotalCounts();
+  std::vector<uint32_t> columns(kTimelineColumns, 0);
+  for (size_t bucket = 0; bucket < counts.size(); ++bucket) {
+    uint32_t& column = columns[bucket * kTimelineColumns / counts.size()];
+    column = std::max(column, counts[bucket]);
+  }
+  const uint32_t maxCount = *std::max_element(columns.begin(), columns.end());
+  timelineDensity.clear();
+  for (const uint32_t count : columns) {
+    timelineDensity.append(maxCount > 0 ? static_cast<double>(count) / maxCount : 0.);
+  }
+  TimelineDensityChanged();
+}
+
+void PlaybackPlugin::OnSliderMoved(const QString& _sliderValue) {
+  LeaveCachedFrame();
+  if (scrubTimer.isActive()) {
+    // A seek went out less than `scrubIntervalInMs` ago, keep only the latest
+    // position until the next tick.
+    scrubSliderValue = _sliderValue;
+    return;
+  }
+  RequestSeek(SliderValueToTime(_sliderValue));
+  scrubTimer.start(scrubIntervalInMs, this);
 }
 
 QString PlaybackPlugin::OnSliderDrop(const QString& _sliderValue) {
+  LeaveCachedFrame();
+  scrubTimer.stop();
+  scrubSliderValue.reset();
+  const std::chrono::nanoseconds new_current_time = SliderValueToTime(_sliderValue);
+  timeStatus.current_time = new_current_time;
+  // Keeps the slider where it was dropped until the replayer reports back.
+  SetSliderValue(_sliderValue);
+  RequestSeek(new_current_time);
+  return _sliderValue;
+}
+
+std::chrono::nanoseconds PlaybackPlugin::SliderValueToTime(const QString& _sliderValue) const {
   const int kNanoToMilliRatio{1000000};
   const double kSliderSpan{100.};
-  const std::chrono::milliseconds new_current_time{static_cast<int>(
+  return std::chrono::milliseconds{static_cast<int>(
       ((timeStatus.end_time.count() - timeStatus.start_time.count()) * _sliderValue.toDouble() / kSliderSpan) /
       kNanoToMilliRatio)};
-  timeStatus.current_time = new_current_time;
-  ignition::msgs::Duration time_seek_msg;
-  ChronoToDuration(new_current_time, &time_seek_msg);
-  RequestSeek(time_seek_msg);
-  return _sliderValue;
 }
 
-void PlaybackPlugin::RequestPause() {
-  const ignition::msgs::Empty msg;
-  if (!node.Request(kPauseServiceName, msg)) {
-    ignerr << "Failed to request a playback pause." << std::endl;
+void PlaybackPlugin::RequestPause() { EnqueueRequest(PendingRequest{RequestType::kPause}); }
+
+void PlaybackPlugin::RequestResume() { EnqueueRequest(PendingRequest{RequestType::kResume}); }
+
+void PlaybackPlugin::RequestSeek(const std::chrono::nanoseconds& _seekOffset) {
+  EnqueueRequest(PendingRequest{RequestType::kSeek, _seekOffset});
+}
+
+void PlaybackPlugin::RequestStep(const std::chrono::nanoseconds& _stepSize) {
+  EnqueueRequest(PendingRequest{RequestType::kStep, _stepSize});
+}
+
+void PlaybackPlugin::EnqueueRequest(const PendingRequest& _request) {
+  switch (_request.type) {
+    case RequestType::kSeek:
+      // The seek target is absolute, so it makes any queued move pointless.
+      queuedRequests.erase(std::remove_if(queuedRequests.begin(), queuedRequests.end(),
+                                          [](const PendingRequest& _queued) {
+                                            return _queued.type == RequestType::kSeek ||
+                                                   _queued.type == RequestType::kStep;
+                                          }),
+                           queuedRequests.end());
+      queuedRequests.push_back(_request);
+      break;
+    case RequestType::kStep:
+      // Steps are relative, consecutive ones are merged.
+      if (!queuedRequests.empty() && queuedRequests.back().type == RequestType::kStep) {
+        queuedRequests.back().duration += _request.duration;
+      } else {
+        queuedRequests.push_back(_request);
+      }
+      break;
+    case RequestType::kPause:
+    case RequestType::kResume:
+      // Only the last pause or resume command matters.
+      queuedRequests.erase(std::remove_if(queuedRequests.begin(), queuedRequests.end(),
+                                          [](const PendingRequest& _queued) {
+                                            return _queued.type == RequestType::kPause ||
+                                                   _queued.type == RequestType::kResume;
+                                          }),
+                           queuedRequests.end());
+      queuedRequests.push_back(_request);
+      break;
+  }
+  if (!isRequestPending) {
+    SendNextRequest();
   }
 }
 
-void PlaybackPlugin::RequestResume() {
-  const ignition::msgs::Empty msg;
-  if (!node.Request(kResumeServiceName, msg)) {
-    ignerr << "Failed to request a playback resume." << std::endl;
+void PlaybackPlugin::SendNextRequest() {
+  while (!queuedRequests.empty()) {
+    const PendingRequest request = queuedRequests.front();
+    queuedRequests.pop_front();
+
+    const quint64 requestId = ++lastRequestId;
+    std::function<void(const ignition::msgs::Empty&, const bool)> callback =
+        [this, requestId](const ignition::msgs::Empty& /* _reply */, const bool _result) {
+          emit RequestCompleted(requestId, _result);
+        };
+
+    bool isSent{false};
+    switch (request.type) {
+      case RequestType::kPause: {
+        const ignition::msgs::Empty msg;
+        isSent = node.Request(kPauseServiceName, msg, callback);
+        break;
+      }
+      case RequestType::kResume: {
+        const ignition::msgs::Empty msg;
+        isSent = node.Request(kResumeServiceName, msg, callback);
+        break;
+      }
+      case RequestType::kStep: {
+        ignition::msgs::Duration msg;
+        ChronoToDuration(request.duration, &msg);
+        isSent = node.Request(kStepServiceName, msg, callback);
+        break;
+      }
+      case RequestType::kSeek: {
+        ignition::msgs::Duration msg;
+        ChronoToDuration(request.duration, &msg);
+        isSent = node.Request(kSeekServiceName, msg, callback);
+        break;
+      }
+    }
+    if (isSent) {
+      requestTimer.start(kRequestTimeoutInMs, this);
+      SetIsRequestPending(true);
+      return;
+    }
+    ignerr << "Failed to send a playback request." << std::endl;
+  }
+  SetIsRequestPending(false);
+}
+
+void PlaybackPlugin::OnRequestCompleted(quint64 _requestId, bool _result) {
+  // Late answers of requests that already timed out are ignored.
+  if (!isRequestPending || _requestId != lastRequestId) {
+    return;
+  }
+  if (!_result) {
+    ignerr << "The replayer failed to serve a playback request." << std::endl;
   }
+  requestTimer.stop();
+  SendNextRequest();
 }
 
-void PlaybackPlugin::RequestSeek(const ignition::msgs::Duration& _seekOffset) {
-  if (!node.Request(kSeekServiceName, _seekOffset)) {
-    ignerr << "Failed to request a playback seek." << std::endl;
+void PlaybackPlugin::timerEvent(QTimerEvent* _event) {
+  const PluginMetrics::Scope metrics(kTimerMetrics);
+  if (_event->timerId() == requestTimer.timerId()) {
+    requestTimer.stop();
+    ignerr << "Playback request timed out after " << kRequestTimeoutInMs << "ms." << std::endl;
+    SendNextRequest();
+  } else if (_event->timerId() == displayTimer.timerId()) {
+    UpdateTimeStatus();
+    UpdateFrameCacheStats();
+    UpdatePlaybackRateStats();
+  } else if (_event->timerId() == scrubTimer.timerId()) {
+    if (!scrubSliderValue.has_value()) {
+      // The slider did not move during the last interval.
+      scrubTimer.stop();
+      return;
+    }
+    // Queued seeks are superseded by this one, see EnqueueRequest().
+    RequestSeek(SliderValueToTime(scrubSliderValue.value()));
+    scrubSliderValue.reset();
   }
 }
 
-void PlaybackPlugin::RequestStep(const ignition::msgs::Duration& _stepSize) {
-  if (!node.Request(kStepServiceName, _stepSize)) {
-    ignerr << "Failed to request a playback step." << std::endl;
+void PlaybackPlugin::SetIsRequestPending(bool _isRequestPending) {
+  if (isRequestPending == _isRequestPending) {
+    return;
   }
+  isRequestPending = _isRequestPending;
+  IsRequestPendingChanged();
 }
 
 }  // namespace gui
@@ -29,11 +29,29 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/gui/Plugin.hh>
 #include <ignition/gui/qt.h>
 #include <ignition/transport.hh>
 
+#include "frame_cache.hh"
+#include "step_pacer.hh"
+#include "visualizer/log_tools/log_index.hh"
+#include "visualizer/subscription_hub.hh"
+
 namespace ignition {
 namespace msgs {
 class PlaybackStatus;
@@ -46,6 +64,31 @@ namespace gui {
 /// @brief Implements a playback plugin.
 /// @details See PlaybackPlugin.qml to complete understand how the view is
 ///          connected to each QProperty.
+///          While the timeline slider is held, seeks are throttled to at most
+///          one every `<scrub_interval_ms>` milliseconds (100 by default, 10 at
+///          least), always targeting the latest slider position. A final seek
+///          to the exact position is sent when the slider is released.
+///          The plugin also keeps the last seconds of serialized messages of a
+///          set of topics in a FrameCache, so small steps backwards (and then
+///          forward again) are served locally by republishing the cached
+///          messages instead of asking the replayer to seek. Use:
+///          @code{.xml}
+///          <frame_cache>
+///            <seconds>5</seconds>                     <!-- 0 disables it -->
+///            <max_megabytes>64</max_megabytes>
+///            <topic>agents/state</topic>              <!-- default topics -->
+///            <topic>/visualizer/pose_update</topic>
+///          </frame_cache>
+///          @endcode
+///          When the visualizer is given the `--playback-log=<topic.db>` and
+///          `--playback-index=<index file>` arguments, a LogIndex of the log
+///          is opened, or built, in a background thread. The widget then draws
+///          the message density over the timeline and lets the user jump to
+///          the next or previous burst of messages.
+///          Playback rates other than real time are achieved by holding the
+///          replayer paused and stepping it from a StepPacer thread. The rate
+///          achieved is measured out of the replayer status and shown next to
+///          the requested one.
 class PlaybackPlugin : public ignition::gui::Plugin {
   Q_OBJECT
 
@@ -57,12 +100,20 @@ class PlaybackPlugin : public ignition::gui::Plugin {
 
   Q_PROPERTY(bool isSliderPressed READ IsSliderPressed WRITE SetIsSliderPressed NOTIFY IsSliderPressedChanged)
 
+  Q_PROPERTY(bool isRequestPending READ IsRequestPending NOTIFY IsRequestPendingChanged)
+
+  Q_PROPERTY(QString frameCacheStats READ FrameCacheStats NOTIFY FrameCacheStatsChanged)
+
+  Q_PROPERTY(QVariantList timelineDensity READ TimelineDensity NOTIFY TimelineDensityChanged)
+
+  Q_PROPERTY(QString playbackRateStats READ PlaybackRateStats NOTIFY PlaybackRateStatsChanged)
+
  public:
   /// Constructor
   PlaybackPlugin();
 
   /// Destructor
-  virtual ~PlaybackPlugin() = default;
+  virtual ~PlaybackPlugin();
 
   /// Called by Ignition GUI when plugin is instantiated.
   /// \param[in] _pluginElem XML configuration for this plugin.
@@ -76,6 +127,14 @@ class PlaybackPlugin : public ignition::gui::Plugin {
 
   Q_INVOKABLE bool IsSliderPressed() const;
 
+  Q_INVOKABLE bool IsRequestPending() const;
+
+  Q_INVOKABLE QString FrameCacheStats() const;
+
+  Q_INVOKABLE QVariantList TimelineDensity() const;
+
+  Q_INVOKABLE QString PlaybackRateStats() const;
+
   Q_INVOKABLE void SetSimTime(const QString& _simTime);
 
   Q_INVOKABLE void SetCurrentTime(const QString& _currentTime);
@@ -90,8 +149,21 @@ class PlaybackPlugin : public ignition::gui::Plugin {
   void CurrentTimeChanged();
   void SliderValueChanged();
   void IsSliderPressedChanged();
+  void IsRequestPendingChanged();
+  void FrameCacheStatsChanged();
+  void TimelineDensityChanged();
+  void PlaybackRateStatsChanged();
   /// @} Signals to notify that properties changed.
 
+  /// @brief Emitted from the indexing thread when it is done.
+  void LogIndexLoaded();
+
+  /// @brief Emitted from the transport thread when the replayer answers the
+  ///        request identified by @p _requestId.
+  /// @param _requestId The identifier of the answered request.
+  /// @param _result Whether the request succeeded.
+  void RequestCompleted(quint64 _requestId, bool _result);
+
  protected slots:
 
   // A slot to react to a rewind button push.
@@ -107,17 +179,90 @@ class PlaybackPlugin : public ignition::gui::Plugin {
   // @param[in] _stepValue Value to step.
   void OnStepButtonPush(const QString& _stepValue);
 
-  // A slot to react to a slider interaction.
+  // A slot to react to a step back button push.
+  // @param[in] _stepValue Value to step back.
+  void OnStepBackButtonPush(const QString& _stepValue);
+
+  // A slot to react to the slider being moved while held.
+  // @param[in] _sliderValue Value of the slider.
+  void OnSliderMoved(const QString& _sliderValue);
+
+  // A slot to react to the slider release.
   // @param[in] _sliderValue Value of the slider.
   // @return The value of the slider.
   QString OnSliderDrop(const QString& _sliderValue);
 
+  // A slot to react to a playback rate selection.
+  // @param[in] _rate Playback rate relative to real time, non positive to
+  //            play as fast as possible.
+  void OnRateSelected(double _rate);
+
+  // A slot to react to a next burst button push.
+  void OnNextBurstButtonPush();
+
+  // A slot to react to a previous burst button push.
+  void OnPreviousBurstButtonPush();
+
+  // A slot to take the index loaded by `logIndexThread`, in the GUI thread.
+  void OnLogIndexLoaded();
+
+  // A slot to react to a replayer answer, in the GUI thread.
+  // @param[in] _requestId The identifier of the answered request.
+  // @param[in] _result Whether the request succeeded.
+  void OnRequestCompleted(quint64 _requestId, bool _result);
+
+ protected:
+  // Timer event callback which handles the timeout of the request in flight,
+  // the view refresh and the throttling of the seeks while scrubbing.
+  void timerEvent(QTimerEvent* _event) override;
+
  private:
+  // Kinds of requests the replayer serves.
+  enum class RequestType { kPause, kResume, kStep, kSeek };
+
+  // A replayer request waiting to be sent.
+  struct PendingRequest {
+    RequestType type;
+    // The step size or the seek offset, ignored by pause and resume requests.
+    std::chrono::nanoseconds duration{0};
+  };
+
+  // Time to wait for the replayer answer before sending the next request.
+  static constexpr int kRequestTimeoutInMs{5000};
+
+  // Default minimum period between seeks while scrubbing.
+  static constexpr int kDefaultScrubIntervalInMs{100};
+
+  // Shortest period between seeks while scrubbing, shorter ones would flood
+  // the replayer with seeks.
+  static constexpr int kMinScrubIntervalInMs{10};
+
+  // Period of the view refresh with the latest playback status.
+  static constexpr int kDisplayPeriodInMs{33};
+
+  // Default span of playback time kept in the frame cache.
+  static constexpr int kDefaultFrameCacheSeconds{5};
+
+  // Default memory budget of the frame cache.
+  static constexpr int kDefaultFrameCacheMegabytes{64};
+
+  // Number of columns of the timeline density strip.
+  static constexpr int kTimelineColumns{200};
+
+  // Wall time between steps when playing at a rate other than real time.
+  static constexpr int kPacerPeriodInMs{50};
+
+  // Step size when playing as fast as possible.
+  static constexpr int kMaxRateStepInMs{200};
+
+  // Wall time span over which the achieved playback rate is measured.
+  static constexpr int kRateWindowInMs{1000};
+
   // Holds the start, current and end time of the simulation.
   struct SimTimes {
-    std::chrono::nanoseconds start_time;
-    std::chrono::nanoseconds end_time;
-    std::chrono::nanoseconds current_time;
+    std::chrono::nanoseconds start_time{0};
+    std::chrono::nanoseconds end_time{0};
+    std::chrono::nanoseconds current_time{0};
   };
 
   // Playback's ignition transport services and topics.
@@ -127,10 +272,55 @@ class PlaybackPlugin : public ignition::gui::Plugin {
   static constexpr const char* const kStepServiceName{"/replayer/step"};
   static constexpr const char* const kSeekServiceName{"/replayer/seek"};
 
+  // Topics kept in the frame cache when none is configured.
+  static constexpr const char* const kAgentsTopicName{"agents/state"};
+  static constexpr const char* const kPoseUpdateTopicName{"/visualizer/pose_update"};
+
   // Playback status topic subscription callback.
+  // @details It runs in a transport thread, so it only stores the times in
+  //          `receivedTimeStatus`. The view is updated from the GUI thread
+  //          by UpdateTimeStatus().
   // @param[in] _msg The playback status message received.
   void OnStatusMessage(const ignition::msgs::PlaybackStatus& _msg);
 
+  // Takes the latest received times, if any, and updates the view properties
+  // that changed. It must be called from the GUI thread.
+  void UpdateTimeStatus();
+
+  // Updates the view properties with `timeStatus`, or with the time of the
+  // frame served from the cache if any.
+  void RefreshTimeProperties();
+
+  // Raw subscription callback of the cached topics. It runs in a transport
+  // thread.
+  // @param[in] _msgData The serialized message.
+  // @param[in] _size Number of bytes in @p _msgData.
+  // @param[in] _info Meta-information about the message received.
+  void OnCachedTopicMessage(const char* _msgData, const size_t _size, const ignition::transport::MessageInfo& _info);
+
+  // Republishes the cached messages shown at @p _time.
+  // @param[in] _time The playback time to show.
+  // @return false, and nothing is published, when @p _time is not cached.
+  bool ServeFromCache(const std::chrono::nanoseconds& _time);
+
+  // Stops showing a frame served from the cache.
+  void LeaveCachedFrame();
+
+  // Updates the frame cache stats shown in the view.
+  void UpdateFrameCacheStats();
+
+  // Resumes the replayer at real time or hands it over to `stepPacer`,
+  // according to `isPlaying` and `playbackRate`.
+  void ApplyPlaybackRate();
+
+  // Asks the replayer to step by @p _stepSize, and calls @p _done with the
+  // answer. It runs in the `stepPacer` thread and does not block.
+  // @return Whether the step was sent.
+  bool SendPacedStep(const std::chrono::nanoseconds& _stepSize, const StepPacer::DoneCallback& _done);
+
+  // Samples the playback time and updates the rate stats shown in the view.
+  void UpdatePlaybackRateStats();
+
   // Issues a playback pause request.
   void RequestPause();
 
@@ -138,11 +328,27 @@ class PlaybackPlugin : public ignition::gui::Plugin {
   void RequestResume();
 
   // Issues a playback step request, using the given @p _stepSize.
-  void RequestStep(const ignition::msgs::Duration& _stepSize);
+  void RequestStep(const std::chrono::nanoseconds& _stepSize);
 
   // Issues a playback seek request, to the given @p _seekOffset
   // from playback start.
-  void RequestSeek(const ignition::msgs::Duration& _seekOffset);
+  void RequestSeek(const std::chrono::nanoseconds& _seekOffset);
+
+  // Queues @p _request and sends it when there is no other request in flight.
+  // Queued requests superseded by @p _request are dropped: a seek drops queued
+  // seeks and steps, a pause or a resume drops queued pauses and resumes, and
+  // consecutive steps are merged into a single one.
+  void EnqueueRequest(const PendingRequest& _request);
+
+  // Sends the oldest queued request, if any, without blocking.
+  void SendNextRequest();
+
+  // Converts the slider position @p _sliderValue, in the [0; 100] range, into
+  // an offset from the playback start.
+  std::chrono::nanoseconds SliderValueToTime(const QString& _sliderValue) const;
+
+  // Updates the request in flight state and notifies the view.
+  void SetIsRequestPending(bool _isRequestPending);
 
   /// \brief Holds sim time
   QString simTime;
@@ -152,11 +358,111 @@ class PlaybackPlugin : public ignition::gui::Plugin {
   QString sliderValue;
   /// \brief Holds the status of the slider
   bool isSliderPressed{false};
+  /// \brief Whether there is a request in flight.
+  bool isRequestPending{false};
+
+  // Requests waiting for the one in flight to be answered.
+  std::deque<PendingRequest> queuedRequests;
+
+  // Identifier of the last request sent.
+  quint64 lastRequestId{0};
+
+  // Triggers an event when the request in flight times out.
+  QBasicTimer requestTimer;
+
+  // Minimum period between seeks while scrubbing.
+  int scrubIntervalInMs{kDefaultScrubIntervalInMs};
+
+  // Triggers an event every `scrubIntervalInMs` while scrubbing.
+  QBasicTimer scrubTimer;
+
+  // Latest slider position not yet sent to the replayer.
+  std::optional<QString> scrubSliderValue;
+
+  // Triggers an event every `kDisplayPeriodInMs` to refresh the view.
+  QBasicTimer displayTimer;
 
   // An ignition transport node.
   ignition::transport::Node node;
 
+  // Times shown in the view, only accessed from the GUI thread.
   SimTimes timeStatus;
+
+  // Latest times received from the replayer, protected by `statusMutex`.
+  SimTimes receivedTimeStatus;
+
+  // Mutex to protect `receivedTimeStatus` between threads.
+  std::mutex statusMutex;
+
+  // Whether `receivedTimeStatus` holds times not yet shown in the view.
+  std::atomic<bool> hasNewTimeStatus{false};
+
+  // Latest playback time received, in nanoseconds. It is used to tag the
+  // cached messages from the transport threads.
+  std::atomic<int64_t> latestStatusTime{0};
+
+  // Topics whose messages are kept in the frame cache.
+  std::vector<std::string> frameCacheTopics;
+
+  // Recent messages of `frameCacheTopics`, nullptr when disabled.
+  std::unique_ptr<FrameCache> frameCache;
+
+  // Publishers used to republish the cached messages, indexed by topic.
+  std::map<std::string, ignition::transport::Node::Publisher> frameCachePublishers;
+
+  // Playback time of the frame served from the cache, if any.
+  std::optional<std::chrono::nanoseconds> cachedFrameTime;
+
+  // Whether a cached frame is being shown, so messages republished by this
+  // plugin are not cached again.
+  std::atomic<bool> isServingCachedFrame{false};
+
+  // Number of steps served from the cache.
+  uint64_t frameCacheHits{0};
+
+  // Number of steps that could not be served from the cache.
+  uint64_t frameCacheMisses{0};
+
+  /// \brief Holds the frame cache stats.
+  QString frameCacheStats;
+
+  // Opens or builds the log index without blocking the GUI thread.
+  std::thread logIndexThread;
+
+  // Stops `logIndexThread` building the index, set on destruction.
+  std::atomic<bool> stopLogIndex{false};
+
+  // Index loaded by `logIndexThread`, handed over in OnLogIndexLoaded().
+  std::unique_ptr<LogIndex> loadedLogIndex;
+
+  // Timeline index of the replayed log, nullptr when not available.
+  std::unique_ptr<LogIndex> logIndex;
+
+  /// \brief Holds the message density of each timeline column, in [0; 1].
+  QVariantList timelineDensity;
+
+  // Whether the user asked to play, as opposed to pause.
+  bool isPlaying{true};
+
+  // Requested playback rate, non positive to play as fast as possible.
+  double playbackRate{1.};
+
+  // Playback times sampled along the last `kRateWindowInMs`.
+  std::deque<std::pair<std::chrono::steady_clock::time_point, std::chrono::nanoseconds>> rateSamples;
+
+  /// \brief Holds the requested and achieved playback rates.
+  QString playbackRateStats;
+
+  // An ignition transport node only used from the `stepPacer` thread.
+  ignition::transport::Node pacerNode;
+
+  // Subscriptions to the `frameCache` topics, shared with the other plugins.
+  // They are destroyed before the members their callbacks use.
+  std::vector<std::unique_ptr<SubscriptionHub::Subscription>> frameCacheSubscriptions;
+
+  // Steps the replayer at rates other than real time. It is declared last so
+  // its thread stops before the members it uses are destroyed.
+  StepPacer stepPacer;
 };
 
 }  // namespace gui
@@ -0,0 +1,123 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "step_pacer.hh"
+
+#include <utility>
+
+#include <ignition/common/Console.hh>
+
+namespace delphyne {
+namespace gui {
+
+StepPacer::StepPacer(StepFunction _step, const std::chrono::milliseconds& _period,
+                     const std::chrono::nanoseconds& _maxRateStep, const std::chrono::milliseconds& _stepTimeout)
+    : step(std::move(_step)), period(_period), maxRateStep(_maxRateStep), stepTimeout(_stepTimeout) {}
+
+StepPacer::~StepPacer() { Stop(); }
+
+void StepPacer::Start(double _rate) {
+  Stop();
+  // A fresh state, so answers to the steps of a previous run are ignored.
+  state = std::make_shared<State>();
+  isRunning = true;
+  thread = std::thread(&StepPacer::Run, this, _rate);
+}
+
+void StepPacer::Stop() {
+  if (!thread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->stopRequested = true;
+  }
+  state->condition.notify_all();
+  // The thread only waits on `state->condition`, so it exits right away.
+  thread.join();
+  isRunning = false;
+}
+
+bool StepPacer::IsRunning() const { return isRunning; }
+
+void StepPacer::Run(double _rate) {
+  const bool isMaxRate = _rate <= 0.;
+  const std::chrono::nanoseconds stepSize =
+      isMaxRate ? maxRateStep
+                : std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double, std::nano>(_rate * std::chrono::nanoseconds(period).count()));
+  const std::shared_ptr<State> runState = state;
+  const std::weak_ptr<State> weakState = runState;
+  auto nextStep = std::chrono::steady_clock::now();
+  for (uint64_t stepId = 1;; ++stepId) {
+    const DoneCallback done = [weakState, stepId](bool _result) {
+      if (const std::shared_ptr<State> doneState = weakState.lock()) {
+        {
+          std::lock_guard<std::mutex> lock(doneState->mutex);
+          doneState->doneStep = stepId;
+          doneState->doneResult = _result;
+        }
+        doneState->condition.notify_all();
+      }
+    };
+    if (!step(stepSize, done)) {
+      ignerr << "Unable to send a playback step, stopping the paced playback." << std::endl;
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(runState->mutex);
+    if (!runState->condition.wait_for(lock, stepTimeout, [&runState, stepId]() {
+          return runState->stopRequested || runState->doneStep == stepId;
+        })) {
+      ignerr << "Playback step timed out, stopping the paced playback." << std::endl;
+      break;
+    }
+    if (runState->stopRequested) {
+      break;
+    }
+    if (!runState->doneResult) {
+      ignerr << "Playback step failed, stopping the paced playback." << std::endl;
+      break;
+    }
+    // Late steps are not made up for.
+    const auto now = std::chrono::steady_clock::now();
+    nextStep += period;
+    if (isMaxRate || nextStep < now) {
+      nextStep = now;
+    }
+    if (runState->condition.wait_until(lock, nextStep, [&runState]() { return runState->stopRequested; })) {
+      break;
+    }
+  }
+  isRunning = false;
+}
+
+}  // namespace gui
+}  // namespace delphyne
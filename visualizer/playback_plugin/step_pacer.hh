@@ -0,0 +1,133 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Plays back at a given rate by stepping the replayer from a
+///        dedicated thread.
+/// @details Every `period` of wall time the pacer steps the playback by
+///          `rate * period`. Steps are asynchronous requests, and the next
+///          step waits for the previous one to be done, so a slow replayer
+///          delays the next step instead of piling requests up; a late step
+///          does not make the following ones catch up, the achieved rate just
+///          drops. A non positive rate steps back to back by `maxRateStep`,
+///          as fast as the replayer answers.
+///
+///          The pacer thread only ever waits on a condition, never on the
+///          replayer, so Stop() returns right away even while a step is in
+///          flight. Answers to steps sent before a stop are ignored.
+class StepPacer {
+ public:
+  /// @brief Called, from any thread, with whether a step succeeded.
+  using DoneCallback = std::function<void(bool)>;
+
+  /// @brief Sends a step of the given size without waiting for it, and calls
+  ///        the callback once it is done. It returns false when the step
+  ///        could not be sent.
+  using StepFunction = std::function<bool(const std::chrono::nanoseconds&, const DoneCallback&)>;
+
+  /// @brief Constructs a stopped pacer.
+  /// @param _step Function called from the pacer thread to step the playback.
+  /// @param _period Wall time between steps.
+  /// @param _maxRateStep Step size when running as fast as possible.
+  /// @param _stepTimeout Time after which an unanswered step stops the pacer.
+  StepPacer(StepFunction _step, const std::chrono::milliseconds& _period,
+            const std::chrono::nanoseconds& _maxRateStep, const std::chrono::milliseconds& _stepTimeout);
+
+  /// @brief Stops the pacer.
+  ~StepPacer();
+
+  /// @brief Starts stepping at @p _rate times the real time, or restarts
+  ///        with the new rate when already running.
+  /// @param _rate Playback rate, non positive to run as fast as possible.
+  void Start(double _rate);
+
+  /// @brief Stops stepping. It does not wait for the step in progress, if
+  ///        any.
+  void Stop();
+
+  /// @return Whether the pacer is stepping the playback. It is false once the
+  ///         pacer stopped by itself after a failed or timed out step.
+  bool IsRunning() const;
+
+ private:
+  // Body of the pacer thread.
+  void Run(double _rate);
+
+  // Steps the playback.
+  const StepFunction step;
+
+  // Wall time between steps.
+  const std::chrono::milliseconds period;
+
+  // Step size when running as fast as possible.
+  const std::chrono::nanoseconds maxRateStep;
+
+  // Time after which an unanswered step stops the pacer.
+  const std::chrono::milliseconds stepTimeout;
+
+  // State shared with the step callbacks, which may outlive the pacer.
+  struct State {
+    // Protects the members below.
+    std::mutex mutex;
+
+    // Wakes the pacer thread up when a stop is requested or a step is done.
+    std::condition_variable condition;
+
+    // Whether the pacer thread must stop.
+    bool stopRequested{false};
+
+    // Id and result of the last step done.
+    uint64_t doneStep{0};
+    bool doneResult{false};
+  };
+  std::shared_ptr<State> state;
+
+  // The pacer thread.
+  std::thread thread;
+
+  // Whether the pacer thread is stepping the playback.
+  std::atomic<bool> isRunning{false};
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,157 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "plugin_metrics.hh"
+
+#include <algorithm>
+#include <fstream>
+
+#include <ignition/common/Console.hh>
+
+namespace delphyne {
+namespace gui {
+
+void PluginMetrics::CounterHandle::Record(const Clock::duration& _latency, size_t _bytes) const {
+  if (!PluginMetrics::Instance()->IsEnabled()) {
+    return;
+  }
+  const Clock::rep latency = _latency.count();
+  const uint64_t index = slot->count.fetch_add(1, std::memory_order_relaxed);
+  slot->bytes.fetch_add(_bytes, std::memory_order_relaxed);
+  slot->totalLatency.fetch_add(latency, std::memory_order_relaxed);
+  Clock::rep maxLatency = slot->maxLatency.load(std::memory_order_relaxed);
+  while (latency > maxLatency &&
+         !slot->maxLatency.compare_exchange_weak(maxLatency, latency, std::memory_order_relaxed)) {
+  }
+  slot->recentLatencies[index % kRecentSamples].store(latency, std::memory_order_relaxed);
+}
+
+PluginMetrics::Scope::Scope(const CounterHandle& _counter, size_t _bytes)
+    : counter(_counter), bytes(_bytes), enabled(PluginMetrics::Instance()->IsEnabled()) {
+  if (enabled) {
+    start = Clock::now();
+  }
+}
+
+PluginMetrics::Scope::~Scope() {
+  if (enabled) {
+    counter.Record(Clock::now() - start, bytes);
+  }
+}
+
+PluginMetrics* PluginMetrics::Instance() {
+  static PluginMetrics instance;
+  return &instance;
+}
+
+void PluginMetrics::Enable() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!enabled) {
+    runStart = Clock::now();
+    enabled = true;
+  }
+}
+
+PluginMetrics::CounterHandle PluginMetrics::Register(const std::string& _plugin, const std::string& _counter) {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<Slot>& slot = slots[std::make_pair(_plugin, _counter)];
+  if (slot == nullptr) {
+    slot = std::make_unique<Slot>();
+  }
+  return CounterHandle(slot.get());
+}
+
+std::map<std::pair<std::string, std::string>, PluginMetrics::Counter> PluginMetrics::Snapshot() const {
+  std::map<std::pair<std::string, std::string>, Counter> counters;
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto& entry : slots) {
+    const Slot& slot = *entry.second;
+    Counter counter;
+    counter.count = slot.count.load(std::memory_order_relaxed);
+    if (counter.count == 0) {
+      continue;
+    }
+    counter.bytes = slot.bytes.load(std::memory_order_relaxed);
+    counter.totalLatency = Clock::duration(slot.totalLatency.load(std::memory_order_relaxed));
+    counter.maxLatency = Clock::duration(slot.maxLatency.load(std::memory_order_relaxed));
+    const size_t recent = static_cast<size_t>(std::min<uint64_t>(counter.count, kRecentSamples));
+    counter.recentLatencies.reserve(recent);
+    for (size_t i = 0; i < recent; ++i) {
+      counter.recentLatencies.push_back(Clock::duration(slot.recentLatencies[i].load(std::memory_order_relaxed)));
+    }
+    counter.nextRecent = counter.count % kRecentSamples;
+    counters.emplace(entry.first, std::move(counter));
+  }
+  return counters;
+}
+
+PluginMetrics::Clock::duration PluginMetrics::Percentile(const Counter& _counter, double _percentile) {
+  if (_counter.recentLatencies.empty()) {
+    return Clock::duration::zero();
+  }
+  std::vector<Clock::duration> latencies = _counter.recentLatencies;
+  const size_t index =
+      std::min(latencies.size() - 1, static_cast<size_t>(std::clamp(_percentile, 0., 1.) * latencies.size()));
+  std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+  return latencies[index];
+}
+
+void PluginMetrics::WriteReport(std::ostream& _out) const {
+  Clock::time_point start;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    start = runStart;
+  }
+  const double runSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+  _out << "plugin,counter,count,rate_hz,bytes,mean_latency_us,p50_latency_us,p95_latency_us,max_latency_us\n";
+  for (const auto& entry : Snapshot()) {
+    const Counter& counter = entry.second;
+    const double totalUs = std::chrono::duration<double, std::micro>(counter.totalLatency).count();
+    const double p50Us = std::chrono::duration<double, std::micro>(Percentile(counter, 0.5)).count();
+    const double p95Us = std::chrono::duration<double, std::micro>(Percentile(counter, 0.95)).count();
+    const double maxUs = std::chrono::duration<double, std::micro>(counter.maxLatency).count();
+    _out << entry.first.first << "," << entry.first.second << "," << counter.count << ","
+         << (runSeconds > 0. ? counter.count / runSeconds : 0.) << "," << counter.bytes << ","
+         << (counter.count > 0 ? totalUs / counter.count : 0.) << "," << p50Us << "," << p95Us << "," << maxUs << "\n";
+  }
+}
+
+bool PluginMetrics::WriteReport(const std::string& _path) const {
+  std::ofstream file(_path, std::ios::trunc);
+  if (!file) {
+    ignerr << "Unable to write plugin metrics to [" << _path << "]" << std::endl;
+    return false;
+  }
+  WriteReport(file);
+  return static_cast<bool>(file);
+}
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,194 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// \brief Process wide throughput and latency counters of the visualizer
+///        plugins.
+///
+/// \details Plugins record how long each handled event took, e.g. a transport
+///          callback or a control tick, under a (plugin, counter) pair.
+///          Counters are registered once, e.g. at namespace scope, and then
+///          recorded through their handle with a few relaxed atomic
+///          operations and no lock, from any thread:
+///          @code{.cpp}
+///          const PluginMetrics::CounterHandle kRenderMetrics =
+///              PluginMetrics::Instance()->Register("MyPlugin", "render");
+///          ...
+///          const PluginMetrics::Scope metrics(kRenderMetrics);
+///          @endcode
+///          Recording is disabled by default, so that instrumented code costs
+///          a single atomic load outside of headless and performance runs.
+class PluginMetrics {
+ private:
+  struct Slot;
+
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief Aggregated samples of a single counter.
+  struct Counter {
+    /// Number of recorded events.
+    uint64_t count{0};
+    /// Total payload of the recorded events, in bytes.
+    uint64_t bytes{0};
+    /// Accumulated handling time of the recorded events.
+    Clock::duration totalLatency{Clock::duration::zero()};
+    /// Longest handling time of a single event.
+    Clock::duration maxLatency{Clock::duration::zero()};
+    /// Handling times of the last kRecentSamples events, as a ring.
+    std::vector<Clock::duration> recentLatencies;
+    /// Next position to write in recentLatencies once it is full.
+    size_t nextRecent{0};
+  };
+
+  /// Number of latest events kept per counter to compute percentiles.
+  static constexpr size_t kRecentSamples{512};
+
+  /// \brief Handle of a registered counter.
+  class CounterHandle {
+   public:
+    /// \brief Records an event, unless metrics are disabled.
+    /// \param[in] _latency The time spent handling the event.
+    /// \param[in] _bytes Payload of the event, in bytes.
+    void Record(const Clock::duration& _latency, size_t _bytes = 0) const;
+
+   private:
+    friend class PluginMetrics;
+
+    explicit CounterHandle(Slot* _slot) : slot(_slot) {}
+
+    Slot* slot{nullptr};
+  };
+
+  /// \brief Records the time from its construction to its destruction as an
+  ///        event of a counter.
+  /// \details Nothing is recorded when metrics are disabled at construction.
+  class Scope {
+   public:
+    /// \param[in] _counter The counter.
+    /// \param[in] _bytes Payload of the event, in bytes.
+    explicit Scope(const CounterHandle& _counter, size_t _bytes = 0);
+
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const CounterHandle counter;
+    size_t bytes{0};
+    bool enabled{false};
+    Clock::time_point start;
+  };
+
+  /// \return The process wide instance.
+  static PluginMetrics* Instance();
+
+  /// \brief Enables recording and starts the run clock, if it was not
+  ///        enabled yet.
+  void Enable();
+
+  /// \return true when recording is enabled.
+  bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+  /// \brief Registers a counter, or finds it when already registered.
+  /// \param[in] _plugin The plugin name.
+  /// \param[in] _counter The counter name.
+  /// \return The counter handle, valid for the whole process.
+  CounterHandle Register(const std::string& _plugin, const std::string& _counter);
+
+  /// \return A copy of the counters with recorded events, keyed by (plugin,
+  ///         counter). Counters being recorded meanwhile may be a few events
+  ///         apart between their fields.
+  std::map<std::pair<std::string, std::string>, Counter> Snapshot() const;
+
+  /// \brief Computes a percentile of the latest handling times of a counter.
+  /// \param[in] _counter The counter.
+  /// \param[in] _percentile The percentile, in the [0, 1] range.
+  /// \return The percentile, or zero when the counter has no events.
+  static Clock::duration Percentile(const Counter& _counter, double _percentile);
+
+  /// \brief Writes all counters as CSV, one row per counter with its count,
+  ///        rate, bytes and mean, median, 95th percentile and max latencies.
+  /// \param[out] _out The stream to write into.
+  void WriteReport(std::ostream& _out) const;
+
+  /// \brief Writes all counters as CSV into @p _path.
+  /// \param[in] _path The report file.
+  /// \return false when the file cannot be written.
+  bool WriteReport(const std::string& _path) const;
+
+ private:
+  PluginMetrics() = default;
+
+  // Whether recording is enabled.
+  std::atomic<bool> enabled{false};
+
+  // A registered counter, recorded without locking.
+  struct Slot {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<Clock::rep> totalLatency{0};
+    std::atomic<Clock::rep> maxLatency{0};
+    // Handling times of the last kRecentSamples events, event i is at
+    // i % kRecentSamples.
+    std::array<std::atomic<Clock::rep>, kRecentSamples> recentLatencies{};
+  };
+
+  // Protects slots and runStart.
+  mutable std::mutex mutex;
+
+  // Registered counters, keyed by (plugin, counter). Slots are never removed,
+  // so handles stay valid.
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<Slot>> slots;
+
+  // When recording was enabled, rates are computed from it.
+  Clock::time_point runStart;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,123 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls 1.4
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: profiler
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 450
+  Layout.minimumHeight: 250
+
+  // Frame time percentiles.
+  Text {
+    id: frameStats
+    anchors.left: parent.left
+    anchors.leftMargin: 5
+    height: 30
+    verticalAlignment: Text.AlignVCenter
+    font.family: "Helvetica"
+    font.pixelSize: 12
+    text: ProfilerPlugin.frameStats
+  }
+
+  // Per plugin breakdown.
+  TableView {
+    id: tableView
+    anchors.top: frameStats.bottom
+    anchors.left: parent.left
+    width: parent.width
+    height: parent.height - frameStats.height
+    TableViewColumn {
+        role: "plugin"
+        title: "Plugin"
+    }
+    TableViewColumn {
+        role: "counter"
+        title: "Counter"
+    }
+    TableViewColumn {
+        role: "rate"
+        title: "Rate"
+    }
+    TableViewColumn {
+        role: "load"
+        title: "Load"
+    }
+    TableViewColumn {
+        role: "p50"
+        title: "p50 (ms)"
+    }
+    TableViewColumn {
+        role: "p95"
+        title: "p95 (ms)"
+    }
+    TableViewColumn {
+        role: "p99"
+        title: "p99 (ms)"
+    }
+    model: ListModel {
+      id: tableModel
+    }
+
+    itemDelegate: Item {
+      Text {
+          anchors.verticalCenter: parent.verticalCenter
+          color: styleData.textColor
+          elide: styleData.elideMode
+          font.family: "Helvetica"
+          font.pixelSize: 12
+          text: styleData.value
+      }
+    }
+  }
+
+  // The table is refreshed with each breakdown.
+  Connections {
+      target: ProfilerPlugin
+      onBreakdownChanged: {
+        tableModel.clear()
+        for (var i = 0; i < ProfilerPlugin.breakdown.length; i = i + 7)  {
+          tableModel.append({"plugin": ProfilerPlugin.breakdown[i],
+                             "counter": ProfilerPlugin.breakdown[i+1],
+                             "rate": ProfilerPlugin.breakdown[i+2],
+                             "load": ProfilerPlugin.breakdown[i+3],
+                             "p50": ProfilerPlugin.breakdown[i+4],
+                             "p95": ProfilerPlugin.breakdown[i+5],
+                             "p99": ProfilerPlugin.breakdown[i+6]})
+        }
+      }
+  }
+}
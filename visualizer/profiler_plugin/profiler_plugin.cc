@@ -0,0 +1,172 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "profiler_plugin.hh"
+
+#include <iomanip>
+#include <sstream>
+
+#include <ignition/common/Console.hh>
+#include <ignition/gui/Application.hh>
+#include <ignition/gui/GuiEvents.hh>
+#include <ignition/gui/MainWindow.hh>
+#include <ignition/msgs/param_v.pb.h>
+#include <ignition/plugin/Register.hh>
+
+#include "visualizer/plugin_metrics.hh"
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// \brief Converts @p _duration to milliseconds.
+double ToMs(const std::chrono::steady_clock::duration& _duration) {
+  return std::chrono::duration<double, std::milli>(_duration).count();
+}
+
+// \brief Converts @p _value into an string with @p _precision decimal places.
+QString ToQString(double _value, int _precision) {
+  std::stringstream sstr;
+  sstr << std::fixed << std::setprecision(_precision) << _value;
+  return QString::fromStdString(sstr.str());
+}
+
+// \brief Adds a double parameter named @p _key to @p _param.
+void SetParam(const std::string& _key, double _value, ignition::msgs::Param* _param) {
+  ignition::msgs::Any& any = (*_param->mutable_params())[_key];
+  any.set_type(ignition::msgs::Any::DOUBLE);
+  any.set_double_value(_value);
+}
+
+// \brief Adds a string parameter named @p _key to @p _param.
+void SetParam(const std::string& _key, const std::string& _value, ignition::msgs::Param* _param) {
+  ignition::msgs::Any& any = (*_param->mutable_params())[_key];
+  any.set_type(ignition::msgs::Any::STRING);
+  any.set_string_value(_value);
+}
+
+}  // namespace
+
+ProfilerPlugin::ProfilerPlugin() : Plugin() {}
+
+void ProfilerPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
+  if (title.empty()) {
+    title = "Profiler";
+  }
+
+  std::string topic{kDefaultStatsTopic};
+  if (_pluginElem) {
+    auto elem = _pluginElem->FirstChildElement("topic");
+    if (elem && elem->GetText()) {
+      topic = elem->GetText();
+    }
+  }
+  publisher = node.Advertise<ignition::msgs::Param_V>(topic);
+  if (!publisher) {
+    ignerr << "Error advertising topic [" << topic << "]" << std::endl;
+  }
+
+  PluginMetrics::Instance()->Enable();
+  ignition::gui::App()->findChild<ignition::gui::MainWindow*>()->installEventFilter(this);
+  previousUpdate = Clock::now();
+  timer.start(kTimerPeriodInMs, this);
+}
+
+bool ProfilerPlugin::eventFilter(QObject* _obj, QEvent* _event) {
+  if (_event->type() == ignition::gui::events::Render::kType) {
+    const auto now = Clock::now();
+    if (hasPreviousRender) {
+      frameMetrics.Record(now - previousRender);
+    }
+    previousRender = now;
+    hasPreviousRender = true;
+  }
+
+  // Standard event processing
+  return QObject::eventFilter(_obj, _event);
+}
+
+void ProfilerPlugin::timerEvent(QTimerEvent* _event) {
+  if (_event->timerId() != timer.timerId()) {
+    return;
+  }
+
+  const auto now = Clock::now();
+  const double periodSec = std::chrono::duration<double>(now - previousUpdate).count();
+  previousUpdate = now;
+
+  ignition::msgs::Param_V msg;
+  breakdown.clear();
+  for (const auto& entry : PluginMetrics::Instance()->Snapshot()) {
+    const PluginMetrics::Counter& counter = entry.second;
+    Totals& previous = previousTotals[entry.first];
+    const uint64_t count = counter.count - previous.count;
+    const Clock::duration busy = counter.totalLatency - previous.totalLatency;
+    previous = Totals{counter.count, counter.totalLatency};
+
+    const double rate = periodSec > 0. ? count / periodSec : 0.;
+    const double p50 = ToMs(PluginMetrics::Percentile(counter, 0.5));
+    const double p95 = ToMs(PluginMetrics::Percentile(counter, 0.95));
+    const double p99 = ToMs(PluginMetrics::Percentile(counter, 0.99));
+    if (entry.first.first == kFramePlugin) {
+      frameStats = QString("Frame time p50 %1 ms, p95 %2 ms, p99 %3 ms (%4 fps)")
+                       .arg(ToQString(p50, 1), ToQString(p95, 1), ToQString(p99, 1), ToQString(rate, 0));
+    } else {
+      // Load is the fraction of wall time spent handling the counter events.
+      const double load = periodSec > 0. ? 100. * ToMs(busy) / (1000. * periodSec) : 0.;
+      breakdown << QString::fromStdString(entry.first.first) << QString::fromStdString(entry.first.second)
+                << ToQString(rate, 0) + " Hz" << ToQString(load, 1) + " %" << ToQString(p50, 2)
+                << ToQString(p95, 2) << ToQString(p99, 2);
+    }
+
+    ignition::msgs::Param* param = msg.add_param();
+    SetParam("plugin", entry.first.first, param);
+    SetParam("counter", entry.first.second, param);
+    SetParam("count", static_cast<double>(counter.count), param);
+    SetParam("rate_hz", rate, param);
+    SetParam("busy_ms", ToMs(busy), param);
+    SetParam("p50_ms", p50, param);
+    SetParam("p95_ms", p95, param);
+    SetParam("p99_ms", p99, param);
+    SetParam("max_ms", ToMs(counter.maxLatency), param);
+  }
+  BreakdownChanged();
+  FrameStatsChanged();
+
+  if (publisher) {
+    publisher.Publish(msg);
+  }
+}
+
+}  // namespace gui
+}  // namespace delphyne
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(delphyne::gui::ProfilerPlugin, ignition::gui::Plugin)
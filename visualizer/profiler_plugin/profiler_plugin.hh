@@ -0,0 +1,142 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <ignition/gui/Plugin.hh>
+#include <ignition/transport/Node.hh>
+
+#include "visualizer/plugin_metrics.hh"
+
+namespace delphyne {
+namespace gui {
+
+/// \brief Shows where the visualizer spends its time, per plugin.
+///
+/// \details Enables the PluginMetrics counters and, every second, shows the
+///          rate, load and latency percentiles of each counter recorded by
+///          the plugins, e.g. the work AgentInfoDisplay and OriginDisplay do
+///          on ignition::gui::events::Render or the plugins timer slots. The
+///          time between Render events is shown as the frame time.
+///          The same breakdown is published as an ignition::msgs::Param_V,
+///          one Param per counter, so headless runs can collect it.
+///
+///          Optional configuration:
+///          <topic>/visualizer/stats</topic>  Topic to publish the breakdown.
+class ProfilerPlugin : public ignition::gui::Plugin {
+  Q_OBJECT
+
+  Q_PROPERTY(QStringList breakdown READ Breakdown NOTIFY BreakdownChanged)
+
+  Q_PROPERTY(QString frameStats READ FrameStats NOTIFY FrameStatsChanged)
+
+ public:
+  /// \brief Constructor.
+  ProfilerPlugin();
+
+  // Documentation inherited
+  void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
+
+  /// \brief Breakdown of the last period. The list is made of blocks of
+  ///        [`plugin`, `counter`, `rate`, `load`, `p50`, `p95`, `p99`], see
+  ///        ProfilerPlugin.qml.
+  Q_INVOKABLE QStringList Breakdown() const { return breakdown; }
+
+  /// \brief Frame time percentiles of the latest frames.
+  Q_INVOKABLE QString FrameStats() const { return frameStats; }
+
+ signals:
+  /// Signals to notify that the properties have changed.
+  void BreakdownChanged();
+  void FrameStatsChanged();
+
+ protected:
+  /// \brief Updates and publishes the breakdown.
+  void timerEvent(QTimerEvent* _event) override;
+
+  /// \brief Filters ignition::gui::events::Render events to measure the frame
+  ///        time.
+  bool eventFilter(QObject* _obj, QEvent* _event) override;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief Breakdown period.
+  static constexpr int kTimerPeriodInMs{1000};
+
+  /// \brief Default topic to publish the breakdown.
+  static constexpr char kDefaultStatsTopic[]{"/visualizer/stats"};
+
+  /// \brief Plugin and counter names of the frame time.
+  static constexpr char kFramePlugin[]{"Frame"};
+  static constexpr char kFrameCounter[]{"interval"};
+
+  /// \brief Counter of the frame time.
+  const PluginMetrics::CounterHandle frameMetrics{PluginMetrics::Instance()->Register(kFramePlugin, kFrameCounter)};
+
+  /// \brief Totals of a counter at the previous update.
+  struct Totals {
+    uint64_t count{0};
+    Clock::duration totalLatency{Clock::duration::zero()};
+  };
+
+  /// \brief Triggers an event every `kTimerPeriodInMs`.
+  QBasicTimer timer;
+
+  /// \brief Totals at the previous update, keyed by (plugin, counter).
+  std::map<std::pair<std::string, std::string>, Totals> previousTotals;
+
+  /// \brief Time of the previous update.
+  Clock::time_point previousUpdate;
+
+  /// \brief Time of the previous Render event, if any.
+  Clock::time_point previousRender;
+  bool hasPreviousRender{false};
+
+  /// \brief See Breakdown().
+  QStringList breakdown;
+
+  /// \brief See FrameStats().
+  QString frameStats{"No frames"};
+
+  /// \brief Transport node to publish the breakdown.
+  ignition::transport::Node node;
+
+  /// \brief Publisher of the breakdown.
+  ignition::transport::Node::Publisher publisher;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,160 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls 1.4
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: recorder
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 450
+  Layout.minimumHeight: 250
+
+  // Topics and file to record.
+  GridLayout {
+    id: settings
+    anchors.left: parent.left
+    anchors.right: parent.right
+    anchors.margins: 5
+    columns: 3
+
+    Text {
+      text: "Topics"
+      font.family: "Helvetica"
+      font.pixelSize: 12
+    }
+    TextField {
+      id: topicsField
+      Layout.fillWidth: true
+      enabled: !RecorderPlugin.recording
+      placeholderText: "/scene, /agents/state"
+      text: RecorderPlugin.topics
+      onEditingFinished: RecorderPlugin.topics = text
+    }
+    Button {
+      id: recordButton
+      text: RecorderPlugin.recording ? "Stop" : "Record"
+      onClicked: {
+        if (RecorderPlugin.recording) {
+          RecorderPlugin.Stop()
+        } else {
+          RecorderPlugin.topics = topicsField.text
+          RecorderPlugin.path = pathField.text
+          RecorderPlugin.Start()
+        }
+      }
+    }
+
+    Text {
+      text: "File"
+      font.family: "Helvetica"
+      font.pixelSize: 12
+    }
+    TextField {
+      id: pathField
+      Layout.fillWidth: true
+      Layout.columnSpan: 2
+      enabled: !RecorderPlugin.recording
+      placeholderText: "recording_<time>.drec"
+      text: RecorderPlugin.path
+      onEditingFinished: RecorderPlugin.path = text
+    }
+  }
+
+  // Recording summary.
+  Text {
+    id: status
+    anchors.top: settings.bottom
+    anchors.left: parent.left
+    anchors.leftMargin: 5
+    height: 30
+    verticalAlignment: Text.AlignVCenter
+    font.family: "Helvetica"
+    font.pixelSize: 12
+    text: RecorderPlugin.status
+  }
+
+  // Per topic statistics.
+  TableView {
+    id: tableView
+    anchors.top: status.bottom
+    anchors.left: parent.left
+    anchors.bottom: parent.bottom
+    width: parent.width
+    TableViewColumn {
+        role: "topic"
+        title: "Topic"
+    }
+    TableViewColumn {
+        role: "messages"
+        title: "Messages"
+    }
+    TableViewColumn {
+        role: "size"
+        title: "Size"
+    }
+    TableViewColumn {
+        role: "dropped"
+        title: "Dropped"
+    }
+    model: ListModel {
+      id: tableModel
+    }
+
+    itemDelegate: Item {
+      Text {
+          anchors.verticalCenter: parent.verticalCenter
+          color: styleData.textColor
+          elide: styleData.elideMode
+          font.family: "Helvetica"
+          font.pixelSize: 12
+          text: styleData.value
+      }
+    }
+  }
+
+  // The table is refreshed with each statistics update.
+  Connections {
+      target: RecorderPlugin
+      onTopicStatsChanged: {
+        tableModel.clear()
+        for (var i = 0; i < RecorderPlugin.topicStats.length; i = i + 4)  {
+          tableModel.append({"topic": RecorderPlugin.topicStats[i],
+                             "messages": RecorderPlugin.topicStats[i+1],
+                             "size": RecorderPlugin.topicStats[i+2],
+                             "dropped": RecorderPlugin.topicStats[i+3]})
+        }
+      }
+  }
+}
@@ -0,0 +1,358 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "raw_recorder.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <ignition/common/Console.hh>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Appends @p _value to @p _buffer, little endian.
+template <typename T>
+void Append(T _value, std::string* _buffer) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    _buffer->push_back(static_cast<char>((static_cast<uint64_t>(_value) >> (8 * i)) & 0xFF));
+  }
+}
+
+// Appends @p _str prefixed by its uint16 size to @p _buffer. Strings longer
+// than the size can tell are truncated.
+void AppendString(const std::string& _str, std::string* _buffer) {
+  const uint16_t size = static_cast<uint16_t>(std::min<size_t>(_str.size(), std::numeric_limits<uint16_t>::max()));
+  Append(size, _buffer);
+  _buffer->append(_str, 0, size);
+}
+
+// Reads a little endian T from @p _buffer at @p _offset, advancing it.
+// @returns False when @p _buffer is too short.
+template <typename T>
+bool Extract(const std::string& _buffer, size_t* _offset, T* _value) {
+  if (_buffer.size() < *_offset + sizeof(T)) {
+    return false;
+  }
+  uint64_t value{0};
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(_buffer[*_offset + i])) << (8 * i);
+  }
+  *_value = static_cast<T>(value);
+  *_offset += sizeof(T);
+  return true;
+}
+
+// Reads @p _size bytes from @p _buffer at @p _offset, advancing it.
+// @returns False when @p _buffer is too short.
+bool ExtractBytes(const std::string& _buffer, size_t _size, size_t* _offset, std::string* _value) {
+  if (_buffer.size() < *_offset + _size) {
+    return false;
+  }
+  _value->assign(_buffer, *_offset, _size);
+  *_offset += _size;
+  return true;
+}
+
+// Reads a uint16 size prefixed string from @p _buffer at @p _offset.
+bool ExtractString(const std::string& _buffer, size_t* _offset, std::string* _value) {
+  uint16_t size{0};
+  return Extract(_buffer, _offset, &size) && ExtractBytes(_buffer, size, _offset, _value);
+}
+
+// @returns @p _time in ns since epoch.
+int64_t ToNs(const RawRecorder::Clock::time_point& _time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(_time.time_since_epoch()).count();
+}
+
+}  // namespace
+
+RawRecorder::RawRecorder(const std::string& _path, const std::vector<std::string>& _topics, size_t _queueSize) {
+  if (_topics.empty() || _topics.size() > std::numeric_limits<uint16_t>::max()) {
+    throw std::runtime_error("Invalid number of topics to record: " + std::to_string(_topics.size()));
+  }
+  if (_queueSize == 0) {
+    throw std::runtime_error("Recorder queues must hold at least one message.");
+  }
+  file.open(_path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Unable to open [" + _path + "] for recording.");
+  }
+  file.write(kMagic, sizeof(kMagic) - 1);
+  fileSize = sizeof(kMagic) - 1;
+
+  for (const std::string& name : _topics) {
+    topics.push_back(std::make_unique<Topic>(_queueSize));
+    topics.back()->name = name;
+  }
+  writer = std::thread(&RawRecorder::WriterLoop, this);
+}
+
+RawRecorder::~RawRecorder() { Close(); }
+
+void RawRecorder::Close() {
+  if (!writer.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopRequested = true;
+  }
+  stopCondition.notify_one();
+  writer.join();
+  closed = true;
+}
+
+void RawRecorder::Push(size_t _topicIndex, const std::string& _msgType,
+                       const std::shared_ptr<const std::string>& _data) {
+  Topic& topic = *topics[_topicIndex];
+  const uint64_t head = topic.head.load(std::memory_order_relaxed);
+  if (closed.load(std::memory_order_relaxed) || failed.load(std::memory_order_relaxed) ||
+      head - topic.tail.load(std::memory_order_acquire) >= topic.slots.size()) {
+    topic.dropped.fetch_add(1, std::memory_order_relaxed);
+    topic.droppedBytes.fetch_add(_data->size(), std::memory_order_relaxed);
+    return;
+  }
+  if (!topic.hasType.load(std::memory_order_relaxed)) {
+    topic.msgType = _msgType;
+    topic.hasType.store(true, std::memory_order_release);
+  }
+  Entry& entry = topic.slots[head % topic.slots.size()];
+  entry.timeNs = ToNs(Clock::now());
+  entry.data = _data;
+  topic.head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<RawRecorder::TopicStats> RawRecorder::Stats() const {
+  std::vector<TopicStats> stats;
+  for (const auto& topic : topics) {
+    stats.push_back(TopicStats{topic->name, topic->messages.load(), topic->bytes.load(), topic->dropped.load(),
+                               topic->droppedBytes.load()});
+  }
+  return stats;
+}
+
+void RawRecorder::WriterLoop() {
+  while (true) {
+    bool stop{false};
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stop = stopCondition.wait_for(lock, kWriterPeriod, [this] { return stopRequested; });
+    }
+    Drain();
+    if (stop) {
+      break;
+    }
+    if (chunkMessages > 0 && std::chrono::steady_clock::now() - chunkStart >= kChunkPeriod) {
+      WriteChunk();
+    }
+  }
+  // Producers are gone by now, the last drain got every queued message.
+  WriteChunk();
+  file.close();
+}
+
+void RawRecorder::Drain() {
+  for (size_t i = 0; i < topics.size(); ++i) {
+    Topic& topic = *topics[i];
+    const uint64_t head = topic.head.load(std::memory_order_acquire);
+    uint64_t tail = topic.tail.load(std::memory_order_relaxed);
+    if (tail == head) {
+      continue;
+    }
+    if (!topic.declared) {
+      DeclareTopic(i);
+    }
+    for (; tail != head; ++tail) {
+      Entry& entry = topic.slots[tail % topic.slots.size()];
+      const int64_t timeNs = entry.timeNs;
+      const std::shared_ptr<const std::string> data = std::move(entry.data);
+      // The slot is free for the producer from now on.
+      topic.tail.store(tail + 1, std::memory_order_release);
+
+      if (chunkMessages == 0) {
+        chunkStart = std::chrono::steady_clock::now();
+      }
+      Append(static_cast<uint16_t>(i), &chunk);
+      Append(timeNs, &chunk);
+      Append(static_cast<uint32_t>(data->size()), &chunk);
+      chunk.append(*data);
+      ++chunkMessages;
+      topic.messages.fetch_add(1, std::memory_order_relaxed);
+      topic.bytes.fetch_add(data->size(), std::memory_order_relaxed);
+      if (chunk.size() >= kChunkSize) {
+        WriteChunk();
+      }
+    }
+  }
+}
+
+void RawRecorder::WriteChunk() {
+  if (chunkMessages > 0) {
+    std::string payload;
+    payload.reserve(sizeof(uint32_t) + chunk.size());
+    Append(chunkMessages, &payload);
+    payload.append(chunk);
+    WriteRecord(kChunkRecord, payload);
+    chunk.clear();
+    chunkMessages = 0;
+  }
+
+  for (size_t i = 0; i < topics.size(); ++i) {
+    Topic& topic = *topics[i];
+    const uint64_t dropped = topic.dropped.load();
+    if (dropped == topic.reportedDrops) {
+      continue;
+    }
+    if (!topic.declared) {
+      DeclareTopic(i);
+    }
+    std::string payload;
+    Append(static_cast<uint16_t>(i), &payload);
+    Append(ToNs(Clock::now()), &payload);
+    Append(dropped, &payload);
+    Append(topic.droppedBytes.load(), &payload);
+    WriteRecord(kDropsRecord, payload);
+    topic.reportedDrops = dropped;
+  }
+  file.flush();
+}
+
+void RawRecorder::DeclareTopic(size_t _topicIndex) {
+  Topic& topic = *topics[_topicIndex];
+  // Queued messages set the type first, but the messages of a topic may all
+  // be dropped. It is declared again once the type is known.
+  const bool hasType = topic.hasType.load(std::memory_order_acquire);
+  std::string payload;
+  Append(static_cast<uint16_t>(_topicIndex), &payload);
+  AppendString(topic.name, &payload);
+  AppendString(hasType ? topic.msgType : "", &payload);
+  WriteRecord(kTopicRecord, payload);
+  topic.declared = hasType;
+}
+
+void RawRecorder::WriteRecord(uint8_t _kind, const std::string& _payload) {
+  if (failed) {
+    return;
+  }
+  std::string header;
+  Append(_kind, &header);
+  Append(static_cast<uint32_t>(_payload.size()), &header);
+  file.write(header.data(), header.size());
+  file.write(_payload.data(), _payload.size());
+  if (!file) {
+    ignerr << "Error writing the recording, messages are dropped from now on." << std::endl;
+    failed = true;
+    return;
+  }
+  fileSize += header.size() + _payload.size();
+}
+
+bool RawRecorder::Read(const std::string& _path, const MessageCallback& _callback,
+                       const DropsCallback& _dropsCallback) {
+  std::ifstream file(_path, std::ios::binary);
+  char magic[sizeof(kMagic) - 1];
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    ignerr << "[" << _path << "] is not a recording." << std::endl;
+    return false;
+  }
+
+  std::vector<std::pair<std::string, std::string>> names;
+  std::string header(sizeof(uint8_t) + sizeof(uint32_t), '\0');
+  std::string payload;
+  while (file.read(&header[0], header.size())) {
+    size_t offset{0};
+    uint8_t kind{0};
+    uint32_t size{0};
+    Extract(header, &offset, &kind);
+    Extract(header, &offset, &size);
+    payload.resize(size);
+    if (!file.read(&payload[0], size)) {
+      ignerr << "[" << _path << "] is truncated." << std::endl;
+      return false;
+    }
+
+    offset = 0;
+    if (kind == kTopicRecord) {
+      uint16_t id{0};
+      std::string name;
+      std::string msgType;
+      if (!Extract(payload, &offset, &id) || !ExtractString(payload, &offset, &name) ||
+          !ExtractString(payload, &offset, &msgType)) {
+        ignerr << "[" << _path << "] has a malformed topic record." << std::endl;
+        return false;
+      }
+      if (names.size() <= id) {
+        names.resize(id + 1);
+      }
+      names[id] = {name, msgType};
+    } else if (kind == kChunkRecord) {
+      uint32_t count{0};
+      Extract(payload, &offset, &count);
+      std::string data;
+      for (uint32_t i = 0; i < count; ++i) {
+        uint16_t id{0};
+        int64_t timeNs{0};
+        uint32_t dataSize{0};
+        if (!Extract(payload, &offset, &id) || !Extract(payload, &offset, &timeNs) ||
+            !Extract(payload, &offset, &dataSize) || !ExtractBytes(payload, dataSize, &offset, &data) ||
+            id >= names.size()) {
+          ignerr << "[" << _path << "] has a malformed chunk." << std::endl;
+          return false;
+        }
+        const Clock::time_point time(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(timeNs)));
+        _callback(names[id].first, names[id].second, time, data);
+      }
+    } else if (kind == kDropsRecord && _dropsCallback) {
+      uint16_t id{0};
+      int64_t timeNs{0};
+      uint64_t dropped{0};
+      uint64_t droppedBytes{0};
+      if (!Extract(payload, &offset, &id) || !Extract(payload, &offset, &timeNs) ||
+          !Extract(payload, &offset, &dropped) || !Extract(payload, &offset, &droppedBytes)) {
+        ignerr << "[" << _path << "] has a malformed drops record." << std::endl;
+        return false;
+      }
+      if (id >= names.size()) {
+        ignerr << "[" << _path << "] has a malformed drops record." << std::endl;
+        return false;
+      }
+      _dropsCallback(names[id].first, dropped, droppedBytes);
+    }
+    // Other records are skipped.
+  }
+  return file.eof() && file.gcount() == 0;
+}
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,233 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// \brief Records serialized messages of a set of topics into a file.
+///
+/// \details Each topic has a bounded, lock-free, single producer single
+///          consumer queue. Push() only stores the message there, or drops it
+///          when the queue is full, so it never blocks. A writer thread drains
+///          the queues into the file, grouping messages in chunks.
+///
+///          Push() must not be called concurrently for the same topic, which
+///          SubscriptionHub guarantees for the callbacks of a topic.
+///
+///          File format, all integers little endian:
+///          - The "DLPHREC1" magic, followed by records.
+///          - Record: uint8 kind, uint32 payload size, payload.
+///          - kTopicRecord payload: uint16 topic id, uint16 name size, name,
+///            uint16 type size, type. It precedes the topic messages and
+///            drops. The type is empty when only drops are known, the topic
+///            is then declared again with its type. Names and types are
+///            truncated to 65535 bytes.
+///          - kChunkRecord payload: uint32 message count, then per message
+///            uint16 topic id, int64 receive time in ns since epoch,
+///            uint32 size, serialized message.
+///          - kDropsRecord payload: uint16 topic id, int64 time in ns since
+///            epoch, uint64 dropped messages, uint64 dropped bytes. Totals
+///            since the recording started, written after the chunk that
+///            follows new drops and on close.
+class RawRecorder {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  /// \brief Record kinds.
+  static constexpr uint8_t kTopicRecord{1};
+  static constexpr uint8_t kChunkRecord{2};
+  static constexpr uint8_t kDropsRecord{3};
+
+  /// \brief File magic.
+  static constexpr char kMagic[]{"DLPHREC1"};
+
+  /// \brief Recording statistics of a topic.
+  struct TopicStats {
+    /// Topic name.
+    std::string topic;
+    /// Messages written to the file.
+    uint64_t messages{0};
+    /// Bytes of the messages written to the file.
+    uint64_t bytes{0};
+    /// Messages dropped because the queue was full or the file failed.
+    uint64_t dropped{0};
+    /// Bytes of the dropped messages.
+    uint64_t droppedBytes{0};
+  };
+
+  /// \brief Called by Read() with each recorded message.
+  using MessageCallback = std::function<void(const std::string& _topic, const std::string& _msgType,
+                                             const Clock::time_point& _time, const std::string& _data)>;
+
+  /// \brief Called by Read() with the drops of a topic, totals since the
+  ///        recording started.
+  using DropsCallback = std::function<void(const std::string& _topic, uint64_t _dropped, uint64_t _droppedBytes)>;
+
+  /// \brief Opens @p _path and starts the writer thread.
+  /// \param[in] _path File to write, it is truncated.
+  /// \param[in] _topics Topics to record, Push() refers to them by index.
+  /// \param[in] _queueSize Messages each topic queue holds.
+  /// \throws std::runtime_error When @p _path cannot be opened, @p _topics
+  ///         is empty or has more topics than ids, or @p _queueSize is zero.
+  RawRecorder(const std::string& _path, const std::vector<std::string>& _topics, size_t _queueSize);
+
+  /// \brief Calls Close().
+  ~RawRecorder();
+
+  RawRecorder(const RawRecorder&) = delete;
+  RawRecorder& operator=(const RawRecorder&) = delete;
+
+  /// \brief Queues a message of the topic @p _topicIndex, or drops it when the
+  ///        queue is full. It never blocks.
+  /// \param[in] _topicIndex Index of the topic in the constructor list.
+  /// \param[in] _msgType Message type, only the first one of a topic is kept.
+  /// \param[in] _data Serialized message, shared with the queue.
+  void Push(size_t _topicIndex, const std::string& _msgType, const std::shared_ptr<const std::string>& _data);
+
+  /// \brief Writes the queued messages, stops the writer thread and closes
+  ///        the file. Later messages are dropped.
+  /// \details Push() must not run concurrently with it.
+  void Close();
+
+  /// \return Recording statistics of each topic, in constructor order.
+  std::vector<TopicStats> Stats() const;
+
+  /// \return The bytes written to the file so far.
+  uint64_t FileSize() const { return fileSize.load(); }
+
+  /// \return True when writing to the file failed. Messages are dropped since.
+  bool Failed() const { return failed.load(); }
+
+  /// \brief Reads the recording at @p _path.
+  /// \param[in] _path The recording.
+  /// \param[in] _callback Called with each message, in file order.
+  /// \param[in] _dropsCallback Called with each drops record, in file order,
+  ///            when given.
+  /// \return False when @p _path cannot be read or is not a complete
+  ///         recording. Messages before the error are still reported.
+  static bool Read(const std::string& _path, const MessageCallback& _callback,
+                   const DropsCallback& _dropsCallback = nullptr);
+
+ private:
+  /// \brief Writer thread wake up period.
+  static constexpr std::chrono::milliseconds kWriterPeriod{10};
+
+  /// \brief Chunks are written when they reach this size...
+  static constexpr size_t kChunkSize{1 << 20};
+
+  /// \brief ...or when their first message is this old.
+  static constexpr std::chrono::milliseconds kChunkPeriod{250};
+
+  /// \brief A queued message.
+  struct Entry {
+    int64_t timeNs{0};
+    std::shared_ptr<const std::string> data;
+  };
+
+  /// \brief Queue and counters of a topic.
+  struct Topic {
+    explicit Topic(size_t _queueSize) : slots(_queueSize) {}
+
+    std::string name;
+
+    /// Ring of messages. `head` is only written by the producer and `tail`
+    /// by the writer thread, they only grow.
+    std::vector<Entry> slots;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+
+    /// Written once by the producer before `hasType` is set.
+    std::string msgType;
+    std::atomic<bool> hasType{false};
+
+    /// Only used by the writer thread. Whether the topic was declared with
+    /// its type.
+    bool declared{false};
+    uint64_t reportedDrops{0};
+
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> droppedBytes{0};
+  };
+
+  /// \brief Writer thread loop.
+  void WriterLoop();
+
+  /// \brief Moves the queued messages into the chunk, writing it when full.
+  void Drain();
+
+  /// \brief Writes the chunk, and the drops since the last one.
+  void WriteChunk();
+
+  /// \brief Writes the topic record of the topic @p _topicIndex.
+  void DeclareTopic(size_t _topicIndex);
+
+  /// \brief Writes a record of @p _kind with @p _payload.
+  void WriteRecord(uint8_t _kind, const std::string& _payload);
+
+  std::ofstream file;
+
+  std::vector<std::unique_ptr<Topic>> topics;
+
+  /// \brief Chunk being built by the writer thread.
+  std::string chunk;
+  uint32_t chunkMessages{0};
+  std::chrono::steady_clock::time_point chunkStart;
+
+  std::atomic<uint64_t> fileSize{0};
+  std::atomic<bool> failed{false};
+  std::atomic<bool> closed{false};
+
+  /// \brief Wakes the writer thread up to stop.
+  std::mutex mutex;
+  std::condition_variable stopCondition;
+  bool stopRequested{false};
+
+  std::thread writer;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,198 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "recorder_plugin.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <QDateTime>
+#include <QRegularExpression>
+#include <ignition/common/Console.hh>
+#include <ignition/plugin/Register.hh>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// \brief Formats @p _bytes with a binary unit.
+QString ToSize(uint64_t _bytes) {
+  if (_bytes < 1024u) {
+    return QString("%1 B").arg(_bytes);
+  }
+  if (_bytes < 1024u * 1024u) {
+    return QString("%1 KiB").arg(_bytes / 1024., 0, 'f', 1);
+  }
+  return QString("%1 MiB").arg(_bytes / (1024. * 1024.), 0, 'f', 1);
+}
+
+}  // namespace
+
+RecorderPlugin::RecorderPlugin() : Plugin() {}
+
+RecorderPlugin::~RecorderPlugin() { Stop(); }
+
+void RecorderPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
+  if (title.empty()) {
+    title = "Recorder";
+  }
+
+  if (_pluginElem) {
+    QStringList configTopics;
+    for (auto elem = _pluginElem->FirstChildElement("topic"); elem != nullptr;
+         elem = elem->NextSiblingElement("topic")) {
+      if (elem->GetText()) {
+        configTopics << QString(elem->GetText()).trimmed();
+      }
+    }
+    SetTopics(configTopics.join(", "));
+
+    if (auto elem = _pluginElem->FirstChildElement("path")) {
+      if (elem->GetText()) {
+        SetPath(QString(elem->GetText()).trimmed());
+      }
+    }
+
+    if (auto elem = _pluginElem->FirstChildElement("queue_size")) {
+      unsigned int value{0};
+      if (elem->QueryUnsignedText(&value) == tinyxml2::XML_SUCCESS && value > 0) {
+        queueSize = value;
+      } else {
+        ignwarn << "Invalid <queue_size>, using " << kDefaultQueueSize << std::endl;
+      }
+    }
+  }
+}
+
+void RecorderPlugin::SetTopics(const QString& _topics) {
+  topics = _topics;
+  TopicsChanged();
+}
+
+void RecorderPlugin::SetPath(const QString& _path) {
+  path = _path;
+  PathChanged();
+}
+
+void RecorderPlugin::Start() {
+  if (recorder) {
+    return;
+  }
+
+  std::vector<std::string> names;
+  for (const QString& topic : topics.split(QRegularExpression("[,\\s]+"), QString::SkipEmptyParts)) {
+    const std::string name = topic.toStdString();
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+      names.push_back(name);
+    }
+  }
+  if (names.empty()) {
+    status = "No topics to record";
+    StatusChanged();
+    return;
+  }
+
+  recordingPath = path.isEmpty()
+                      ? "recording_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss").toStdString() + ".drec"
+                      : path.toStdString();
+  try {
+    recorder = std::make_unique<RawRecorder>(recordingPath, names, queueSize);
+  } catch (const std::runtime_error& e) {
+    ignerr << e.what() << std::endl;
+    status = QString::fromStdString(e.what());
+    StatusChanged();
+    return;
+  }
+
+  RawRecorder* const raw = recorder.get();
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto subscription = SubscriptionHub::Instance()->SubscribeRaw(
+        names[i], [raw, i](const SubscriptionHub::DataPtr& _msgData, const ignition::transport::MessageInfo& _info) {
+          raw->Push(i, _info.Type(), _msgData);
+        });
+    if (subscription == nullptr) {
+      ignwarn << "Unable to subscribe to [" << names[i] << "], it won't be recorded." << std::endl;
+      continue;
+    }
+    subscriptions.push_back(std::move(subscription));
+  }
+
+  timer.start(kTimerPeriodInMs, this);
+  RecordingChanged();
+  UpdateStats();
+}
+
+void RecorderPlugin::Stop() {
+  if (!recorder) {
+    return;
+  }
+  timer.stop();
+  // No callback pushes to the recorder after its subscription is gone.
+  subscriptions.clear();
+  recorder->Close();
+  UpdateStats();
+  recorder.reset();
+  RecordingChanged();
+}
+
+void RecorderPlugin::timerEvent(QTimerEvent* _event) {
+  if (_event->timerId() != timer.timerId()) {
+    return;
+  }
+  UpdateStats();
+}
+
+void RecorderPlugin::UpdateStats() {
+  uint64_t messages{0};
+  uint64_t dropped{0};
+  topicStats.clear();
+  for (const RawRecorder::TopicStats& stats : recorder->Stats()) {
+    topicStats << QString::fromStdString(stats.topic) << QString::number(stats.messages) << ToSize(stats.bytes)
+               << QString::number(stats.dropped);
+    messages += stats.messages;
+    dropped += stats.dropped;
+  }
+
+  status = QString("%1 %2: %3 messages, %4, %5 dropped")
+               .arg(recorder->Failed() ? "Failed writing" : "Recorded")
+               .arg(QString::fromStdString(recordingPath))
+               .arg(messages)
+               .arg(ToSize(recorder->FileSize()))
+               .arg(dropped);
+  StatusChanged();
+  TopicStatsChanged();
+}
+
+}  // namespace gui
+}  // namespace delphyne
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(delphyne::gui::RecorderPlugin, ignition::gui::Plugin)
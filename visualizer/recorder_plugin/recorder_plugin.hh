@@ -0,0 +1,162 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/gui/Plugin.hh>
+
+#include "visualizer/recorder_plugin/raw_recorder.hh"
+#include "visualizer/subscription_hub.hh"
+
+namespace delphyne {
+namespace gui {
+
+/// \brief Records a chosen set of topics into a file, to capture what the
+///        visualizer received around a glitch.
+///
+/// \details Messages are taken serialized from the SubscriptionHub, without
+///          parsing them, and handed to a RawRecorder, whose writer thread
+///          writes them into the file. The transport callbacks never wait for
+///          the file: when the writer falls behind, messages are dropped and
+///          counted per topic.
+///
+///          Optional configuration:
+///          <topic>/agents/state</topic>  Topic to record, may be repeated.
+///          <path>recording.drec</path>   File to record into, a time stamped
+///                                        name in the working directory
+///                                        by default.
+///          <queue_size>4096</queue_size> Messages queued per topic before
+///                                        dropping.
+class RecorderPlugin : public ignition::gui::Plugin {
+  Q_OBJECT
+
+  Q_PROPERTY(QString topics READ Topics WRITE SetTopics NOTIFY TopicsChanged)
+
+  Q_PROPERTY(QString path READ Path WRITE SetPath NOTIFY PathChanged)
+
+  Q_PROPERTY(bool recording READ Recording NOTIFY RecordingChanged)
+
+  Q_PROPERTY(QString status READ Status NOTIFY StatusChanged)
+
+  Q_PROPERTY(QStringList topicStats READ TopicStats NOTIFY TopicStatsChanged)
+
+ public:
+  /// \brief Constructor.
+  RecorderPlugin();
+
+  /// \brief Stops recording.
+  ~RecorderPlugin() override;
+
+  // Documentation inherited
+  void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
+
+  /// \brief Topics to record, separated by commas or spaces.
+  Q_INVOKABLE QString Topics() const { return topics; }
+
+  Q_INVOKABLE void SetTopics(const QString& _topics);
+
+  /// \brief File to record into, an empty path picks a time stamped name.
+  Q_INVOKABLE QString Path() const { return path; }
+
+  Q_INVOKABLE void SetPath(const QString& _path);
+
+  /// \brief True while recording.
+  Q_INVOKABLE bool Recording() const { return recorder != nullptr; }
+
+  /// \brief Recording summary, or the last error.
+  Q_INVOKABLE QString Status() const { return status; }
+
+  /// \brief Per topic statistics of the recording. The list is made of blocks
+  ///        of [`topic`, `messages`, `size`, `dropped`], see
+  ///        RecorderPlugin.qml.
+  Q_INVOKABLE QStringList TopicStats() const { return topicStats; }
+
+  /// \brief Starts recording Topics() into Path().
+  Q_INVOKABLE void Start();
+
+  /// \brief Stops recording, writing the queued messages.
+  Q_INVOKABLE void Stop();
+
+ signals:
+  /// Signals to notify that the properties have changed.
+  void TopicsChanged();
+  void PathChanged();
+  void RecordingChanged();
+  void StatusChanged();
+  void TopicStatsChanged();
+
+ protected:
+  /// \brief Updates the statistics while recording.
+  void timerEvent(QTimerEvent* _event) override;
+
+ private:
+  /// \brief Statistics update period.
+  static constexpr int kTimerPeriodInMs{500};
+
+  /// \brief Default messages queued per topic.
+  static constexpr size_t kDefaultQueueSize{4096};
+
+  /// \brief Updates status and topicStats from the recorder.
+  void UpdateStats();
+
+  /// \brief See Topics().
+  QString topics;
+
+  /// \brief See Path().
+  QString path;
+
+  /// \brief Path of the current or last recording.
+  std::string recordingPath;
+
+  /// \brief See Status().
+  QString status{"Not recording"};
+
+  /// \brief See TopicStats().
+  QStringList topicStats;
+
+  /// \brief Messages queued per topic.
+  size_t queueSize{kDefaultQueueSize};
+
+  /// \brief Triggers an event every `kTimerPeriodInMs` while recording.
+  QBasicTimer timer;
+
+  /// \brief The recording, null when not recording.
+  std::unique_ptr<RawRecorder> recorder;
+
+  /// \brief Subscriptions feeding `recorder`. They must go before it.
+  std::vector<std::unique_ptr<SubscriptionHub::Subscription>> subscriptions;
+};
+
+}  // namespace gui
+}  // namespace delphyne
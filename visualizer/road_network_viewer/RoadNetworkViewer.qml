@@ -0,0 +1,101 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: roadNetworkViewer
+  color: "transparent"
+  Layout.minimumWidth: 320
+  Layout.minimumHeight: 190
+  Layout.fillWidth: true
+
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: 5
+
+    // Installed roads.
+    RowLayout {
+      ComboBox {
+        id: roadCombo
+        Layout.fillWidth: true
+        model: RoadNetworkViewer.roadFiles
+      }
+      Button {
+        text: qsTr("Load")
+        enabled: roadCombo.currentText !== ""
+        onClicked: RoadNetworkViewer.LoadRoad(roadCombo.currentText)
+      }
+    }
+
+    // Checkbox to toggle the road visibility.
+    CheckBox {
+      id: visibilityCheckbox
+      text: qsTr("Visible")
+      checked: RoadNetworkViewer.isVisible
+      onClicked : {
+        visibilityCheckbox.checked = !RoadNetworkViewer.isVisible;
+        RoadNetworkViewer.isVisible = !RoadNetworkViewer.isVisible;
+      }
+    }
+
+    Text {
+      Layout.fillWidth: true
+      elide: Text.ElideLeft
+      font.family: "Helvetica"
+      font.pixelSize: 12
+      text: RoadNetworkViewer.road
+    }
+
+    Text {
+      Layout.fillWidth: true
+      font.family: "Helvetica"
+      font.pixelSize: 12
+      text: RoadNetworkViewer.status
+    }
+
+    // Lanes under the mouse and last clicked.
+    Text {
+      Layout.fillWidth: true
+      font.family: "Helvetica"
+      font.pixelSize: 12
+      text: qsTr("Hovered: ") + RoadNetworkViewer.hoveredLane
+    }
+
+    Text {
+      Layout.fillWidth: true
+      font.family: "Helvetica"
+      font.pixelSize: 12
+      text: qsTr("Selected: ") + RoadNetworkViewer.selectedLane
+    }
+  }
+}
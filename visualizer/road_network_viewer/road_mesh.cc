@@ -0,0 +1,379 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "road_mesh.hh"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <maliput/api/lane.h>
+#include <maliput/api/lane_data.h>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+using Point = std::array<double, 3>;
+
+// Lanes are sampled at least this often along s, in meters, so bisection
+// does not miss features between far apart samples.
+constexpr double kMaxSampleStep{5.};
+
+// Maximum number of bisections of an initial sample interval.
+constexpr int kMaxRefinements{8};
+
+// Width of the lane boundary markings, in meters.
+constexpr double kMarkingWidth{0.15};
+
+// Height of the lane boundary markings over the surface, in meters.
+constexpr double kMarkingHeight{0.02};
+
+// Cache file magic and version. The version changes with the format or the
+// meshing.
+constexpr char kCacheMagic[4] = {'D', 'R', 'M', 'C'};
+constexpr uint32_t kCacheVersion{1};
+
+// @return The inertial position of (@p _s, @p _r, @p _h) in @p _lane.
+Point ToPoint(const maliput::api::Lane& _lane, double _s, double _r, double _h) {
+  const maliput::api::InertialPosition position =
+      _lane.ToInertialPosition(maliput::api::LanePosition(_s, _r, _h));
+  return {position.x(), position.y(), position.z()};
+}
+
+// @return The distance between @p _a and @p _b.
+double Distance(const Point& _a, const Point& _b) {
+  return std::sqrt((_a[0] - _b[0]) * (_a[0] - _b[0]) + (_a[1] - _b[1]) * (_a[1] - _b[1]) +
+                   (_a[2] - _b[2]) * (_a[2] - _b[2]));
+}
+
+// @return The midpoint of @p _a and @p _b.
+Point Midpoint(const Point& _a, const Point& _b) {
+  return {(_a[0] + _b[0]) / 2., (_a[1] + _b[1]) / 2., (_a[2] + _b[2]) / 2.};
+}
+
+// Lane cross section at a given s: right edge, center and left edge.
+struct Section {
+  double s{0.};
+  Point right;
+  Point center;
+  Point left;
+};
+
+// @return The cross section of @p _lane at @p _s.
+Section SectionAt(const maliput::api::Lane& _lane, double _s) {
+  const maliput::api::RBounds bounds = _lane.lane_bounds(_s);
+  return Section{_s, ToPoint(_lane, _s, bounds.min(), 0.), ToPoint(_lane, _s, 0., 0.),
+                 ToPoint(_lane, _s, bounds.max(), 0.)};
+}
+
+// Appends to @p _sections the sections of @p _lane in (@p _first.s, @p _last.s]
+// needed to keep within @p _tolerance, by bisection.
+void Refine(const maliput::api::Lane& _lane, const Section& _first, const Section& _last, double _tolerance,
+            int _depth, std::vector<Section>* _sections) {
+  if (_depth < kMaxRefinements) {
+    const Section middle = SectionAt(_lane, (_first.s + _last.s) / 2.);
+    if (Distance(middle.center, Midpoint(_first.center, _last.center)) > _tolerance ||
+        Distance(middle.right, Midpoint(_first.right, _last.right)) > _tolerance ||
+        Distance(middle.left, Midpoint(_first.left, _last.left)) > _tolerance) {
+      Refine(_lane, _first, middle, _tolerance, _depth + 1, _sections);
+      Refine(_lane, middle, _last, _tolerance, _depth + 1, _sections);
+      return;
+    }
+  }
+  _sections->push_back(_last);
+}
+
+// @return The cross sections of @p _lane, from s = 0 to its length.
+std::vector<Section> SampleLane(const maliput::api::Lane& _lane, double _tolerance) {
+  const double length = _lane.length();
+  const int steps = std::max(1, static_cast<int>(std::ceil(length / kMaxSampleStep)));
+  std::vector<Section> sections{SectionAt(_lane, 0.)};
+  for (int i = 1; i <= steps; ++i) {
+    const Section first = sections.back();
+    Refine(_lane, first, SectionAt(_lane, length * i / steps), _tolerance, 0, &sections);
+  }
+  return sections;
+}
+
+// Appends a vertex at @p _position with @p _normal to @p _mesh.
+void AddVertex(const Point& _position, const Point& _normal, RoadMesh* _mesh) {
+  _mesh->positions.insert(_mesh->positions.end(), _position.begin(), _position.end());
+  _mesh->normals.insert(_mesh->normals.end(), _normal.begin(), _normal.end());
+}
+
+// Appends to @p _mesh a strip between the @p _rights and @p _lefts polylines,
+// which have the same number of points.
+void AddStrip(const std::vector<Point>& _rights, const std::vector<Point>& _lefts, RoadMesh* _mesh) {
+  const uint32_t base = static_cast<uint32_t>(_mesh->positions.size() / 3);
+  for (size_t i = 0; i < _rights.size(); ++i) {
+    // The normal is the cross product of the strip direction and its width.
+    const size_t next = i + 1 < _rights.size() ? i + 1 : i;
+    const size_t previous = next == i ? i - 1 : i;
+    const Point along{_rights[next][0] - _rights[previous][0], _rights[next][1] - _rights[previous][1],
+                      _rights[next][2] - _rights[previous][2]};
+    const Point across{_lefts[i][0] - _rights[i][0], _lefts[i][1] - _rights[i][1], _lefts[i][2] - _rights[i][2]};
+    Point normal{along[1] * across[2] - along[2] * across[1], along[2] * across[0] - along[0] * across[2],
+                 along[0] * across[1] - along[1] * across[0]};
+    const double norm = Distance(normal, Point{0., 0., 0.});
+    normal = norm > 0. ? Point{normal[0] / norm, normal[1] / norm, normal[2] / norm} : Point{0., 0., 1.};
+    AddVertex(_rights[i], normal, _mesh);
+    AddVertex(_lefts[i], normal, _mesh);
+  }
+  for (uint32_t i = 0; i + 1 < _rights.size(); ++i) {
+    const uint32_t right = base + 2 * i;
+    const uint32_t left = right + 1;
+    _mesh->indices.insert(_mesh->indices.end(), {right, right + 2, left, left, right + 2, left + 2});
+  }
+}
+
+// Appends to @p _mesh a marking along r = @p _r, a function of s, of @p _lane.
+template <typename RFunction>
+void AddMarking(const maliput::api::Lane& _lane, const std::vector<Section>& _sections, RFunction _r,
+                RoadMesh* _mesh) {
+  std::vector<Point> rights;
+  std::vector<Point> lefts;
+  for (const Section& section : _sections) {
+    const double r = _r(section.s);
+    rights.push_back(ToPoint(_lane, section.s, r - kMarkingWidth / 2., kMarkingHeight));
+    lefts.push_back(ToPoint(_lane, section.s, r + kMarkingWidth / 2., kMarkingHeight));
+  }
+  AddStrip(rights, lefts, _mesh);
+}
+
+// @return A hex digest of @p _data and @p _tolerance.
+std::string Digest(const std::string& _data, double _tolerance) {
+  // 64 bit FNV-1a.
+  uint64_t hash{14695981039346656037ull};
+  const auto add = [&hash](const char* _bytes, size_t _size) {
+    for (size_t i = 0; i < _size; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(_bytes[i])) * 1099511628211ull;
+    }
+  };
+  add(_data.data(), _data.size());
+  add(reinterpret_cast<const char*>(&_tolerance), sizeof(_tolerance));
+  add(reinterpret_cast<const char*>(&kCacheVersion), sizeof(kCacheVersion));
+  std::stringstream sstr;
+  sstr << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return sstr.str();
+}
+
+// Writes @p _size elements of @p _values to @p _file, preceded by their count.
+template <typename T>
+void WriteArray(const std::vector<T>& _values, std::ofstream* _file) {
+  const uint32_t size = static_cast<uint32_t>(_values.size());
+  _file->write(reinterpret_cast<const char*>(&size), sizeof(size));
+  _file->write(reinterpret_cast<const char*>(_values.data()), _values.size() * sizeof(T));
+}
+
+// Reads a @p _value from @p _file, which has @p _remaining bytes left.
+template <typename T>
+bool ReadValue(std::ifstream* _file, size_t* _remaining, T* _value) {
+  if (*_remaining < sizeof(T) || !_file->read(reinterpret_cast<char*>(_value), sizeof(T))) {
+    return false;
+  }
+  *_remaining -= sizeof(T);
+  return true;
+}
+
+// Reads an array written by WriteArray() from @p _file into @p _values.
+// @p _remaining holds the bytes left in @p _file, arrays larger than that are
+// rejected before being allocated.
+template <typename T>
+bool ReadArray(std::ifstream* _file, size_t* _remaining, std::vector<T>* _values) {
+  uint32_t size{0};
+  if (!ReadValue(_file, _remaining, &size)) {
+    return false;
+  }
+  const size_t bytes = static_cast<size_t>(size) * sizeof(T);
+  if (bytes > *_remaining) {
+    return false;
+  }
+  *_remaining -= bytes;
+  _values->resize(size);
+  return static_cast<bool>(_file->read(reinterpret_cast<char*>(_values->data()), bytes));
+}
+
+// @return true when @p _mesh describes whole triangles over its own vertices.
+bool IsValid(const RoadMesh& _mesh) {
+  if (_mesh.positions.size() % 3 != 0 || _mesh.normals.size() != _mesh.positions.size() ||
+      _mesh.indices.size() % 3 != 0) {
+    return false;
+  }
+  const size_t vertexCount = _mesh.positions.size() / 3;
+  return std::all_of(_mesh.indices.begin(), _mesh.indices.end(),
+                     [vertexCount](uint32_t _index) { return _index < vertexCount; });
+}
+
+}  // namespace
+
+std::vector<RoadMesh> RoadMesh::FromSegment(const maliput::api::Segment& _segment, double _tolerance) {
+  RoadMesh surface;
+  surface.name = _segment.id().string() + "/surface";
+  surface.kind = Kind::kSurface;
+  RoadMesh markings;
+  markings.name = _segment.id().string() + "/markings";
+  markings.kind = Kind::kMarking;
+
+  for (int i = 0; i < _segment.num_lanes(); ++i) {
+    const maliput::api::Lane& lane = *_segment.lane(i);
+    const std::vector<Section> sections = SampleLane(lane, _tolerance);
+
+    std::vector<Point> rights;
+    std::vector<Point> lefts;
+    for (const Section& section : sections) {
+      rights.push_back(section.right);
+      lefts.push_back(section.left);
+    }
+    AddStrip(rights, lefts, &surface);
+
+    // Lanes are ordered right to left, every lane draws its left boundary and
+    // the first one the right boundary of the segment too.
+    if (i == 0) {
+      AddMarking(lane, sections, [&lane](double _s) { return lane.lane_bounds(_s).min(); }, &markings);
+    }
+    AddMarking(lane, sections, [&lane](double _s) { return lane.lane_bounds(_s).max(); }, &markings);
+  }
+  return {std::move(surface), std::move(markings)};
+}
+
+std::optional<std::string> RoadMeshCache::EntryPath(const std::string& _roadPath, double _tolerance) {
+  const char* home = std::getenv("HOME");
+  if (home == nullptr) {
+    return std::nullopt;
+  }
+  std::ifstream road(_roadPath, std::ios::binary);
+  if (!road) {
+    return std::nullopt;
+  }
+  const std::string contents{std::istreambuf_iterator<char>(road), std::istreambuf_iterator<char>()};
+
+  const std::string cacheDir = ignition::common::joinPaths(home, ".delphyne", "cache", "road_meshes");
+  if (!ignition::common::createDirectories(cacheDir)) {
+    return std::nullopt;
+  }
+  return ignition::common::joinPaths(cacheDir, Digest(contents, _tolerance) + ".meshes");
+}
+
+std::optional<std::vector<RoadMesh>> RoadMeshCache::Load(const std::string& _entryPath) {
+  std::ifstream file(_entryPath, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::nullopt;
+  }
+  // Sizes read from the entry are bounded by the bytes left in it, so a
+  // corrupt entry is rejected instead of being allocated.
+  const std::streamoff length = file.tellg();
+  size_t remaining = length > 0 ? static_cast<size_t>(length) : 0;
+  file.seekg(0);
+  char magic[sizeof(kCacheMagic)];
+  uint32_t version{0};
+  uint32_t count{0};
+  if (!ReadValue(&file, &remaining, &magic) || std::memcmp(magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      !ReadValue(&file, &remaining, &version) || version != kCacheVersion || !ReadValue(&file, &remaining, &count)) {
+    return std::nullopt;
+  }
+  constexpr size_t kMinMeshBytes{sizeof(uint8_t) + 4 * sizeof(uint32_t)};
+
+  try {
+    if (count > remaining / kMinMeshBytes) {
+      ignwarn << "Ignoring invalid road mesh cache entry [" << _entryPath << "]." << std::endl;
+      return std::nullopt;
+    }
+    std::vector<RoadMesh> meshes(count);
+    for (RoadMesh& mesh : meshes) {
+      uint8_t kind{0};
+      std::vector<char> name;
+      if (!ReadValue(&file, &remaining, &kind) || kind > static_cast<uint8_t>(RoadMesh::Kind::kMarking) ||
+          !ReadArray(&file, &remaining, &name) || !ReadArray(&file, &remaining, &mesh.positions) ||
+          !ReadArray(&file, &remaining, &mesh.normals) || !ReadArray(&file, &remaining, &mesh.indices) ||
+          !IsValid(mesh)) {
+        ignwarn << "Ignoring invalid road mesh cache entry [" << _entryPath << "]." << std::endl;
+        return std::nullopt;
+      }
+      mesh.kind = static_cast<RoadMesh::Kind>(kind);
+      mesh.name.assign(name.begin(), name.end());
+    }
+    return meshes;
+  } catch (const std::exception& e) {
+    ignwarn << "Ignoring unreadable road mesh cache entry [" << _entryPath << "]: " << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+bool RoadMeshCache::Save(const std::string& _entryPath, const std::vector<RoadMesh>& _meshes) {
+  // Writers in other processes, or other viewers in this one, may save the
+  // same entry concurrently, each one writes its own temporary file.
+  static std::atomic<unsigned> saveCount{0};
+  const std::string tmpPath =
+      _entryPath + "." + std::to_string(::getpid()) + "." + std::to_string(saveCount++) + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    const uint32_t count = static_cast<uint32_t>(_meshes.size());
+    file.write(kCacheMagic, sizeof(kCacheMagic));
+    file.write(reinterpret_cast<const char*>(&kCacheVersion), sizeof(kCacheVersion));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const RoadMesh& mesh : _meshes) {
+      const uint8_t kind = static_cast<uint8_t>(mesh.kind);
+      file.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+      WriteArray(std::vector<char>(mesh.name.begin(), mesh.name.end()), &file);
+      WriteArray(mesh.positions, &file);
+      WriteArray(mesh.normals, &file);
+      WriteArray(mesh.indices, &file);
+    }
+    // Closing flushes the entry, write errors may only show up then.
+    file.close();
+    if (!file) {
+      ignerr << "Unable to write road mesh cache entry [" << tmpPath << "]." << std::endl;
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpPath.c_str(), _entryPath.c_str()) != 0) {
+    ignerr << "Unable to write road mesh cache entry [" << _entryPath << "]." << std::endl;
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace gui
+}  // namespace delphyne
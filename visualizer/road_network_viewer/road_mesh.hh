@@ -0,0 +1,92 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <maliput/api/segment.h>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Triangle mesh of a part of a road network, in the inertial frame.
+struct RoadMesh {
+  /// @brief What the mesh represents, it selects its material.
+  enum class Kind : uint8_t {
+    kSurface = 0,  ///< Drivable surface of the lanes.
+    kMarking = 1,  ///< Lane boundary markings, slightly above the surface.
+  };
+
+  /// @brief Unique name within the road network, e.g. "<segment id>/surface".
+  std::string name;
+  Kind kind{Kind::kSurface};
+  /// @brief Vertex positions and normals, three floats per vertex.
+  std::vector<float> positions;
+  std::vector<float> normals;
+  /// @brief Three vertex indices per triangle.
+  std::vector<uint32_t> indices;
+
+  /// @brief Meshes @p _segment lanes and their boundaries.
+  /// @details Lanes are sampled along s so that no sample of their center and
+  ///          edges is further than @p _tolerance from the straight line
+  ///          between its neighboring samples.
+  /// @param _segment The segment to mesh.
+  /// @param _tolerance Maximum deviation in meters. It must be positive.
+  /// @return The surface and marking meshes of @p _segment.
+  static std::vector<RoadMesh> FromSegment(const maliput::api::Segment& _segment, double _tolerance);
+};
+
+/// @brief On-disk cache of road network meshes.
+/// @details Entries are keyed by the contents of the road description file and
+///          the meshing tolerance, so an edited road is meshed again. They live
+///          in `$HOME/.delphyne/cache/road_meshes`.
+class RoadMeshCache {
+ public:
+  /// @return The cache entry path of the road at @p _roadPath meshed with
+  ///         @p _tolerance, or std::nullopt when @p _roadPath can't be read
+  ///         or there is no cache location.
+  static std::optional<std::string> EntryPath(const std::string& _roadPath, double _tolerance);
+
+  /// @return The meshes at @p _entryPath, or std::nullopt when the entry is
+  ///         missing or invalid.
+  static std::optional<std::vector<RoadMesh>> Load(const std::string& _entryPath);
+
+  /// @brief Writes @p _meshes to @p _entryPath. It is replaced atomically, so
+  ///        concurrent readers never see a partial entry.
+  /// @return false when the entry cannot be written.
+  static bool Save(const std::string& _entryPath, const std::vector<RoadMesh>& _meshes);
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,202 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "road_mesh_builder.hh"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <maliput/api/junction.h>
+#include <maliput/api/road_geometry.h>
+#include <maliput/api/segment.h>
+#include <maliput/plugin/create_road_network.h>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// maliput plugin that loads multilane road descriptions.
+constexpr char kRoadNetworkLoader[]{"maliput_multilane"};
+
+}  // namespace
+
+RoadMeshBuilder::RoadMeshBuilder(const std::string& _roadPath, double _tolerance, size_t _jobs)
+    : roadPath(_roadPath),
+      tolerance(_tolerance),
+      jobs(_jobs > 0 ? _jobs : std::max<size_t>(std::thread::hardware_concurrency(), 1)) {
+  loader = std::thread(&RoadMeshBuilder::Run, this);
+}
+
+RoadMeshBuilder::~RoadMeshBuilder() {
+  Stop();
+  loader.join();
+}
+
+std::vector<RoadMesh> RoadMeshBuilder::TakeMeshes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<RoadMesh> meshes;
+  meshes.swap(ready);
+  return meshes;
+}
+
+void RoadMeshBuilder::AddMeshes(std::vector<RoadMesh> _meshes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  all.insert(all.end(), _meshes.begin(), _meshes.end());
+  ready.insert(ready.end(), std::make_move_iterator(_meshes.begin()), std::make_move_iterator(_meshes.end()));
+}
+
+void RoadMeshBuilder::Run() {
+  const std::optional<std::string> entryPath = RoadMeshCache::EntryPath(roadPath, tolerance);
+  if (entryPath.has_value()) {
+    if (std::optional<std::vector<RoadMesh>> meshes = RoadMeshCache::Load(entryPath.value())) {
+      fromCache = true;
+      AddMeshes(std::move(meshes.value()));
+    }
+  }
+
+  try {
+    roadNetwork = maliput::plugin::CreateRoadNetwork(kRoadNetworkLoader, {{"yaml_file", roadPath}});
+  } catch (const std::exception& e) {
+    ignerr << "Unable to load road [" << roadPath << "]: " << e.what() << std::endl;
+  }
+  if (roadNetwork == nullptr) {
+    state = State::kFailed;
+    return;
+  }
+  roadNetworkReady = roadNetwork.get();
+  if (stopRequested) {
+    return;
+  }
+  laneIndex = LaneIndex::Build(*roadNetwork->road_geometry());
+  laneIndexReady = laneIndex.get();
+
+  if (!fromCache) {
+    state = State::kMeshing;
+    MeshSegments();
+    if (stopRequested) {
+      return;
+    }
+  }
+  std::vector<RoadMesh> meshes;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    meshes.swap(all);
+  }
+  // Written outside the lock, so TakeMeshes() doesn't wait for the disk.
+  if (!fromCache && entryPath.has_value()) {
+    RoadMeshCache::Save(entryPath.value(), meshes);
+  }
+  state = State::kDone;
+}
+
+void RoadMeshBuilder::MeshSegments() {
+  std::vector<const maliput::api::Segment*> roadSegments;
+  const maliput::api::RoadGeometry* roadGeometry = roadNetwork->road_geometry();
+  for (int i = 0; i < roadGeometry->num_junctions(); ++i) {
+    const maliput::api::Junction* junction = roadGeometry->junction(i);
+    for (int j = 0; j < junction->num_segments(); ++j) {
+      roadSegments.push_back(junction->segment(j));
+    }
+  }
+  segments = static_cast<int>(roadSegments.size());
+
+  // Segments are handed out one at a time, so meshes are ready as soon as
+  // their segment is meshed.
+  std::atomic<size_t> next{0};
+  const auto worker = [&]() {
+    for (size_t i = next++; i < roadSegments.size() && !stopRequested; i = next++) {
+      AddMeshes(RoadMesh::FromSegment(*roadSegments[i], tolerance));
+      ++meshedSegments;
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(jobs, roadSegments.size()); ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+}
+
+RoadMeshBuilderReleaser::RoadMeshBuilderReleaser() {
+  releaser = std::thread(&RoadMeshBuilderReleaser::Run, this);
+}
+
+RoadMeshBuilderReleaser::~RoadMeshBuilderReleaser() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_one();
+  releaser.join();
+}
+
+std::shared_ptr<RoadMeshBuilder> RoadMeshBuilderReleaser::Make(const std::string& _roadPath, double _tolerance) {
+  const std::weak_ptr<RoadMeshBuilderReleaser> weakThis = weak_from_this();
+  return std::shared_ptr<RoadMeshBuilder>(new RoadMeshBuilder(_roadPath, _tolerance),
+                                          [weakThis](RoadMeshBuilder* _builder) {
+                                            if (std::shared_ptr<RoadMeshBuilderReleaser> self = weakThis.lock()) {
+                                              self->Release(_builder);
+                                            } else {
+                                              delete _builder;
+                                            }
+                                          });
+}
+
+void RoadMeshBuilderReleaser::Release(RoadMeshBuilder* _builder) {
+  _builder->Stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    released.push_back(_builder);
+  }
+  condition.notify_one();
+}
+
+void RoadMeshBuilderReleaser::Run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    condition.wait(lock, [this]() { return stopping || !released.empty(); });
+    if (released.empty()) {
+      return;
+    }
+    RoadMeshBuilder* builder = released.front();
+    released.pop_front();
+    lock.unlock();
+    delete builder;
+    lock.lock();
+  }
+}
+
+}  // namespace gui
+}  // namespace delphyne
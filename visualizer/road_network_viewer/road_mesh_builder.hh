@@ -0,0 +1,188 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <maliput/api/road_network.h>
+
+#include "visualizer/lane_index.hh"
+#include "visualizer/road_network_viewer/road_mesh.hh"
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Loads a maliput multilane road and meshes it in the background.
+/// @details A loader thread takes the meshes from the RoadMeshCache when it
+///          has them. Otherwise it loads the road network and meshes its
+///          segments on a pool of worker threads, one segment at a time in
+///          junction order, so the first meshes are ready early and the
+///          consumer can show them while the rest are meshed. The meshes are
+///          then written to the cache. The road network is loaded and
+///          indexed in both cases, for consumers that query it.
+class RoadMeshBuilder {
+ public:
+  /// @brief Builder states.
+  enum class State {
+    kLoading,  ///< Loading the road network, or the cached meshes.
+    kMeshing,  ///< Meshing the road network segments.
+    kDone,     ///< All meshes and the road network are ready.
+    kFailed,   ///< The road network could not be loaded.
+  };
+
+  /// @brief Starts loading the road at @p _roadPath.
+  /// @param _roadPath Path to a maliput multilane road description.
+  /// @param _tolerance Meshing tolerance, see RoadMesh::FromSegment().
+  /// @param _jobs Number of meshing threads, the number of cores when zero.
+  RoadMeshBuilder(const std::string& _roadPath, double _tolerance, size_t _jobs = 0);
+
+  /// @brief Stops meshing and waits for the background threads. A road
+  ///        network being loaded is waited for, see RoadMeshBuilderReleaser.
+  ~RoadMeshBuilder();
+
+  RoadMeshBuilder(const RoadMeshBuilder&) = delete;
+  RoadMeshBuilder& operator=(const RoadMeshBuilder&) = delete;
+
+  /// @brief Asks the background threads to stop, without waiting for them.
+  void Stop() { stopRequested = true; }
+
+  /// @return The meshes made ready since the previous call.
+  std::vector<RoadMesh> TakeMeshes();
+
+  /// @return The builder state.
+  State GetState() const { return state.load(); }
+
+  /// @return The number of segments of the road network, once loaded.
+  int Segments() const { return segments.load(); }
+
+  /// @return The number of segments meshed so far.
+  int MeshedSegments() const { return meshedSegments.load(); }
+
+  /// @return True when the meshes come from the cache.
+  bool FromCache() const { return fromCache.load(); }
+
+  /// @return The road network, or nullptr until it is loaded.
+  const maliput::api::RoadNetwork* RoadNetwork() const { return roadNetworkReady.load(); }
+
+  /// @return The road network lane index, or nullptr until it is built. It is
+  ///         built right after the road network is loaded, before meshing.
+  const LaneIndex* Index() const { return laneIndexReady.load(); }
+
+ private:
+  /// @brief Loader thread body.
+  void Run();
+
+  /// @brief Meshes the road network segments on the worker pool.
+  void MeshSegments();
+
+  /// @brief Makes @p _meshes available to TakeMeshes().
+  void AddMeshes(std::vector<RoadMesh> _meshes);
+
+  const std::string roadPath;
+  const double tolerance;
+  const size_t jobs;
+
+  std::atomic<State> state{State::kLoading};
+  std::atomic<int> segments{0};
+  std::atomic<int> meshedSegments{0};
+  std::atomic<bool> fromCache{false};
+  std::atomic<bool> stopRequested{false};
+
+  /// @brief Owned road network, published through `roadNetworkReady` once
+  ///        loaded.
+  std::unique_ptr<maliput::api::RoadNetwork> roadNetwork;
+  std::atomic<const maliput::api::RoadNetwork*> roadNetworkReady{nullptr};
+
+  /// @brief Owned lane index, published through `laneIndexReady` once built.
+  std::unique_ptr<LaneIndex> laneIndex;
+  std::atomic<const LaneIndex*> laneIndexReady{nullptr};
+
+  /// @brief Protects `ready` and `all`.
+  std::mutex mutex;
+
+  /// @brief Meshes not taken yet.
+  std::vector<RoadMesh> ready;
+
+  /// @brief Every mesh, to be cached.
+  std::vector<RoadMesh> all;
+
+  std::thread loader;
+};
+
+/// @brief Makes RoadMeshBuilders that are destroyed in the background.
+/// @details Destroying a builder waits for its loader thread, which can't be
+///          interrupted while it loads or indexes the road network. Builders
+///          made by Make() are stopped when their last reference goes away
+///          and destroyed on the releaser thread instead, so whoever drops
+///          that reference doesn't wait. Builders outliving the releaser are
+///          destroyed in place.
+class RoadMeshBuilderReleaser : public std::enable_shared_from_this<RoadMeshBuilderReleaser> {
+ public:
+  RoadMeshBuilderReleaser();
+
+  /// @brief Waits for the released builders to be destroyed.
+  ~RoadMeshBuilderReleaser();
+
+  RoadMeshBuilderReleaser(const RoadMeshBuilderReleaser&) = delete;
+  RoadMeshBuilderReleaser& operator=(const RoadMeshBuilderReleaser&) = delete;
+
+  /// @brief Starts loading the road at @p _roadPath, see RoadMeshBuilder.
+  /// @pre The releaser is owned by a std::shared_ptr.
+  std::shared_ptr<RoadMeshBuilder> Make(const std::string& _roadPath, double _tolerance);
+
+ private:
+  /// @brief Stops @p _builder and queues it for destruction.
+  void Release(RoadMeshBuilder* _builder);
+
+  /// @brief Releaser thread body.
+  void Run();
+
+  /// @brief Protects `released` and `stopping`.
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  /// @brief Builders waiting to be destroyed.
+  std::deque<RoadMeshBuilder*> released;
+  bool stopping{false};
+
+  std::thread releaser;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,372 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "road_network_viewer.hh"
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/gui/Application.hh>
+#include <ignition/gui/GuiEvents.hh>
+#include <ignition/gui/MainWindow.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/rendering/Camera.hh>
+#include <ignition/rendering/Material.hh>
+#include <ignition/rendering/Mesh.hh>
+#include <ignition/rendering/MeshDescriptor.hh>
+#include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/Visual.hh>
+
+#include "delphyne_gui/config.hh"
+#include "visualizer/display_plugins/scene_notifier.hh"
+#include "visualizer/plugin_metrics.hh"
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Time spent on each Render event, where built road meshes are added to the
+// scene, and on each lane pick.
+const PluginMetrics::CounterHandle kRenderMetrics = PluginMetrics::Instance()->Register("RoadNetworkViewer", "render");
+const PluginMetrics::CounterHandle kPickMetrics = PluginMetrics::Instance()->Register("RoadNetworkViewer", "pick");
+
+}  // namespace
+
+RoadNetworkViewer::RoadNetworkViewer() : Plugin() {
+  const std::string roadsDirectory = RoadsDirectory();
+  if (ignition::common::isDirectory(roadsDirectory)) {
+    for (ignition::common::DirIter it(roadsDirectory); it != ignition::common::DirIter(); ++it) {
+      const std::string file = ignition::common::basename(*it);
+      if (file.size() > 5 && file.substr(file.size() - 5) == ".yaml") {
+        roadFiles << QString::fromStdString(file);
+      }
+    }
+    roadFiles.sort();
+  }
+}
+
+RoadNetworkViewer::~RoadNetworkViewer() {
+  if (sharedIndex != nullptr && SharedLaneIndex::Get().get() == sharedIndex) {
+    SharedLaneIndex::Set(nullptr);
+  }
+  // The scene outlives the plugin when it is closed, the road goes with it.
+  if (roadVisual != nullptr && scene != nullptr && scene->IsInitialized()) {
+    scene->DestroyVisual(roadVisual, true /* recursive */);
+    roadVisual = nullptr;
+  }
+  RemoveMeshes();
+}
+
+void RoadNetworkViewer::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
+  if (title.empty()) {
+    title = "Road network";
+  }
+
+  QString initialRoad;
+  if (_pluginElem) {
+    if (auto elem = _pluginElem->FirstChildElement("road")) {
+      if (elem->GetText()) {
+        initialRoad = QString(elem->GetText()).trimmed();
+      }
+    }
+    if (auto elem = _pluginElem->FirstChildElement("tolerance")) {
+      if (elem->QueryDoubleText(&tolerance) != tinyxml2::XML_SUCCESS || tolerance <= 0.) {
+        ignwarn << "Invalid <tolerance>, using " << kDefaultTolerance << std::endl;
+        tolerance = kDefaultTolerance;
+      }
+    }
+    if (auto elem = _pluginElem->FirstChildElement("scene")) {
+      if (elem->GetText()) {
+        sceneName = elem->GetText();
+      }
+    }
+  }
+
+  ignition::gui::App()->findChild<ignition::gui::MainWindow*>()->installEventFilter(this);
+  SceneNotifier::Instance()->OnSceneAvailable(this, kEngineName, sceneName,
+                                              [this](ignition::rendering::ScenePtr _scene) { scene = _scene; });
+  timer.start(kTimerPeriodInMs, this);
+
+  if (!initialRoad.isEmpty()) {
+    LoadRoad(initialRoad);
+  }
+}
+
+std::string RoadNetworkViewer::RoadsDirectory() {
+  // The resource root is set by the workspace setup script, the install
+  // prefix is the fallback.
+  const char* resourceRoot = std::getenv("DELPHYNE_GUI_RESOURCE_ROOT");
+  if (resourceRoot != nullptr && *resourceRoot != '\0') {
+    const std::string root(resourceRoot);
+    return ignition::common::joinPaths(root.substr(0, root.find(':')), "roads");
+  }
+  return DELPHYNE_ROADS_PATH;
+}
+
+void RoadNetworkViewer::LoadRoad(const QString& _road) {
+  std::string path = _road.toStdString();
+  if (!ignition::common::isFile(path)) {
+    path = ignition::common::joinPaths(RoadsDirectory(), path);
+  }
+  if (!ignition::common::isFile(path)) {
+    ignerr << "Unable to find road [" << _road.toStdString() << "]." << std::endl;
+    status = "Unable to find " + _road;
+    StatusChanged();
+    return;
+  }
+
+  std::shared_ptr<RoadMeshBuilder> newBuilder = releaser->Make(path, tolerance);
+  std::shared_ptr<RoadMeshBuilder> oldBuilder;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    oldBuilder = std::move(builder);
+    builder = std::move(newBuilder);
+    reloadRequested = true;
+  }
+  // The shared lane index keeps the replaced builder alive.
+  if (sharedIndex != nullptr) {
+    SharedLaneIndex::Set(nullptr);
+    sharedIndex = nullptr;
+  }
+  // The replaced builder stops and is destroyed in the background, as it may
+  // be loading a road network, which can't be interrupted.
+  oldBuilder.reset();
+
+  road = QString::fromStdString(path);
+  RoadChanged();
+}
+
+void RoadNetworkViewer::SetIsVisible(bool _isVisible) {
+  isVisible = _isVisible;
+  IsVisibleChanged();
+  isDirty = true;
+}
+
+void RoadNetworkViewer::timerEvent(QTimerEvent* _event) {
+  if (_event->timerId() != timer.timerId()) {
+    return;
+  }
+  std::shared_ptr<RoadMeshBuilder> currentBuilder;
+  std::optional<std::string> hover;
+  std::optional<std::string> click;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    currentBuilder = builder;
+    hover = std::exchange(hoverPick, std::nullopt);
+    click = std::exchange(clickPick, std::nullopt);
+  }
+  if (hover.has_value() && QString::fromStdString(hover.value()) != hoveredLane) {
+    hoveredLane = QString::fromStdString(hover.value());
+    HoveredLaneChanged();
+  }
+  if (click.has_value() && QString::fromStdString(click.value()) != selectedLane) {
+    selectedLane = QString::fromStdString(click.value());
+    SelectedLaneChanged();
+  }
+  if (currentBuilder == nullptr) {
+    return;
+  }
+
+  // The shared index holds a reference to its builder, which owns the road.
+  const LaneIndex* index = currentBuilder->Index();
+  if (index != nullptr && index != sharedIndex) {
+    SharedLaneIndex::Set(std::shared_ptr<const LaneIndex>(currentBuilder, index));
+    sharedIndex = index;
+  }
+
+  QString newStatus;
+  switch (currentBuilder->GetState()) {
+    case RoadMeshBuilder::State::kLoading:
+      newStatus = "Loading";
+      break;
+    case RoadMeshBuilder::State::kMeshing:
+      newStatus = QString("Meshing %1 of %2 segments")
+                      .arg(currentBuilder->MeshedSegments())
+                      .arg(currentBuilder->Segments());
+      break;
+    case RoadMeshBuilder::State::kDone:
+      newStatus = currentBuilder->FromCache() ? "Loaded, meshes from cache" : "Loaded";
+      break;
+    case RoadMeshBuilder::State::kFailed:
+      newStatus = "Unable to load the road, see the console";
+      break;
+  }
+  if (newStatus != status) {
+    status = newStatus;
+    StatusChanged();
+  }
+}
+
+bool RoadNetworkViewer::eventFilter(QObject* _obj, QEvent* _event) {
+  // Hooking to the Render event to safely make rendering calls.
+  if (_event->type() == ignition::gui::events::Render::kType && scene != nullptr) {
+    const PluginMetrics::Scope metrics(kRenderMetrics);
+    std::shared_ptr<RoadMeshBuilder> currentBuilder;
+    bool reload{false};
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      currentBuilder = builder;
+      std::swap(reload, reloadRequested);
+    }
+    if (reload) {
+      pendingMeshes.clear();
+      if (roadVisual != nullptr) {
+        scene->DestroyVisual(roadVisual, true /* recursive */);
+        roadVisual = nullptr;
+      }
+      RemoveMeshes();
+      ++loadCount;
+    }
+    if (currentBuilder != nullptr) {
+      for (RoadMesh& mesh : currentBuilder->TakeMeshes()) {
+        pendingMeshes.push_back(std::move(mesh));
+      }
+      AddPendingMeshes();
+    }
+    if (isDirty && roadVisual != nullptr) {
+      roadVisual->SetVisible(isVisible);
+      isDirty = false;
+    }
+  } else if (_event->type() == ignition::gui::events::HoverToScene::kType && scene != nullptr) {
+    const std::string pick = Pick(static_cast<ignition::gui::events::HoverToScene*>(_event)->Point());
+    std::lock_guard<std::mutex> lock(mutex);
+    hoverPick = pick;
+  } else if (_event->type() == ignition::gui::events::LeftClickToScene::kType && scene != nullptr) {
+    const std::string pick = Pick(static_cast<ignition::gui::events::LeftClickToScene*>(_event)->Point());
+    std::lock_guard<std::mutex> lock(mutex);
+    clickPick = pick;
+  }
+
+  // Standard event processing
+  return QObject::eventFilter(_obj, _event);
+}
+
+void RoadNetworkViewer::AddPendingMeshes() {
+  if (pendingMeshes.empty()) {
+    return;
+  }
+  if (roadVisual == nullptr) {
+    roadVisual = scene->CreateVisual();
+    scene->RootVisual()->AddChild(roadVisual);
+    roadVisual->SetVisible(isVisible);
+  }
+  if (surfaceMaterial == nullptr) {
+    surfaceMaterial = scene->CreateMaterial();
+    surfaceMaterial->SetAmbient(0.2, 0.2, 0.2);
+    surfaceMaterial->SetDiffuse(0.3, 0.3, 0.3);
+    markingMaterial = scene->CreateMaterial();
+    markingMaterial->SetAmbient(0.8, 0.8, 0.8);
+    markingMaterial->SetDiffuse(0.95, 0.95, 0.95);
+  }
+  for (int i = 0; i < kMeshesPerFrame && !pendingMeshes.empty(); ++i) {
+    AddVisual(pendingMeshes.front());
+    pendingMeshes.pop_front();
+  }
+}
+
+void RoadNetworkViewer::AddVisual(const RoadMesh& _mesh) {
+  const std::string meshName = "road_network_" + std::to_string(loadCount) + "/" + _mesh.name;
+  ignition::common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(ignition::common::SubMesh::TRIANGLES);
+  for (size_t i = 0; i + 2 < _mesh.positions.size(); i += 3) {
+    subMesh.AddVertex(_mesh.positions[i], _mesh.positions[i + 1], _mesh.positions[i + 2]);
+    subMesh.AddNormal(_mesh.normals[i], _mesh.normals[i + 1], _mesh.normals[i + 2]);
+  }
+  for (const uint32_t index : _mesh.indices) {
+    subMesh.AddIndex(index);
+  }
+  // The mesh manager owns the mesh.
+  auto mesh = new ignition::common::Mesh();
+  mesh->SetName(meshName);
+  mesh->AddSubMesh(subMesh);
+  ignition::common::MeshManager::Instance()->AddMesh(mesh);
+  meshNames.push_back(meshName);
+
+  ignition::rendering::VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(scene->CreateMesh(ignition::rendering::MeshDescriptor(mesh)));
+  visual->SetMaterial(_mesh.kind == RoadMesh::Kind::kSurface ? surfaceMaterial : markingMaterial);
+  roadVisual->AddChild(visual);
+}
+
+void RoadNetworkViewer::RemoveMeshes() {
+  for (const std::string& meshName : meshNames) {
+    ignition::common::MeshManager::Instance()->RemoveMesh(meshName);
+  }
+  meshNames.clear();
+}
+
+std::string RoadNetworkViewer::Pick(const ignition::math::Vector3d& _point) {
+  const PluginMetrics::Scope metrics(kPickMetrics);
+  std::shared_ptr<RoadMeshBuilder> currentBuilder;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    currentBuilder = builder;
+  }
+  const LaneIndex* index = currentBuilder != nullptr ? currentBuilder->Index() : nullptr;
+  if (index == nullptr) {
+    return "";
+  }
+
+  if (camera == nullptr) {
+    for (unsigned int i = 0; i < scene->SensorCount() && camera == nullptr; ++i) {
+      camera = std::dynamic_pointer_cast<ignition::rendering::Camera>(scene->SensorByIndex(i));
+    }
+  }
+  // The picked point may lie on a vehicle or a marking above the road.
+  // Casting a ray from the camera through it finds the road surface the user
+  // is pointing at.
+  std::optional<LaneIndex::Hit> hit;
+  if (camera != nullptr && camera->WorldPosition() != _point) {
+    const ignition::math::Vector3d origin = camera->WorldPosition();
+    hit = index->CastRay(origin, (_point - origin).Normalized(), origin.Distance(_point) + kPickDepth);
+  } else {
+    hit = index->FindLane(_point);
+  }
+  if (!hit.has_value()) {
+    return "";
+  }
+  std::ostringstream description;
+  description << std::fixed << std::setprecision(2) << hit->lane->id().string() << "  s: " << hit->position.s()
+              << "  r: " << hit->position.r() << "  h: " << hit->position.h();
+  return description.str();
+}
+
+}  // namespace gui
+}  // namespace delphyne
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(delphyne::gui::RoadNetworkViewer, ignition::gui::Plugin)
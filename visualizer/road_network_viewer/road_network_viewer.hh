@@ -0,0 +1,253 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ignition/gui/Plugin.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/rendering/RenderTypes.hh>
+
+#include "visualizer/lane_index.hh"
+#include "visualizer/road_network_viewer/road_mesh.hh"
+#include "visualizer/road_network_viewer/road_mesh_builder.hh"
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Shows a maliput multilane road network in the Scene3D scene.
+/// @details The road is loaded and meshed by a RoadMeshBuilder, in the
+///          background. On each `ignition::gui::events::Render` event the
+///          meshes ready so far are added to the scene, a few per frame, so
+///          the road shows up piece by piece while the UI stays responsive.
+///          Reopening a road takes its meshes from the RoadMeshCache.
+///
+///          Hovering or clicking the road shows the lane under the mouse and
+///          its (s, r, h) coordinates, found with the road LaneIndex. The
+///          index is shared through SharedLaneIndex with other plugins.
+///
+///          Optional configuration:
+///          <road>circuit.yaml</road>   Road to load on start. Bare file names
+///                                      are looked up in the installed roads.
+///          <tolerance>0.05</tolerance> Meshing tolerance, in meters.
+///          <scene>scene</scene>        Must match Scene3D's scene name.
+class RoadNetworkViewer : public ignition::gui::Plugin {
+  Q_OBJECT
+
+  Q_PROPERTY(QStringList roadFiles READ RoadFiles CONSTANT)
+
+  Q_PROPERTY(QString road READ Road NOTIFY RoadChanged)
+
+  Q_PROPERTY(QString status READ Status NOTIFY StatusChanged)
+
+  Q_PROPERTY(bool isVisible READ IsVisible WRITE SetIsVisible NOTIFY IsVisibleChanged)
+
+  Q_PROPERTY(QString hoveredLane READ HoveredLane NOTIFY HoveredLaneChanged)
+
+  Q_PROPERTY(QString selectedLane READ SelectedLane NOTIFY SelectedLaneChanged)
+
+ public:
+  /// @brief Constructor.
+  RoadNetworkViewer();
+
+  /// @brief Destructor. It stops sharing the road lane index.
+  ~RoadNetworkViewer() override;
+
+  // Documentation inherited
+  void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
+
+  /// @brief Road files found in the installed roads directory.
+  Q_INVOKABLE QStringList RoadFiles() const { return roadFiles; }
+
+  /// @brief Path of the shown road.
+  Q_INVOKABLE QString Road() const { return road; }
+
+  /// @brief Loading progress of the shown road.
+  Q_INVOKABLE QString Status() const { return status; }
+
+  /// @{ isVisible accessors.
+  Q_INVOKABLE bool IsVisible() const { return isVisible; }
+
+  Q_INVOKABLE void SetIsVisible(bool _isVisible);
+  /// @}
+
+  /// @brief Lane and (s, r, h) coordinates under the mouse.
+  Q_INVOKABLE QString HoveredLane() const { return hoveredLane; }
+
+  /// @brief Lane and (s, r, h) coordinates last clicked.
+  Q_INVOKABLE QString SelectedLane() const { return selectedLane; }
+
+  /// @brief Replaces the shown road with @p _road, a path or a file name in
+  ///        the installed roads directory.
+  Q_INVOKABLE void LoadRoad(const QString& _road);
+
+ signals:
+  /// Signals to notify that the properties have changed.
+  void RoadChanged();
+  void StatusChanged();
+  void IsVisibleChanged();
+  void HoveredLaneChanged();
+  void SelectedLaneChanged();
+
+ protected:
+  /// @brief Filters ignition::gui::events::Render events to add the ready
+  ///        meshes to the scene, and the hover and left click events to pick
+  ///        lanes.
+  bool eventFilter(QObject* _obj, QEvent* _event) override;
+
+  /// @brief Updates the status and the picked lanes, and shares the lane
+  ///        index once built.
+  void timerEvent(QTimerEvent* _event) override;
+
+ private:
+  /// @brief The rendering engine name.
+  const std::string kEngineName{"ogre"};
+
+  /// @brief Meshes added to the scene per Render event.
+  static constexpr int kMeshesPerFrame{8};
+
+  /// @brief Default meshing tolerance, in meters.
+  static constexpr double kDefaultTolerance{0.05};
+
+  /// @brief Status and picked lanes update period.
+  static constexpr int kTimerPeriodInMs{100};
+
+  /// @brief Length of the picking rays beyond the picked scene point, in
+  ///        meters, to reach the road under vehicles and markings.
+  static constexpr double kPickDepth{100.};
+
+  /// @return The installed roads directory.
+  static std::string RoadsDirectory();
+
+  /// @brief Adds up to kMeshesPerFrame pending meshes to the scene. It must be
+  ///        called within a Render event.
+  void AddPendingMeshes();
+
+  /// @brief Adds @p _mesh to the scene. It must be called within a Render
+  ///        event.
+  void AddVisual(const RoadMesh& _mesh);
+
+  /// @brief Removes the meshes of the shown road from the mesh manager, once
+  ///        their visuals are destroyed.
+  void RemoveMeshes();
+
+  /// @brief Finds the lane under @p _point, a scene point picked by Scene3D.
+  ///        It must be called within a Render event.
+  /// @return A description of the picked lane, empty when there is none.
+  std::string Pick(const ignition::math::Vector3d& _point);
+
+  /// @brief See RoadFiles().
+  QStringList roadFiles;
+
+  /// @brief See Road().
+  QString road;
+
+  /// @brief See Status().
+  QString status{"No road"};
+
+  /// @brief See IsVisible().
+  std::atomic<bool> isVisible{true};
+
+  /// @brief See HoveredLane().
+  QString hoveredLane;
+
+  /// @brief See SelectedLane().
+  QString selectedLane;
+
+  /// @brief Meshing tolerance, in meters.
+  double tolerance{kDefaultTolerance};
+
+  /// @brief The scene name.
+  std::string sceneName{"scene"};
+
+  /// @brief The scene pointer, set within a Render event.
+  ignition::rendering::ScenePtr scene;
+
+  /// @brief Triggers an event every `kTimerPeriodInMs`.
+  QBasicTimer timer;
+
+  /// @brief Protects `builder` and `reloadRequested`, which the GUI thread
+  ///        sets and Render events consume, and the picked lanes, which
+  ///        go the other way.
+  std::mutex mutex;
+
+  /// @brief Destroys the replaced builders in the background. It outlives
+  ///        `builder`.
+  std::shared_ptr<RoadMeshBuilderReleaser> releaser{std::make_shared<RoadMeshBuilderReleaser>()};
+
+  /// @brief Builder of the shown road.
+  std::shared_ptr<RoadMeshBuilder> builder;
+
+  /// @brief Whether the shown visuals belong to a replaced road.
+  bool reloadRequested{false};
+
+  /// @brief Picked lanes, not shown yet.
+  std::optional<std::string> hoverPick;
+  std::optional<std::string> clickPick;
+
+  /// @brief The lane index shared through SharedLaneIndex, only used by the
+  ///        GUI thread.
+  const LaneIndex* sharedIndex{nullptr};
+
+  /// @brief Whether the visuals visibility should be updated.
+  std::atomic<bool> isDirty{false};
+
+  /// The following members are only used within Render events.
+
+  /// @brief Meshes waiting to be added to the scene.
+  std::deque<RoadMesh> pendingMeshes;
+
+  /// @brief Parent of the road visuals.
+  ignition::rendering::VisualPtr roadVisual;
+
+  /// @brief Road surface and marking materials.
+  ignition::rendering::MaterialPtr surfaceMaterial;
+  ignition::rendering::MaterialPtr markingMaterial;
+
+  /// @brief Number of loaded roads, to name the meshes uniquely.
+  int loadCount{0};
+
+  /// @brief Names of the meshes of the shown road in the mesh manager, to
+  ///        remove them with their visuals.
+  std::vector<std::string> meshNames;
+
+  /// @brief The Scene3D camera, origin of the picking rays.
+  ignition::rendering::CameraPtr camera;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,94 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "startup_tracer.hh"
+
+#include <fstream>
+#include <iostream>
+
+#include <ignition/common/Console.hh>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// @brief Escapes @p _str to be used as a JSON string.
+std::string JsonEscape(const std::string& _str) {
+  std::string escaped;
+  for (const char c : _str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+}  // namespace
+
+StartupTracer::Scope::Scope(StartupTracer* _tracer, const std::string& _name, const std::string& _category)
+    : tracer(_tracer), name(_name), category(_category), start(Clock::now()) {}
+
+StartupTracer::Scope::~Scope() {
+  if (tracer != nullptr) {
+    tracer->AddSpan(name, category, start, Clock::now());
+  }
+}
+
+StartupTracer::StartupTracer(const std::string& _path, const Clock::time_point& _origin)
+    : path(_path), origin(_origin) {}
+
+void StartupTracer::AddSpan(const std::string& _name, const std::string& _category, const Clock::time_point& _start,
+                            const Clock::time_point& _end) {
+  spans.push_back(Span{_name, _category, _start, _end});
+}
+
+bool StartupTracer::Write() const {
+  std::ofstream file(path, std::ios::trunc);
+  file << "{\"traceEvents\":[";
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const Span& span = spans[i];
+    const auto ts = std::chrono::duration_cast<std::chrono::microseconds>(span.start - origin).count();
+    const auto dur = std::chrono::duration_cast<std::chrono::microseconds>(span.end - span.start).count();
+    file << (i == 0 ? "" : ",") << "\n{\"name\":\"" << JsonEscape(span.name) << "\",\"cat\":\""
+         << JsonEscape(span.category) << "\",\"ph\":\"X\",\"ts\":" << ts << ",\"dur\":" << dur
+         << ",\"pid\":1,\"tid\":1}";
+  }
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  if (!file) {
+    ignerr << "Unable to write the startup trace [" << path << "]." << std::endl;
+    return false;
+  }
+  ignmsg << "Startup trace written to [" << path << "]." << std::endl;
+  return true;
+}
+
+}  // namespace gui
+}  // namespace delphyne
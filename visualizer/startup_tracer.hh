@@ -0,0 +1,109 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Records timed spans of the visualizer startup and writes them in
+///        the Chrome trace-event JSON format, which chrome://tracing and
+///        Perfetto load.
+///
+/// @details Spans are recorded from a single thread. Times are relative to
+///          the tracer origin.
+class StartupTracer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Records a span from its construction to its destruction.
+  /// @details A scope of a null tracer records nothing, so call sites do not
+  ///          need to check whether tracing is enabled.
+  class Scope {
+   public:
+    /// @param[in] _tracer The tracer to record into, it may be nullptr.
+    /// @param[in] _name The span name.
+    /// @param[in] _category The span category.
+    Scope(StartupTracer* _tracer, const std::string& _name, const std::string& _category);
+
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    StartupTracer* tracer{nullptr};
+    std::string name;
+    std::string category;
+    Clock::time_point start;
+  };
+
+  /// @brief Constructs a tracer that writes to @p _path.
+  /// @param[in] _path The trace file.
+  /// @param[in] _origin Time origin of the trace, e.g. the process start.
+  StartupTracer(const std::string& _path, const Clock::time_point& _origin);
+
+  /// @brief Records a span.
+  /// @param[in] _name The span name.
+  /// @param[in] _category The span category.
+  /// @param[in] _start The span start.
+  /// @param[in] _end The span end.
+  void AddSpan(const std::string& _name, const std::string& _category, const Clock::time_point& _start,
+               const Clock::time_point& _end);
+
+  /// @brief Writes the recorded spans.
+  /// @return false when the file cannot be written.
+  bool Write() const;
+
+ private:
+  // A recorded span.
+  struct Span {
+    std::string name;
+    std::string category;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+
+  // The trace file.
+  const std::string path;
+
+  // Time origin of the trace.
+  const Clock::time_point origin;
+
+  // Recorded spans, in recording order.
+  std::vector<Span> spans;
+};
+
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,246 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "subscription_hub.hh"
+
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/Factory.hh>
+#include <ignition/transport/TopicUtils.hh>
+
+#include "plugin_metrics.hh"
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Time spent parsing received messages and their payload size. Each message
+// is parsed once, however many subscribers its topic has.
+const PluginMetrics::CounterHandle kDecodeMetrics = PluginMetrics::Instance()->Register("SubscriptionHub", "decode");
+
+}  // namespace
+
+SubscriptionHub::Subscription::Subscription(SubscriptionHub* _hub, const std::string& _topic, uint64_t _id)
+    : hub(_hub), topic(_topic), id(_id) {}
+
+SubscriptionHub::Subscription::~Subscription() { hub->Remove(topic, id); }
+
+SubscriptionHub* SubscriptionHub::Instance() {
+  static SubscriptionHub instance;
+  return &instance;
+}
+
+std::unique_ptr<google::protobuf::Message> SubscriptionHub::NewMessage(const std::string& _msgType) {
+  if (auto msg = ignition::msgs::Factory::New(_msgType)) {
+    return msg;
+  }
+  const google::protobuf::Descriptor* descriptor =
+      google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(_msgType);
+  if (descriptor == nullptr) {
+    return nullptr;
+  }
+  const google::protobuf::Message* prototype =
+      google::protobuf::MessageFactory::generated_factory()->GetPrototype(descriptor);
+  return prototype != nullptr ? std::unique_ptr<google::protobuf::Message>(prototype->New()) : nullptr;
+}
+
+std::unique_ptr<SubscriptionHub::Subscription> SubscriptionHub::Subscribe(const std::string& _topic,
+                                                                          MessageCallback _callback) {
+  return Add(_topic, std::move(_callback), nullptr);
+}
+
+std::unique_ptr<SubscriptionHub::Subscription> SubscriptionHub::SubscribeRaw(const std::string& _topic,
+                                                                             RawCallback _callback) {
+  return Add(_topic, nullptr, std::move(_callback));
+}
+
+std::string SubscriptionHub::FullyQualifiedTopic(const std::string& _topic) const {
+  std::string fullName;
+  if (!ignition::transport::TopicUtils::FullyQualifiedName(node.Options().Partition(), node.Options().NameSpace(),
+                                                           _topic, fullName)) {
+    return "";
+  }
+  // Drops the "@<partition>@" prefix.
+  const size_t topicStart = fullName.find('@', 1);
+  return topicStart == std::string::npos ? "" : fullName.substr(topicStart + 1);
+}
+
+std::unique_ptr<SubscriptionHub::Subscription> SubscriptionHub::Add(const std::string& _topic,
+                                                                    MessageCallback _callback,
+                                                                    RawCallback _rawCallback) {
+  const std::string topic = FullyQualifiedTopic(_topic);
+  if (topic.empty()) {
+    ignerr << "Invalid topic [" << _topic << "]" << std::endl;
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> nodeLock(nodeMutex);
+  std::shared_ptr<TopicEntry> entry;
+  uint64_t id{0};
+  bool isNewTopic{false};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = topics.find(topic);
+    isNewTopic = it == topics.end();
+    if (isNewTopic) {
+      it = topics.emplace(topic, std::make_shared<TopicEntry>()).first;
+    }
+    entry = it->second;
+    id = nextId++;
+  }
+  if (isNewTopic && !node.SubscribeRaw(topic, std::bind(&SubscriptionHub::OnMessage, this, std::placeholders::_1,
+                                                         std::placeholders::_2, std::placeholders::_3))) {
+    ignerr << "Error subscribing to [" << topic << "]" << std::endl;
+    std::lock_guard<std::mutex> lock(mutex);
+    topics.erase(topic);
+    return nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lock(entry->dispatchMutex);
+    if (_callback) {
+      entry->callbacks.emplace(id, std::move(_callback));
+    } else {
+      entry->rawCallbacks.emplace(id, std::move(_rawCallback));
+    }
+    entry->stats.subscribers = entry->callbacks.size() + entry->rawCallbacks.size();
+  }
+  return std::unique_ptr<Subscription>(new Subscription(this, topic, id));
+}
+
+void SubscriptionHub::Remove(const std::string& _topic, uint64_t _id) {
+  std::lock_guard<std::mutex> nodeLock(nodeMutex);
+  bool isLastSubscriber{false};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = topics.find(_topic);
+    if (it == topics.end()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> dispatchLock(it->second->dispatchMutex);
+      it->second->callbacks.erase(_id);
+      it->second->rawCallbacks.erase(_id);
+      it->second->stats.subscribers = it->second->callbacks.size() + it->second->rawCallbacks.size();
+      isLastSubscriber = it->second->stats.subscribers == 0;
+    }
+    if (isLastSubscriber) {
+      topics.erase(it);
+    }
+  }
+  // The transport may hold its own locks while running OnMessage(), so it is
+  // not called with `mutex` held.
+  if (isLastSubscriber) {
+    node.Unsubscribe(_topic);
+  }
+}
+
+void SubscriptionHub::OnMessage(const char* _msgData, const size_t _size,
+                                const ignition::transport::MessageInfo& _info) {
+  std::shared_ptr<TopicEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = topics.find(_info.Topic());
+    if (it == topics.end()) {
+      return;
+    }
+    entry = it->second;
+  }
+
+  std::lock_guard<std::mutex> dispatchLock(entry->dispatchMutex);
+  TopicStats& stats = entry->stats;
+  ++stats.messages;
+  const size_t subscribers = entry->callbacks.size() + entry->rawCallbacks.size();
+  if (subscribers > 1) {
+    stats.copiesSaved += subscribers - 1;
+  }
+
+  if (!entry->rawCallbacks.empty()) {
+    const DataPtr data = std::make_shared<const std::string>(_msgData, _size);
+    for (const auto& callback : entry->rawCallbacks) {
+      callback.second(data, _info);
+    }
+  }
+
+  if (entry->callbacks.empty()) {
+    return;
+  }
+  const auto decodeStart = Clock::now();
+  std::unique_ptr<google::protobuf::Message> msg = NewMessage(_info.Type());
+  if (msg == nullptr || !msg->ParseFromArray(_msgData, static_cast<int>(_size))) {
+    if (stats.decodeErrors++ == 0) {
+      ignerr << "Unable to parse [" << _info.Type() << "] messages of [" << _info.Topic() << "]" << std::endl;
+    }
+    return;
+  }
+  const Clock::duration decodeTime = Clock::now() - decodeStart;
+  kDecodeMetrics.Record(decodeTime, _size);
+  ++stats.decodes;
+  stats.decodeTime += decodeTime;
+  stats.decodeTimeSaved += decodeTime * static_cast<int>(entry->callbacks.size() - 1);
+
+  const MessagePtr sharedMsg(std::move(msg));
+  for (const auto& callback : entry->callbacks) {
+    callback.second(sharedMsg, _info);
+  }
+}
+
+std::map<std::string, SubscriptionHub::TopicStats> SubscriptionHub::Stats() const {
+  std::map<std::string, std::shared_ptr<TopicEntry>> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries = topics;
+  }
+  std::map<std::string, TopicStats> stats;
+  for (const auto& entry : entries) {
+    std::lock_guard<std::mutex> dispatchLock(entry.second->dispatchMutex);
+    stats.emplace(entry.first, entry.second->stats);
+  }
+  return stats;
+}
+
+SubscriptionHub::TopicStats SubscriptionHub::Stats(const std::string& _topic) const {
+  const std::string topic = FullyQualifiedTopic(_topic);
+  std::shared_ptr<TopicEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = topics.find(topic);
+    if (it == topics.end()) {
+      return TopicStats();
+    }
+    entry = it->second;
+  }
+  std::lock_guard<std::mutex> dispatchLock(entry->dispatchMutex);
+  return entry->stats;
+}
+
+}  // namespace gui
+}  // namespace delphyne
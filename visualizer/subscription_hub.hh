@@ -0,0 +1,200 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <google/protobuf/message.h>
+#include <ignition/transport/MessageInfo.hh>
+#include <ignition/transport/Node.hh>
+
+namespace delphyne {
+namespace gui {
+
+/// \brief In-process hub that shares topic subscriptions among plugins.
+///
+/// \details The hub holds a single transport subscription per topic, no
+///          matter how many plugins are interested in it. Each message is
+///          received once and, when any subscriber asked for decoded
+///          messages, parsed once into an immutable protobuf message shared
+///          by all of them. Raw subscribers share the received bytes.
+///          The transport subscription is dropped with the last subscriber.
+///          Topics are shared by their fully qualified name, so "topic" and
+///          "/topic" are the same topic.
+///
+///          Callbacks run on transport threads. They must not subscribe or
+///          unsubscribe, and a Subscription destruction waits for the
+///          callbacks of its topic in flight.
+class SubscriptionHub {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using MessagePtr = std::shared_ptr<const google::protobuf::Message>;
+  using DataPtr = std::shared_ptr<const std::string>;
+  using MessageCallback = std::function<void(const MessagePtr&, const ignition::transport::MessageInfo&)>;
+  using RawCallback = std::function<void(const DataPtr&, const ignition::transport::MessageInfo&)>;
+
+  /// \brief A subscriber of a topic, it unsubscribes on destruction.
+  class Subscription {
+   public:
+    ~Subscription();
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    /// \return The subscribed topic, fully qualified, e.g. "/topic".
+    const std::string& Topic() const { return topic; }
+
+   private:
+    friend class SubscriptionHub;
+
+    Subscription(SubscriptionHub* _hub, const std::string& _topic, uint64_t _id);
+
+    SubscriptionHub* hub{nullptr};
+    std::string topic;
+    uint64_t id{0};
+  };
+
+  /// \brief Sharing statistics of a topic.
+  struct TopicStats {
+    /// Current number of subscribers, decoded and raw.
+    size_t subscribers{0};
+    /// Received messages.
+    uint64_t messages{0};
+    /// Parsed messages.
+    uint64_t decodes{0};
+    /// Messages that could not be parsed.
+    uint64_t decodeErrors{0};
+    /// Time spent parsing messages.
+    Clock::duration decodeTime{Clock::duration::zero()};
+    /// Parse time that subscribing separately would have added.
+    Clock::duration decodeTimeSaved{Clock::duration::zero()};
+    /// Message copies that subscribing separately would have added.
+    uint64_t copiesSaved{0};
+  };
+
+  /// \return The process wide instance.
+  static SubscriptionHub* Instance();
+
+  /// \brief Creates an empty message of type @p _msgType, e.g.
+  ///        "ignition.msgs.Scene".
+  /// \details Types known to ignition::msgs::Factory are created through it,
+  ///          other linked protobuf types, like delphyne's, through the
+  ///          generated descriptor pool.
+  /// \return The message, or nullptr when the type is unknown.
+  static std::unique_ptr<google::protobuf::Message> NewMessage(const std::string& _msgType);
+
+  /// \brief Subscribes to decoded messages of @p _topic.
+  /// \param[in] _topic The topic.
+  /// \param[in] _callback Called with each message.
+  /// \return The subscription, or nullptr when the transport subscription
+  ///         fails.
+  std::unique_ptr<Subscription> Subscribe(const std::string& _topic, MessageCallback _callback);
+
+  /// \brief Subscribes to decoded messages of @p _topic of type @p T.
+  /// \details Messages of other types are ignored.
+  /// \param[in] _topic The topic.
+  /// \param[in] _callback Called with each message.
+  /// \return The subscription, or nullptr when the transport subscription
+  ///         fails.
+  template <typename T>
+  std::unique_ptr<Subscription> Subscribe(const std::string& _topic, std::function<void(const T&)> _callback) {
+    return Subscribe(_topic, [_callback](const MessagePtr& _msg, const ignition::transport::MessageInfo&) {
+      if (const auto typedMsg = dynamic_cast<const T*>(_msg.get())) {
+        _callback(*typedMsg);
+      }
+    });
+  }
+
+  /// \brief Subscribes to serialized messages of @p _topic.
+  /// \param[in] _topic The topic.
+  /// \param[in] _callback Called with each message.
+  /// \return The subscription, or nullptr when the transport subscription
+  ///         fails.
+  std::unique_ptr<Subscription> SubscribeRaw(const std::string& _topic, RawCallback _callback);
+
+  /// \return Sharing statistics of the subscribed topics, keyed by fully
+  ///         qualified topic, e.g. "/topic".
+  std::map<std::string, TopicStats> Stats() const;
+
+  /// \return Sharing statistics of @p _topic, empty when not subscribed.
+  TopicStats Stats(const std::string& _topic) const;
+
+ private:
+  // Subscribers and statistics of a topic.
+  struct TopicEntry {
+    // Held while dispatching a message, so subscribers are not removed
+    // while their callbacks run.
+    std::mutex dispatchMutex;
+    std::map<uint64_t, MessageCallback> callbacks;
+    std::map<uint64_t, RawCallback> rawCallbacks;
+    TopicStats stats;
+  };
+
+  SubscriptionHub() = default;
+
+  // Returns the fully qualified name of @p _topic, the one transport reports
+  // in the MessageInfo, e.g. "/topic" for "topic". Returns an empty string
+  // when @p _topic is not a valid topic name.
+  std::string FullyQualifiedTopic(const std::string& _topic) const;
+
+  // Adds a subscriber to @p _topic, subscribing to it when needed.
+  std::unique_ptr<Subscription> Add(const std::string& _topic, MessageCallback _callback, RawCallback _rawCallback);
+
+  // Removes the subscriber @p _id of the fully qualified @p _topic, unsubscribing from it after
+  // the last one.
+  void Remove(const std::string& _topic, uint64_t _id);
+
+  // Transport callback of all topics.
+  void OnMessage(const char* _msgData, const size_t _size, const ignition::transport::MessageInfo& _info);
+
+  // Serializes transport subscriptions changes. Never held by callbacks.
+  std::mutex nodeMutex;
+
+  // Protects topics and nextId.
+  mutable std::mutex mutex;
+
+  // Subscribed topics, keyed by fully qualified name.
+  std::map<std::string, std::shared_ptr<TopicEntry>> topics;
+
+  uint64_t nextId{0};
+
+  ignition::transport::Node node;
+};
+
+}  // namespace gui
+}  // namespace delphyne
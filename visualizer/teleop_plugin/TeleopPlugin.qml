@@ -38,7 +38,7 @@ Rectangle {
   height: panel.implicitHeight + 10
   color: "transparent"
   Layout.minimumWidth: 290
-  Layout.minimumHeight: 200
+  Layout.minimumHeight: 380
 
   Keys.onPressed: {
     if (TeleopPlugin.isDriving) {
@@ -118,6 +118,16 @@ Rectangle {
           teleop.focus = true
         }
       }
+      // Followers of the driven agent
+      Label {
+        id: followersLabel
+        text: TeleopPlugin.followersText
+        visible: TeleopPlugin.followersText.length > 0
+        font.pointSize: 8
+        color: "gray"
+        Layout.columnSpan: 2
+        Layout.alignment: Qt.AlignLeft
+      }
       // Steering angle
       Label {
         text: "Steering Angle:"
@@ -160,6 +170,82 @@ Rectangle {
         font.weight: Font.DemiBold
         Layout.alignment: Qt.AlignRight
       }
+      // Teleop session record and replay
+      TextField {
+        id: sessionFileField
+        text: TeleopPlugin.sessionFile
+        selectByMouse: true
+        enabled: !TeleopPlugin.isRecording && !TeleopPlugin.isReplaying
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+      }
+      Button {
+        id: recordButton
+        text: TeleopPlugin.isRecording ? "Stop Recording" : "Record"
+        font.capitalization: Font.MixedCase
+        enabled: TeleopPlugin.isDriving && !TeleopPlugin.isReplaying
+        onClicked: {
+          TeleopPlugin.sessionFile = sessionFileField.text
+          TeleopPlugin.OnRecordSession()
+          teleop.focus = true
+        }
+      }
+      Button {
+        id: replayButton
+        text: TeleopPlugin.isReplaying ? "Stop Replay" : "Replay"
+        font.capitalization: Font.MixedCase
+        enabled: TeleopPlugin.isDriving && !TeleopPlugin.isRecording
+        onClicked: {
+          TeleopPlugin.sessionFile = sessionFileField.text
+          TeleopPlugin.OnReplaySession()
+          teleop.focus = true
+        }
+      }
+      Label {
+        id: sessionStatusLabel
+        text: TeleopPlugin.sessionStatus
+        visible: true
+        font.pointSize: 8
+        color: "gray"
+        Layout.columnSpan: 2
+        Layout.alignment: Qt.AlignLeft
+      }
+      // Control loop statistics
+      Label {
+        id: loopStatsLabel
+        text: TeleopPlugin.loopStats
+        visible: true
+        font.pointSize: 8
+        color: "gray"
+        Layout.columnSpan: 2
+        Layout.alignment: Qt.AlignLeft
+      }
+      // Command to effect latency
+      Label {
+        id: latencyStatsLabel
+        text: TeleopPlugin.latencyStats
+        visible: true
+        font.pointSize: 8
+        color: "gray"
+        Layout.columnSpan: 2
+        Layout.alignment: Qt.AlignLeft
+      }
+      // Latency histogram, 10 ms per bar, the last bar holds the overflow.
+      Row {
+        id: latencyHistogram
+        height: 30
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+        Repeater {
+          model: TeleopPlugin.latencyHistogram
+          Rectangle {
+            width: latencyHistogram.width / TeleopPlugin.latencyHistogram.length
+            height: latencyHistogram.height * modelData
+            anchors.bottom: parent.bottom
+            color: "steelblue"
+          }
+        }
+      }
     }
   }
 }
@@ -0,0 +1,133 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "latency_probe.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+// Speed, in m/s, under which the agent is considered stopped.
+constexpr double kStoppedSpeed{0.1};
+
+}  // namespace
+
+LatencyProbe::LatencyProbe(double _commandStep, const std::chrono::milliseconds& _timeout,
+                           const std::chrono::milliseconds& _bucketWidth, int _bucketCount)
+    : commandStep(_commandStep), timeout(_timeout), bucketWidth(_bucketWidth), histogram(_bucketCount, 0) {}
+
+void LatencyProbe::OnCommandSent(double _acceleration, const Clock::time_point& _time) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (probe.has_value()) {
+    if (_time - probe->sentTime <= timeout) {
+      return;
+    }
+    ++lost;
+    probe.reset();
+  }
+  if (std::abs(_acceleration - lastProbedAcceleration) < commandStep) {
+    return;
+  }
+  lastProbedAcceleration = _acceleration;
+  // A command close to what the agent already does has no visible effect.
+  if (std::abs(_acceleration - measuredAcceleration) < commandStep) {
+    return;
+  }
+  // Speed is a norm, a stopped agent cannot slow down any further.
+  if (_acceleration < measuredAcceleration && lastSpeed.has_value() && lastSpeed->second < kStoppedSpeed) {
+    return;
+  }
+  probe = Probe{_time, _acceleration, measuredAcceleration};
+}
+
+void LatencyProbe::OnAgentSpeed(double _speed, const Clock::time_point& _time) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (lastSpeed.has_value()) {
+    const double dt = std::chrono::duration<double>(_time - lastSpeed->first).count();
+    if (dt <= 0.) {
+      return;
+    }
+    measuredAcceleration = (_speed - lastSpeed->second) / dt;
+  }
+  lastSpeed = std::make_pair(_time, _speed);
+
+  if (!probe.has_value()) {
+    return;
+  }
+  if (_time - probe->sentTime > timeout) {
+    ++lost;
+    probe.reset();
+    return;
+  }
+  const double expectedChange = probe->commandedAcceleration - probe->baselineAcceleration;
+  const double measuredChange = measuredAcceleration - probe->baselineAcceleration;
+  if (measuredChange * expectedChange >= 0.5 * expectedChange * expectedChange) {
+    AddLatency(_time - probe->sentTime);
+    probe.reset();
+  } else if (expectedChange < 0. && _speed < kStoppedSpeed) {
+    // The agent stopped before the slow down could show, which is no loss.
+    probe.reset();
+  }
+}
+
+void LatencyProbe::AddLatency(const Clock::duration& _latency) {
+  const int64_t bucket = std::chrono::duration_cast<std::chrono::milliseconds>(_latency) / bucketWidth;
+  ++histogram[std::clamp<int64_t>(bucket, 0, histogram.size() - 1)];
+}
+
+LatencyProbe::Stats LatencyProbe::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats stats;
+  stats.histogram = histogram;
+  stats.lost = lost;
+  for (const uint64_t count : histogram) {
+    stats.count += count;
+  }
+  uint64_t accumulated{0};
+  bool hasP50{false};
+  for (size_t bucket = 0; bucket < histogram.size() && stats.count > 0; ++bucket) {
+    accumulated += histogram[bucket];
+    if (!hasP50 && 2 * accumulated >= stats.count) {
+      stats.p50 = bucketWidth * static_cast<int64_t>(bucket + 1);
+      hasP50 = true;
+    }
+    if (100 * accumulated >= 95 * stats.count) {
+      stats.p95 = bucketWidth * static_cast<int64_t>(bucket + 1);
+      break;
+    }
+  }
+  return stats;
+}
+
+}  // namespace gui
+}  // namespace delphyne
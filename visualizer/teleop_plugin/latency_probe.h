@@ -0,0 +1,134 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief Measures the time between a driving command and its effect on the
+///        driven agent motion.
+/// @details A probe starts when a command asks for an acceleration at least
+///          `commandStep` away from the one of the previous probe. The agent
+///          acceleration, derived from consecutive speed samples, is recorded
+///          as the baseline. The effect is detected when the measured
+///          acceleration covers half of the distance between the baseline and
+///          the commanded acceleration; the elapsed time is then added to the
+///          latency histogram. Commands whose effect cannot show, i.e. close
+///          to the measured acceleration or slowing down a stopped agent, are
+///          not probed, and slow down probes are dropped when the agent stops.
+///          Probes without effect after `timeout` are counted as lost. Only
+///          one probe is in flight at a time, commands sent meanwhile are not
+///          probed.
+///          All methods are thread safe.
+class LatencyProbe {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Latency statistics.
+  struct Stats {
+    /// Number of latencies in each `bucketWidth` wide bucket, the last bucket
+    /// holds the latencies beyond the histogram span.
+    std::vector<uint64_t> histogram;
+    /// Number of measured latencies.
+    uint64_t count{0};
+    /// Number of probes without effect.
+    uint64_t lost{0};
+    /// Latency percentiles, as the upper bound of their bucket.
+    std::chrono::milliseconds p50{0};
+    std::chrono::milliseconds p95{0};
+  };
+
+  /// @brief Constructs a probe.
+  /// @param _commandStep Minimum commanded acceleration change, in m/s^2, that
+  ///        starts a probe.
+  /// @param _timeout Time after which a probe without effect is lost.
+  /// @param _bucketWidth Width of each histogram bucket.
+  /// @param _bucketCount Number of histogram buckets, including the overflow
+  ///        one.
+  LatencyProbe(double _commandStep, const std::chrono::milliseconds& _timeout,
+               const std::chrono::milliseconds& _bucketWidth, int _bucketCount);
+
+  /// @brief Notifies that a command asking for @p _acceleration was sent at
+  ///        @p _time.
+  void OnCommandSent(double _acceleration, const Clock::time_point& _time);
+
+  /// @brief Notifies that the driven agent moved at @p _speed at @p _time.
+  void OnAgentSpeed(double _speed, const Clock::time_point& _time);
+
+  /// @return The latency statistics so far.
+  Stats GetStats() const;
+
+ private:
+  // A command waiting for its effect.
+  struct Probe {
+    Clock::time_point sentTime;
+    double commandedAcceleration{0.};
+    double baselineAcceleration{0.};
+  };
+
+  // Adds @p _latency to the histogram. `mutex` must be locked.
+  void AddLatency(const Clock::duration& _latency);
+
+  const double commandStep;
+  const std::chrono::milliseconds timeout;
+  const std::chrono::milliseconds bucketWidth;
+
+  // Latency histogram.
+  std::vector<uint64_t> histogram;
+
+  // Number of probes without effect.
+  uint64_t lost{0};
+
+  // The probe in flight, if any.
+  std::optional<Probe> probe;
+
+  // Commanded acceleration of the last probe.
+  double lastProbedAcceleration{0.};
+
+  // Latest agent speed sample.
+  std::optional<std::pair<Clock::time_point, double>> lastSpeed;
+
+  // Latest measured agent acceleration.
+  double measuredAcceleration{0.};
+
+  // Mutex to protect the members above between threads.
+  mutable std::mutex mutex;
+};
+
+}  // namespace gui
+}  // namespace delphyne
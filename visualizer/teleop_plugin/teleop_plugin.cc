@@ -33,11 +33,16 @@
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include <delphyne/protobuf/automotive_driving_command.pb.h>
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
 #include <ignition/plugin/Register.hh>
 
+#include "visualizer/plugin_metrics.hh"
+
 namespace delphyne {
 namespace gui {
 namespace {
@@ -53,9 +58,25 @@ void GetCurrentTime(int64_t* sec, int32_t* nsec) {
   *sec = (count - static_cast<int64_t>(*nsec)) / 1000000000l;
 }
 
+// Time spent on agent state updates, on the display timer and on each
+// control thread tick.
+const PluginMetrics::CounterHandle kAgentStateMetrics =
+    PluginMetrics::Instance()->Register("TeleopPlugin", "agent_state");
+const PluginMetrics::CounterHandle kTimerMetrics = PluginMetrics::Instance()->Register("TeleopPlugin", "timer");
+const PluginMetrics::CounterHandle kControlTickMetrics =
+    PluginMetrics::Instance()->Register("TeleopPlugin", "control_tick");
+
 }  // namespace
 
-TeleopPlugin::TeleopPlugin() { timer.start(kTimerPeriodInMs, this); }
+TeleopPlugin::TeleopPlugin() {
+  controlThread = std::thread(&TeleopPlugin::ControlLoop, this);
+  displayTimer.start(kDisplayPeriodInMs, this);
+}
+
+TeleopPlugin::~TeleopPlugin() {
+  stopControlThread = true;
+  controlThread.join();
+}
 
 void TeleopPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   if (title.empty()) {
@@ -66,52 +87,312 @@ void TeleopPlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
     if (auto agentChannel = _pluginElem->FirstChildElement("car_number")) {
       SetCarNumber(QString::fromStdString("teleop/" + std::string(agentChannel->GetText())));
     }
+    for (auto followerElem = _pluginElem->FirstChildElement("follower"); followerElem != nullptr;
+         followerElem = followerElem->NextSiblingElement("follower")) {
+      auto carNumberElem = followerElem->FirstChildElement("car_number");
+      if (carNumberElem == nullptr || carNumberElem->GetText() == nullptr) {
+        ignerr << "Ignoring a <follower> without <car_number>." << std::endl;
+        continue;
+      }
+      Follower follower;
+      follower.carNumber = "teleop/" + std::string(carNumberElem->GetText());
+      if (auto elem = followerElem->FirstChildElement("acceleration_offset")) {
+        elem->QueryDoubleText(&follower.accelerationOffset);
+      }
+      if (auto elem = followerElem->FirstChildElement("steering_offset")) {
+        elem->QueryDoubleText(&follower.steeringOffset);
+      }
+      followers.push_back(follower);
+    }
+    FollowersTextChanged();
+    if (auto sessionFileElem = _pluginElem->FirstChildElement("session_file")) {
+      if (sessionFileElem->GetText() != nullptr) {
+        SetSessionFile(QString::fromStdString(sessionFileElem->GetText()));
+      }
+    }
   } else {
     SetCarNumber("teleop/0");
   }
+  if (sessionFile.empty()) {
+    std::string homePath;
+    ignition::common::env("HOME", homePath);
+    SetSessionFile(
+        QString::fromStdString(ignition::common::joinPaths(homePath, ".delphyne", "teleop_session.bin")));
+  }
+  UpdateSessionStatus();
+}
+
+void TeleopPlugin::OnRecordSession() {
+  if (sessionMode == SessionMode::kRecording) {
+    sessionMode = SessionMode::kIdle;
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (session.Save(sessionFile, kTimerPeriodInMs)) {
+      ignmsg << "Teleop session of " << session.TickCount() << " ticks saved in [" << sessionFile << "]." << std::endl;
+    }
+  } else if (sessionMode == SessionMode::kIdle) {
+    {
+      std::lock_guard<std::mutex> lock(sessionMutex);
+      session.Clear();
+    }
+    resetValuesRequested = true;
+    sessionMode = SessionMode::kRecording;
+  }
+  UpdateSessionStatus();
+}
+
+void TeleopPlugin::OnReplaySession() {
+  if (sessionMode == SessionMode::kReplaying) {
+    sessionMode = SessionMode::kIdle;
+  } else if (sessionMode == SessionMode::kIdle) {
+    bool isLoaded{false};
+    {
+      std::lock_guard<std::mutex> lock(sessionMutex);
+      isLoaded = session.Load(sessionFile, kTimerPeriodInMs);
+    }
+    if (isLoaded) {
+      resetValuesRequested = true;
+      sessionMode = SessionMode::kReplaying;
+    }
+  }
+  UpdateSessionStatus();
+}
+
+void TeleopPlugin::UpdateSessionStatus() {
+  uint64_t tickCount{0};
+  {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    tickCount = session.TickCount();
+  }
+  QString newSessionStatus;
+  switch (sessionMode) {
+    case SessionMode::kIdle:
+      newSessionStatus = "Session: idle";
+      break;
+    case SessionMode::kRecording:
+      newSessionStatus = "Session: recording, " + QString::number(tickCount) + " ticks";
+      break;
+    case SessionMode::kReplaying:
+      newSessionStatus = "Session: replaying " + QString::number(tickCount) + " ticks";
+      break;
+  }
+  if (newSessionStatus == sessionStatus) {
+    return;
+  }
+  sessionStatus = newSessionStatus;
+  SessionStatusChanged();
+}
+
+QString TeleopPlugin::FollowersText() const {
+  QString text;
+  for (const Follower& follower : followers) {
+    text += (text.isEmpty() ? "Followers: " : ", ") + QString::fromStdString(follower.carNumber);
+  }
+  return text;
 }
 
 void TeleopPlugin::OnStartDriving() {
-  publisher = std::make_unique<ignition::transport::Node::Publisher>();
-  *publisher = node.Advertise<ignition::msgs::AutomotiveDrivingCommand>("/" + carNumber);
+  // Advertising takes a while, it is done before the publishers are handed to
+  // the control thread.
+  std::vector<CommandPublisher> newPublishers;
+  newPublishers.reserve(followers.size() + 1);
+  newPublishers.push_back(
+      CommandPublisher{node.Advertise<ignition::msgs::AutomotiveDrivingCommand>("/" + carNumber), 0., 0.});
+  for (const Follower& follower : followers) {
+    newPublishers.push_back(
+        CommandPublisher{node.Advertise<ignition::msgs::AutomotiveDrivingCommand>("/" + follower.carNumber),
+                         follower.accelerationOffset, follower.steeringOffset});
+  }
+  {
+    std::lock_guard<std::mutex> lock(publisherMutex);
+    publishers = std::move(newPublishers);
+  }
+
+  // Teleop channels are named "teleop/<X>" and agent states "/agent/<X>/state".
+  {
+    std::lock_guard<std::mutex> lock(agentNameMutex);
+    drivenAgentName = "/agent/" + carNumber.substr(carNumber.find('/') + 1) + "/state";
+  }
+  if (agentStateSubscription == nullptr) {
+    agentStateSubscription = SubscriptionHub::Instance()->Subscribe<ignition::msgs::AgentState_V>(
+        "agents/state", [this](const ignition::msgs::AgentState_V& _msg) { OnAgentState(_msg); });
+    if (agentStateSubscription == nullptr) {
+      ignerr << "Error subscribing to topic [agents/state], command latency is not measured." << std::endl;
+    }
+  }
+}
+
+void TeleopPlugin::OnAgentState(const ignition::msgs::AgentState_V& _msg) {
+  const PluginMetrics::Scope metrics(kAgentStateMetrics);
+  const auto now = LatencyProbe::Clock::now();
+  std::string agentName;
+  {
+    std::lock_guard<std::mutex> lock(agentNameMutex);
+    agentName = drivenAgentName;
+  }
+  for (const ignition::msgs::AgentState& agent : _msg.states()) {
+    if (agent.name() != agentName || !agent.has_linear_velocity()) {
+      continue;
+    }
+    const ignition::msgs::Vector3d& velocity = agent.linear_velocity();
+    latencyProbe.OnAgentSpeed(std::hypot(velocity.x(), velocity.y(), velocity.z()), now);
+    return;
+  }
+}
+
+void TeleopPlugin::UpdateLatencyStats() {
+  const LatencyProbe::Stats stats = latencyProbe.GetStats();
+  const QString newLatencyStats = "Latency: p50 " + QString::number(stats.p50.count()) + " ms, p95 " +
+                                  QString::number(stats.p95.count()) + " ms (" + QString::number(stats.count) +
+                                  " samples, " + QString::number(stats.lost) + " lost)";
+  if (newLatencyStats == latencyStats) {
+    return;
+  }
+  latencyStats = newLatencyStats;
+  const uint64_t maxCount = *std::max_element(stats.histogram.begin(), stats.histogram.end());
+  latencyHistogram.clear();
+  for (const uint64_t count : stats.histogram) {
+    latencyHistogram.append(maxCount > 0 ? static_cast<double>(count) / maxCount : 0.);
+  }
+  LatencyStatsChanged();
 }
 
 void TeleopPlugin::UpdateBrakeValue(double brakeGradient) {
   brakeValue = std::clamp(brakeValue + kBrakeScale * brakeGradient, kMinBrakeValue, kMaxBrakeValue);
-  BrakeValueChanged();
 }
 
 void TeleopPlugin::UpdateThrottleValue(double throttleGradient) {
   throttleValue = std::clamp(throttleValue + kThrottleScale * throttleGradient, kMinThrottleValue, kMaxBrakeValue);
-  ThrottleValueChanged();
 }
 
-void TeleopPlugin::UpdateSteeringAngle(double sign) {
-  steeringAngleValue = std::clamp(steeringAngleValue + kStepSteeringAngle * sign, kMinSteeringAngle, kMaxSteeringAngle);
-  SteeringAngleValueChanged();
-}
+void TeleopPlugin::UpdateSteeringAngle(double sign) { pendingSteeringSteps += sign > 0. ? 1 : -1; }
 
 void TeleopPlugin::timerEvent(QTimerEvent* _event) {
-  if (_event->timerId() != timer.timerId()) {
+  if (_event->timerId() != displayTimer.timerId()) {
     return;
   }
+  const PluginMetrics::Scope metrics(kTimerMetrics);
+  if (steeringAngleValue != shownSteeringAngleValue) {
+    shownSteeringAngleValue = steeringAngleValue;
+    SteeringAngleValueChanged();
+  }
+  if (throttleValue != shownThrottleValue) {
+    shownThrottleValue = throttleValue;
+    ThrottleValueChanged();
+  }
+  if (brakeValue != shownBrakeValue) {
+    shownBrakeValue = brakeValue;
+    BrakeValueChanged();
+  }
+
+  PeriodStats stats;
+  {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats = periodStats;
+  }
+  const QString newLoopStats = "Period: " + QString::number(stats.meanPeriodMs, 'f', 2) + " ms, jitter rms " +
+                               QString::number(stats.rmsJitterMs, 'f', 2) + " ms, max " +
+                               QString::number(stats.maxJitterMs, 'f', 2) + " ms";
+  if (newLoopStats != loopStats) {
+    loopStats = newLoopStats;
+    LoopStatsChanged();
+  }
+
+  UpdateLatencyStats();
+  UpdateSessionStatus();
+}
+
+void TeleopPlugin::ControlLoop() {
+  const std::chrono::milliseconds period(kTimerPeriodInMs);
+  std::vector<double> periodsMs;
+  periodsMs.reserve(kStatsWindowSize);
+  auto lastTick = std::chrono::steady_clock::now();
+  auto nextTick = lastTick + period;
+  while (!stopControlThread) {
+    std::this_thread::sleep_until(nextTick);
+    const auto now = std::chrono::steady_clock::now();
+    periodsMs.push_back(std::chrono::duration<double, std::milli>(now - lastTick).count());
+    lastTick = now;
+    // Ticks are not bunched up to make up for an overrun.
+    nextTick = std::max(nextTick + period, now);
+
+    ControlTick();
+
+    if (static_cast<int>(periodsMs.size()) == kStatsWindowSize) {
+      PeriodStats stats;
+      double squaredJitterSum{0.};
+      for (const double periodMs : periodsMs) {
+        const double jitterMs = std::abs(periodMs - kTimerPeriodInMs);
+        stats.meanPeriodMs += periodMs / kStatsWindowSize;
+        stats.maxJitterMs = std::max(stats.maxJitterMs, jitterMs);
+        squaredJitterSum += jitterMs * jitterMs;
+      }
+      stats.rmsJitterMs = std::sqrt(squaredJitterSum / kStatsWindowSize);
+      periodsMs.clear();
+      std::lock_guard<std::mutex> lock(statsMutex);
+      periodStats = stats;
+    }
+  }
+}
+
+void TeleopPlugin::ControlTick() {
+  const PluginMetrics::Scope metrics(kControlTickMetrics);
   if (!isDriving) {
     return;
   }
 
+  if (resetValuesRequested.exchange(false)) {
+    steeringAngleValue = 0.;
+    throttleValue = 0.;
+    brakeValue = 0.;
+  }
+
+  TeleopSession::KeyState keys;
+  keys.throttleKeyPressed = throttleKeyPressed;
+  keys.keepCurrentThrottle = keepCurrentThrottle;
+  keys.brakeKeyPressed = brakeKeyPressed;
+  keys.keepCurrentBrake = keepCurrentBrake;
+  keys.newSteeringAngle = newSteeringAngle.exchange(false);
+  keys.steeringSteps = pendingSteeringSteps.exchange(0);
+  switch (sessionMode) {
+    case SessionMode::kIdle:
+      break;
+    case SessionMode::kRecording: {
+      std::lock_guard<std::mutex> lock(sessionMutex);
+      session.Record(keys);
+      break;
+    }
+    case SessionMode::kReplaying: {
+      // Live keys are ignored while replaying.
+      std::lock_guard<std::mutex> lock(sessionMutex);
+      const std::optional<TeleopSession::KeyState> replayedKeys = session.ReplayNext();
+      if (replayedKeys.has_value()) {
+        keys = replayedKeys.value();
+      } else {
+        sessionMode = SessionMode::kIdle;
+      }
+      break;
+    }
+  }
+
+  if (keys.steeringSteps != 0) {
+    steeringAngleValue =
+        std::clamp(steeringAngleValue + kStepSteeringAngle * keys.steeringSteps, kMinSteeringAngle, kMaxSteeringAngle);
+  }
+  const bool hasNewSteeringAngle = keys.newSteeringAngle || keys.steeringSteps != 0;
+
   const double oldThrottleValue = throttleValue;
   const double oldBrakeValue = brakeValue;
 
-  if (!keepCurrentThrottle) {
-    UpdateThrottleValue(throttleKeyPressed ? 1.0 : -6.0);
+  if (!keys.keepCurrentThrottle) {
+    UpdateThrottleValue(keys.throttleKeyPressed ? 1.0 : -6.0);
   }
 
-  if (!keepCurrentBrake) {
-    UpdateBrakeValue(brakeKeyPressed ? 1.0 : -6.0);
+  if (!keys.keepCurrentBrake) {
+    UpdateBrakeValue(keys.brakeKeyPressed ? 1.0 : -6.0);
   }
 
   if (oldThrottleValue != throttleValue /* new throttle value */ || oldBrakeValue != brakeValue /* new brake value */ ||
-      newSteeringAngle /* new steering angle */) {
+      hasNewSteeringAngle) {
     ignition::msgs::AutomotiveDrivingCommand ignMsg;
 
     // Note: we don't set the header here since the bridge completely
@@ -122,15 +403,19 @@ void TeleopPlugin::timerEvent(QTimerEvent* _event) {
     ignMsg.mutable_time()->set_sec(sec);
     ignMsg.mutable_time()->set_nsec(nsec);
 
-    ignMsg.set_acceleration(throttleValue - brakeValue);
-    ignMsg.set_theta(steeringAngleValue);
+    const double acceleration = throttleValue - brakeValue;
+    const double theta = steeringAngleValue;
 
-    publisher->Publish(ignMsg);
-
-    SteeringAngleValueChanged();
-    ThrottleValueChanged();
-    BrakeValueChanged();
-    SetNewSteeringAngle(false);
+    // All the agents get the command of the same tick.
+    std::lock_guard<std::mutex> lock(publisherMutex);
+    for (CommandPublisher& commandPublisher : publishers) {
+      ignMsg.set_acceleration(acceleration + commandPublisher.accelerationOffset);
+      ignMsg.set_theta(std::clamp(theta + commandPublisher.steeringOffset, kMinSteeringAngle, kMaxSteeringAngle));
+      commandPublisher.publisher.Publish(ignMsg);
+    }
+    if (!publishers.empty()) {
+      latencyProbe.OnCommandSent(acceleration, LatencyProbe::Clock::now());
+    }
   }
 }
 
@@ -29,13 +29,23 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include <delphyne/protobuf/agent_state_v.pb.h>
 #include <ignition/gui/Plugin.hh>
 #include <ignition/transport.hh>
 
+#include "latency_probe.h"
+#include "teleop_session.h"
+#include "visualizer/subscription_hub.hh"
+
 namespace delphyne {
 namespace gui {
 
@@ -55,6 +65,25 @@ namespace gui {
 ///          both values will return to zero. However, that does not happen with
 ///          the steering control.
 ///          To "Stop Driving", click again the button.
+///          Commands are integrated and published from a dedicated thread
+///          paced by a steady clock, so a busy GUI thread does not make them
+///          jitter. Key states reach that thread through atomics and the view
+///          is refreshed from the GUI thread at a lower rate. The achieved
+///          loop period and its jitter are shown as statistics.
+///          While driving, a LatencyProbe correlates the commands sent with the
+///          speed of the driven agent in `agents/state` and the view shows the
+///          resulting command-to-effect latency histogram.
+///          The key states of each control tick can be recorded into a
+///          TeleopSession file and replayed later through the same integration
+///          code, producing the same command stream on every run. Both start
+///          from zeroed throttle, brake and steering. The file defaults to
+///          `$HOME/.delphyne/teleop_session.bin` and can be set with
+///          `<session_file>`.
+///          Other agents can follow the driven one: each `<follower>` element
+///          names a `<car_number>` that receives the same command plus an
+///          optional `<acceleration_offset>` and `<steering_offset>`. All the
+///          publishers are advertised on "Start Driving" and fed from the same
+///          control tick, so followers add no timer nor GUI work.
 class TeleopPlugin : public ignition::gui::Plugin {
   Q_OBJECT
 
@@ -81,26 +110,49 @@ class TeleopPlugin : public ignition::gui::Plugin {
 
   Q_PROPERTY(bool isDriving READ IsDriving WRITE SetIsDriving NOTIFY IsDrivingChanged)
 
+  Q_PROPERTY(QString loopStats READ LoopStats NOTIFY LoopStatsChanged)
+
+  Q_PROPERTY(QString latencyStats READ LatencyStats NOTIFY LatencyStatsChanged)
+
+  Q_PROPERTY(QVariantList latencyHistogram READ LatencyHistogram NOTIFY LatencyStatsChanged)
+
+  Q_PROPERTY(QString sessionFile READ SessionFile WRITE SetSessionFile NOTIFY SessionFileChanged)
+
+  Q_PROPERTY(QString sessionStatus READ SessionStatus NOTIFY SessionStatusChanged)
+
+  Q_PROPERTY(bool isRecording READ IsRecording NOTIFY SessionStatusChanged)
+
+  Q_PROPERTY(bool isReplaying READ IsReplaying NOTIFY SessionStatusChanged)
+
+  Q_PROPERTY(QString followersText READ FollowersText NOTIFY FollowersTextChanged)
+
  public:
   /// @brief Constructor.
-  /// @details Starts the timer and connects it to `timerEvent()`.
+  /// @details Starts the control thread and the view refresh timer.
   TeleopPlugin();
 
+  /// @brief Destructor.
+  /// @details Stops the control thread.
+  ~TeleopPlugin() override;
+
   /// @brief Loads the plugin configuration.
-  /// @details Expects to find `car_number` only which is translated to
-  //           `teleop/<car_number>` as topic name.
+  /// @details Expects to find `car_number` which is translated to
+  //           `teleop/<car_number>` as topic name, and optionally
+  //           `session_file`.
   void LoadConfig(const tinyxml2::XMLElement* _pluginElem) override;
 
-  Q_INVOKABLE QString BrakeValue() const { return QString::number(brakeValue, /* format */ 'f', /* precision */ 2); }
+  Q_INVOKABLE QString BrakeValue() const {
+    return QString::number(brakeValue.load(), /* format */ 'f', /* precision */ 2);
+  }
 
   Q_INVOKABLE QString CarNumber() const { return QString::fromStdString(carNumber); }
 
   Q_INVOKABLE QString SteeringAngleValue() const {
-    return QString::number(steeringAngleValue, /* format */ 'f', /* precision */ 2);
+    return QString::number(steeringAngleValue.load(), /* format */ 'f', /* precision */ 2);
   }
 
   Q_INVOKABLE QString ThrottleValue() const {
-    return QString::number(throttleValue, /* format */ 'f', /* precision */ 2);
+    return QString::number(throttleValue.load(), /* format */ 'f', /* precision */ 2);
   }
 
   Q_INVOKABLE bool NewSteeringAngle() const { return newSteeringAngle; }
@@ -115,6 +167,27 @@ class TeleopPlugin : public ignition::gui::Plugin {
 
   Q_INVOKABLE bool IsDriving() const { return isDriving; }
 
+  Q_INVOKABLE QString LoopStats() const { return loopStats; }
+
+  Q_INVOKABLE QString LatencyStats() const { return latencyStats; }
+
+  Q_INVOKABLE QVariantList LatencyHistogram() const { return latencyHistogram; }
+
+  Q_INVOKABLE QString SessionFile() const { return QString::fromStdString(sessionFile); }
+
+  Q_INVOKABLE QString SessionStatus() const { return sessionStatus; }
+
+  Q_INVOKABLE bool IsRecording() const { return sessionMode == SessionMode::kRecording; }
+
+  Q_INVOKABLE bool IsReplaying() const { return sessionMode == SessionMode::kReplaying; }
+
+  Q_INVOKABLE QString FollowersText() const;
+
+  Q_INVOKABLE void SetSessionFile(const QString& _sessionFile) {
+    sessionFile = _sessionFile.toStdString();
+    SessionFileChanged();
+  }
+
   Q_INVOKABLE void SetNewSteeringAngle(bool _newSteeringAngle) {
     newSteeringAngle = _newSteeringAngle;
     NewSteeringAngleChanged();
@@ -170,7 +243,15 @@ class TeleopPlugin : public ignition::gui::Plugin {
   /// @brief Callback in Qt thread when start driving is clicked.
   void OnStartDriving();
 
+  /// @brief Starts recording the key states, or stops and saves the session
+  ///        into `sessionFile` when already recording.
+  void OnRecordSession();
+
+  /// @brief Starts replaying `sessionFile`, or stops when already replaying.
+  void OnReplaySession();
+
   /// @brief Updates the steering angle from the plugin UI.
+  /// @details The step is applied by the control thread on its next tick.
   /// @param sign It should be either 1.0 or -1.0 to move the handle wheel.
   void UpdateSteeringAngle(double sign);
 
@@ -187,11 +268,16 @@ class TeleopPlugin : public ignition::gui::Plugin {
   void BrakeKeyPressedChanged();
   void KeepCurrentBrakeChanged();
   void IsDrivingChanged();
+  void LoopStatsChanged();
+  void LatencyStatsChanged();
+  void SessionFileChanged();
+  void SessionStatusChanged();
+  void FollowersTextChanged();
   /// @} Signals to notify that properties changed.
 
  protected:
-  /// @brief Timer event callback which handles the logic of publishing driving
-  ///        commands.
+  /// @brief Timer event callback which refreshes the view with the values
+  ///        computed by the control thread.
   void timerEvent(QTimerEvent* event) override;
 
  private:
@@ -212,8 +298,77 @@ class TeleopPlugin : public ignition::gui::Plugin {
   static constexpr double kMaxBrakeValue{kMaxVelocity};
 
   static constexpr int kTimerPeriodInMs{10};
+
+  static constexpr int kDisplayPeriodInMs{50};
+
+  // Number of control loop periods over which the statistics are computed.
+  static constexpr int kStatsWindowSize{100};
+
+  // Commanded acceleration change, in m/s^2, that starts a latency probe.
+  static constexpr double kLatencyCommandStep{1.0};
+
+  static constexpr int kLatencyTimeoutInMs{2000};
+
+  static constexpr int kLatencyBucketInMs{10};
+
+  // 500ms span plus the overflow bucket.
+  static constexpr int kLatencyBucketCount{51};
   /// @} Constants used in the implementation.
 
+  /// @brief What the control thread does with the teleop session.
+  enum class SessionMode { kIdle, kRecording, kReplaying };
+
+  /// @brief An agent that mirrors the driven one.
+  struct Follower {
+    /// @brief The follower car number, e.g. "teleop/1".
+    std::string carNumber;
+    /// @brief Added to the commanded acceleration, in m/s^2.
+    double accelerationOffset{0.};
+    /// @brief Added to the commanded steering angle, in radians.
+    double steeringOffset{0.};
+  };
+
+  /// @brief A pre-advertised command publisher and the offsets applied to the
+  ///        commands it sends.
+  struct CommandPublisher {
+    /// @brief Publisher of the driving commands of a car, advertised on
+    ///        "/<car number>".
+    ignition::transport::Node::Publisher publisher;
+    /// @brief Added to the commanded acceleration, in m/s^2. Zero for the
+    ///        driven car.
+    double accelerationOffset{0.};
+    /// @brief Added to the commanded steering angle, in radians. Zero for the
+    ///        driven car.
+    double steeringOffset{0.};
+  };
+
+  /// @brief Control loop period statistics over the last `kStatsWindowSize`
+  ///        periods.
+  struct PeriodStats {
+    double meanPeriodMs{0.};
+    double rmsJitterMs{0.};
+    double maxJitterMs{0.};
+  };
+
+  /// @brief Body of the control thread. It ticks every `kTimerPeriodInMs`
+  ///        until `stopControlThread` is set.
+  void ControlLoop();
+
+  /// @brief Integrates the key states, live or replayed, and publishes a
+  ///        command when it changed. It runs in the control thread.
+  void ControlTick();
+
+  /// @brief Refreshes the session status shown in the view.
+  void UpdateSessionStatus();
+
+  /// @brief Feeds the speed of the driven agent to `latencyProbe`. It runs in
+  ///        a transport thread.
+  /// @param _msg The state of all the agents.
+  void OnAgentState(const ignition::msgs::AgentState_V& _msg);
+
+  /// @brief Refreshes the latency statistics shown in the view.
+  void UpdateLatencyStats();
+
   /// @brief Updates the throttle value.
   /// @param throttleGradient The value to increase the throttle.
   void UpdateThrottleValue(double throttleGradient);
@@ -225,34 +380,106 @@ class TeleopPlugin : public ignition::gui::Plugin {
   /// @{ QProperties.
   std::string carNumber;
 
-  double steeringAngleValue{0.0};
+  // Updated by the control thread, read by the view.
+  std::atomic<double> steeringAngleValue{0.0};
+
+  // Updated by the control thread, read by the view.
+  std::atomic<double> throttleValue{0.0};
+
+  // Updated by the control thread, read by the view.
+  std::atomic<double> brakeValue{0.0};
+
+  std::atomic<bool> newSteeringAngle{false};
+
+  std::atomic<bool> throttleKeyPressed{false};
 
-  double throttleValue{0.0};
+  std::atomic<bool> keepCurrentThrottle{false};
 
-  double brakeValue{0.0};
+  std::atomic<bool> brakeKeyPressed{false};
 
-  bool newSteeringAngle{false};
+  std::atomic<bool> keepCurrentBrake{false};
 
-  bool throttleKeyPressed{false};
+  std::atomic<bool> isDriving{false};
 
-  bool keepCurrentThrottle{false};
+  QString loopStats;
 
-  bool brakeKeyPressed{false};
+  QString latencyStats;
 
-  bool keepCurrentBrake{false};
+  QVariantList latencyHistogram;
 
-  bool isDriving{false};
+  std::string sessionFile;
+
+  QString sessionStatus;
   /// @} QProperties.
 
-  /// @brief Triggers an event every `kTimerPeriodInMs` to process the command
-  ///        to send to the agent.
-  QBasicTimer timer;
+  /// @{ Values last shown in the view.
+  double shownSteeringAngleValue{0.0};
+
+  double shownThrottleValue{0.0};
+
+  double shownBrakeValue{0.0};
+  /// @}
+
+  /// @brief Steering steps requested by the view and not yet applied by the
+  ///        control thread, signed.
+  std::atomic<int> pendingSteeringSteps{0};
+
+  /// @brief Triggers an event every `kDisplayPeriodInMs` to refresh the view.
+  QBasicTimer displayTimer;
 
   /// @brief Transport node.
   ignition::transport::Node node;
 
-  /// @brief Transport publisher.
-  std::unique_ptr<ignition::transport::Node::Publisher> publisher;
+  /// @brief Agents that follow the driven one.
+  std::vector<Follower> followers;
+
+  /// @brief Transport publishers, the driven agent first and then its
+  ///        followers, protected by `publisherMutex`.
+  std::vector<CommandPublisher> publishers;
+
+  /// @brief Mutex to protect `publishers` between threads.
+  std::mutex publisherMutex;
+
+  /// @brief Name of the driven agent in `agents/state`, protected by
+  ///        `agentNameMutex`.
+  std::string drivenAgentName;
+
+  /// @brief Mutex to protect `drivenAgentName` between threads.
+  std::mutex agentNameMutex;
+
+  /// @brief Correlates commands with the driven agent motion.
+  LatencyProbe latencyProbe{kLatencyCommandStep, std::chrono::milliseconds(kLatencyTimeoutInMs),
+                            std::chrono::milliseconds(kLatencyBucketInMs), kLatencyBucketCount};
+
+  /// @brief Subscription to `agents/state`, shared with the other plugins.
+  /// @details Declared after the members its callback uses, so it is
+  ///          destroyed before them.
+  std::unique_ptr<SubscriptionHub::Subscription> agentStateSubscription;
+
+  /// @brief Recorded or replayed key states, protected by `sessionMutex`.
+  TeleopSession session;
+
+  /// @brief Mutex to protect `session` between threads.
+  std::mutex sessionMutex;
+
+  /// @brief Whether the session is recorded, replayed or neither.
+  std::atomic<SessionMode> sessionMode{SessionMode::kIdle};
+
+  /// @brief Whether the control thread must zero the command values before
+  ///        its next tick.
+  std::atomic<bool> resetValuesRequested{false};
+
+  /// @brief Latest control loop statistics, protected by `statsMutex`.
+  PeriodStats periodStats;
+
+  /// @brief Mutex to protect `periodStats` between threads.
+  std::mutex statsMutex;
+
+  /// @brief Whether the control thread must stop.
+  std::atomic<bool> stopControlThread{false};
+
+  /// @brief Integrates and publishes the driving commands.
+  std::thread controlThread;
 };
 
 }  // namespace gui
@@ -0,0 +1,207 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "teleop_session.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+namespace delphyne {
+namespace gui {
+namespace {
+
+constexpr char kMagic[4] = {'D', 'T', 'S', 'N'};
+constexpr uint32_t kVersion{1};
+
+// File header.
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t tickPeriodMs;
+  uint32_t eventCount;
+  uint64_t tickCount;
+};
+
+// A stored tick, as written in the file.
+struct FileEvent {
+  uint32_t tick;
+  uint8_t flags;
+  uint8_t reserved;
+  int16_t steeringSteps;
+};
+
+enum Flags : uint8_t {
+  kThrottleKeyPressed = 1 << 0,
+  kKeepCurrentThrottle = 1 << 1,
+  kBrakeKeyPressed = 1 << 2,
+  kKeepCurrentBrake = 1 << 3,
+  kNewSteeringAngle = 1 << 4,
+};
+
+}  // namespace
+
+void TeleopSession::Clear() {
+  events.clear();
+  tickCount = 0;
+  Rewind();
+}
+
+bool TeleopSession::IsEvent(const KeyState& _state, const KeyState& _previous) {
+  return _state.steeringSteps != 0 || _state.newSteeringAngle ||
+         _state.throttleKeyPressed != _previous.throttleKeyPressed ||
+         _state.keepCurrentThrottle != _previous.keepCurrentThrottle ||
+         _state.brakeKeyPressed != _previous.brakeKeyPressed || _state.keepCurrentBrake != _previous.keepCurrentBrake;
+}
+
+void TeleopSession::Record(const KeyState& _state) {
+  const KeyState previous = events.empty() ? KeyState{} : events.back().state;
+  if (IsEvent(_state, previous)) {
+    events.push_back(Event{tickCount, _state});
+  }
+  ++tickCount;
+}
+
+std::optional<TeleopSession::KeyState> TeleopSession::ReplayNext() {
+  if (replayTick >= tickCount) {
+    return std::nullopt;
+  }
+  KeyState state = replayState;
+  state.steeringSteps = 0;
+  state.newSteeringAngle = false;
+  if (replayEvent < events.size() && events[replayEvent].tick == replayTick) {
+    state = events[replayEvent].state;
+    ++replayEvent;
+  }
+  replayState = state;
+  ++replayTick;
+  return state;
+}
+
+void TeleopSession::Rewind() {
+  replayTick = 0;
+  replayEvent = 0;
+  replayState = KeyState{};
+}
+
+uint64_t TeleopSession::TickCount() const { return tickCount; }
+
+bool TeleopSession::Save(const std::string& _path, int _tickPeriodMs) const {
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.tickPeriodMs = static_cast<uint32_t>(_tickPeriodMs);
+  header.eventCount = static_cast<uint32_t>(events.size());
+  header.tickCount = tickCount;
+
+  // The default session file lives in $HOME/.delphyne, which may not exist
+  // yet.
+  const std::string directory = ignition::common::parentPath(_path);
+  if (!directory.empty() && directory != _path && !ignition::common::createDirectories(directory)) {
+    ignerr << "Unable to create directory [" << directory << "] for teleop session [" << _path << "]." << std::endl;
+    return false;
+  }
+
+  std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const Event& event : events) {
+    const FileEvent fileEvent{
+        static_cast<uint32_t>(event.tick),
+        static_cast<uint8_t>((event.state.throttleKeyPressed ? kThrottleKeyPressed : 0) |
+                             (event.state.keepCurrentThrottle ? kKeepCurrentThrottle : 0) |
+                             (event.state.brakeKeyPressed ? kBrakeKeyPressed : 0) |
+                             (event.state.keepCurrentBrake ? kKeepCurrentBrake : 0) |
+                             (event.state.newSteeringAngle ? kNewSteeringAngle : 0)),
+        0, static_cast<int16_t>(event.state.steeringSteps)};
+    file.write(reinterpret_cast<const char*>(&fileEvent), sizeof(fileEvent));
+  }
+  if (!file) {
+    ignerr << "Unable to write teleop session [" << _path << "]." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TeleopSession::Load(const std::string& _path, int _tickPeriodMs) {
+  std::ifstream file(_path, std::ios::binary | std::ios::ate);
+  const std::streamoff fileSize = file ? static_cast<std::streamoff>(file.tellg()) : 0;
+  file.seekg(0);
+  FileHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    ignerr << "[" << _path << "] is not a teleop session." << std::endl;
+    return false;
+  }
+  if (header.tickPeriodMs != static_cast<uint32_t>(_tickPeriodMs)) {
+    ignerr << "Teleop session [" << _path << "] was recorded at " << header.tickPeriodMs << "ms ticks, expected "
+           << _tickPeriodMs << "ms." << std::endl;
+    return false;
+  }
+  // The event count is checked against the file size before reserving, so a
+  // corrupt header can't request an arbitrary allocation.
+  const uint64_t eventBytes = static_cast<uint64_t>(fileSize) - sizeof(header);
+  if (static_cast<uint64_t>(header.eventCount) * sizeof(FileEvent) > eventBytes) {
+    ignerr << "Teleop session [" << _path << "] is truncated." << std::endl;
+    return false;
+  }
+  std::vector<Event> newEvents;
+  newEvents.reserve(header.eventCount);
+  for (uint32_t i = 0; i < header.eventCount; ++i) {
+    FileEvent fileEvent;
+    if (!file.read(reinterpret_cast<char*>(&fileEvent), sizeof(fileEvent))) {
+      ignerr << "Teleop session [" << _path << "] is truncated." << std::endl;
+      return false;
+    }
+    // Replay walks the events in tick order, one per tick at most.
+    if (fileEvent.tick >= header.tickCount || (!newEvents.empty() && fileEvent.tick <= newEvents.back().tick)) {
+      ignerr << "Teleop session [" << _path << "] has events out of order." << std::endl;
+      return false;
+    }
+    KeyState state;
+    state.throttleKeyPressed = fileEvent.flags & kThrottleKeyPressed;
+    state.keepCurrentThrottle = fileEvent.flags & kKeepCurrentThrottle;
+    state.brakeKeyPressed = fileEvent.flags & kBrakeKeyPressed;
+    state.keepCurrentBrake = fileEvent.flags & kKeepCurrentBrake;
+    state.newSteeringAngle = fileEvent.flags & kNewSteeringAngle;
+    state.steeringSteps = fileEvent.steeringSteps;
+    newEvents.push_back(Event{fileEvent.tick, state});
+  }
+  events = std::move(newEvents);
+  tickCount = header.tickCount;
+  Rewind();
+  return true;
+}
+
+}  // namespace gui
+}  // namespace delphyne
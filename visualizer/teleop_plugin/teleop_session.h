@@ -0,0 +1,117 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+
+/// @brief A recorded stream of teleop key states, indexed by control tick.
+/// @details Only the ticks at which the key states change, or at which the
+///          steering is moved, are stored. Sessions are saved in a compact
+///          binary file: a header followed by 8 bytes per stored tick.
+///          This class is not thread safe.
+class TeleopSession {
+ public:
+  /// @brief The teleop inputs of a control tick.
+  struct KeyState {
+    bool throttleKeyPressed{false};
+    bool keepCurrentThrottle{false};
+    bool brakeKeyPressed{false};
+    bool keepCurrentBrake{false};
+    bool newSteeringAngle{false};
+    /// Signed number of steering steps applied during the tick.
+    int steeringSteps{0};
+  };
+
+  /// @brief Drops the recorded states and rewinds the replay.
+  void Clear();
+
+  /// @brief Appends the inputs of the next tick.
+  void Record(const KeyState& _state);
+
+  /// @return The inputs of the next tick to replay, or nullopt when the
+  ///         whole session was replayed.
+  std::optional<KeyState> ReplayNext();
+
+  /// @brief Restarts the replay from the first tick.
+  void Rewind();
+
+  /// @return The number of recorded ticks.
+  uint64_t TickCount() const;
+
+  /// @brief Writes the session to @p _path, creating its directory if needed.
+  /// @param _path The file to write.
+  /// @param _tickPeriodMs The control tick period the session was recorded at.
+  /// @return false when the file cannot be written.
+  bool Save(const std::string& _path, int _tickPeriodMs) const;
+
+  /// @brief Replaces the session with the one stored at @p _path.
+  /// @param _path The file to read.
+  /// @param _tickPeriodMs The control tick period the session will be
+  ///        replayed at. Sessions recorded at another period are rejected.
+  /// @return false when the file cannot be read or it is not compatible.
+  bool Load(const std::string& _path, int _tickPeriodMs);
+
+ private:
+  // A stored tick.
+  struct Event {
+    uint64_t tick{0};
+    KeyState state;
+  };
+
+  // Whether @p _state changes the held keys of @p _previous or moves the
+  // steering.
+  static bool IsEvent(const KeyState& _state, const KeyState& _previous);
+
+  // Stored ticks, in tick order.
+  std::vector<Event> events;
+
+  // Number of recorded ticks.
+  uint64_t tickCount{0};
+
+  // Next tick to replay.
+  uint64_t replayTick{0};
+
+  // Next event to replay.
+  size_t replayEvent{0};
+
+  // Held keys of the last replayed tick.
+  KeyState replayState;
+};
+
+}  // namespace gui
+}  // namespace delphyne
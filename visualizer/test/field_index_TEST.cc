@@ -0,0 +1,193 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/topic_interface_plugin/field_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+using internal::FieldIndex;
+
+// No limit on the number of results.
+constexpr size_t kAllResults{1000000};
+
+// @return A lower case copy of @p _str.
+std::string ToLower(std::string _str) {
+  std::transform(_str.begin(), _str.end(), _str.begin(),
+                 [](unsigned char _c) { return static_cast<char>(std::tolower(_c)); });
+  return _str;
+}
+
+// A field of the reference linear search.
+struct Field {
+  std::string path;
+  std::string value;
+};
+
+// @return The paths of @p _fields whose path or value contain @p _query, in
+//         insertion order.
+std::vector<std::string> LinearSubstring(const std::vector<Field>& _fields, const std::string& _query) {
+  const std::string query = ToLower(_query);
+  std::vector<std::string> paths;
+  for (const Field& field : _fields) {
+    if (ToLower(field.path).find(query) != std::string::npos || ToLower(field.value).find(query) != std::string::npos) {
+      paths.push_back(field.path);
+    }
+  }
+  return paths;
+}
+
+// A tree of 5000 fields, 625 agents of 8 fields, as large as the ones
+// the topic interface shows.
+std::vector<Field> AgentFields(std::mt19937* _generator) {
+  static const char* kNames[]{"x", "y", "z", "Velocity", "heading", "name", "lane_id", "s"};
+  std::uniform_real_distribution<double> value(-1000., 1000.);
+  std::vector<Field> fields;
+  for (int agent = 1; agent <= 625; ++agent) {
+    for (const char* name : kNames) {
+      fields.push_back(Field{"agents::" + std::to_string(agent) + "::" + name, std::to_string(value(*_generator))});
+    }
+  }
+  return fields;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks queries on an empty index.
+TEST(FieldIndex, Empty) {
+  const FieldIndex index;
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_TRUE(index.FindSubstring("pose", kAllResults).empty());
+  EXPECT_TRUE(index.FindPrefix("pose", kAllResults).empty());
+}
+
+/// \brief Checks case insensitive substring queries over paths and values.
+TEST(FieldIndex, Substring) {
+  FieldIndex index;
+  index.Update("model::1::Pose::x", "1.5");
+  index.Update("model::1::Pose::y", "-2.25");
+  index.Update("model::1::name", "Prius");
+  index.Update("header::stamp", "");
+  EXPECT_EQ(4u, index.Size());
+
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x", "model::1::Pose::y"}), index.FindSubstring("pose", 10));
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x", "model::1::Pose::y"}), index.FindSubstring("POSE::", 10));
+  // Short queries, below the trigram size.
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x"}), index.FindSubstring(":x", 10));
+  // Values.
+  EXPECT_EQ((std::vector<std::string>{"model::1::name"}), index.FindSubstring("prius", 10));
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::y"}), index.FindSubstring("2.2", 10));
+  // Paths and values, each field once, in insertion order.
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x", "model::1::Pose::y", "model::1::name", "header::stamp"}),
+            index.FindSubstring("s", 10));
+  EXPECT_TRUE(index.FindSubstring("missing", 10).empty());
+  EXPECT_TRUE(index.FindSubstring("", 10).empty());
+}
+
+/// \brief Checks prefix queries over full paths and their last element.
+TEST(FieldIndex, Prefix) {
+  FieldIndex index;
+  index.Update("model::1::Pose::x", "1.5");
+  index.Update("model::2::Pose::x", "3.5");
+  index.Update("header::stamp", "");
+  index.Update("header::sequence", "12");
+
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x", "model::2::Pose::x"}), index.FindPrefix("model::", 10));
+  EXPECT_EQ((std::vector<std::string>{"model::2::Pose::x"}), index.FindPrefix("Model::2", 10));
+  EXPECT_EQ((std::vector<std::string>{"header::stamp", "header::sequence"}), index.FindPrefix("s", 10));
+  EXPECT_EQ((std::vector<std::string>{"model::1::Pose::x", "model::2::Pose::x"}), index.FindPrefix("x", 10));
+  // Not a prefix of the path nor of its last element.
+  EXPECT_TRUE(index.FindPrefix("pose", 10).empty());
+  // Values are not matched.
+  EXPECT_TRUE(index.FindPrefix("12", 10).empty());
+}
+
+/// \brief Checks that updated values are found by their new value only.
+TEST(FieldIndex, Updates) {
+  FieldIndex index;
+  index.Update("agent::speed", "10.5");
+  index.Update("agent::speed", "42.0");
+  EXPECT_EQ(1u, index.Size());
+  EXPECT_TRUE(index.FindSubstring("10.5", 10).empty());
+  EXPECT_EQ((std::vector<std::string>{"agent::speed"}), index.FindSubstring("42", 10));
+}
+
+/// \brief Checks that removed fields are not found until updated again.
+TEST(FieldIndex, Removal) {
+  FieldIndex index;
+  index.Update("agents::1::x", "1.0");
+  index.Update("agents::2::x", "2.0");
+  index.Remove("agents::2::x");
+  index.Remove("agents::3::x");
+  EXPECT_EQ(1u, index.Size());
+  EXPECT_EQ((std::vector<std::string>{"agents::1::x"}), index.FindSubstring("agents", 10));
+  EXPECT_EQ((std::vector<std::string>{"agents::1::x"}), index.FindPrefix("x", 10));
+  EXPECT_TRUE(index.FindSubstring("2.0", 10).empty());
+
+  index.Update("agents::2::x", "3.0");
+  EXPECT_EQ(2u, index.Size());
+  EXPECT_EQ((std::vector<std::string>{"agents::1::x", "agents::2::x"}), index.FindSubstring("agents", 10));
+  EXPECT_EQ((std::vector<std::string>{"agents::2::x"}), index.FindSubstring("3.0", 10));
+}
+
+/// \brief Checks that results are capped, keeping the first inserted ones,
+///        and that removed fields do not take room in the results.
+TEST(FieldIndex, ResultCap) {
+  FieldIndex index;
+  for (int i = 0; i < 10; ++i) {
+    index.Update("agents::" + std::to_string(i) + "::x", "0");
+  }
+  EXPECT_EQ((std::vector<std::string>{"agents::0::x", "agents::1::x", "agents::2::x"}),
+            index.FindSubstring("agents", 3));
+  EXPECT_EQ((std::vector<std::string>{"agents::0::x", "agents::1::x"}), index.FindPrefix("x", 2));
+  EXPECT_TRUE(index.FindSubstring("agents", 0).empty());
+
+  index.Remove("agents::0::x");
+  EXPECT_EQ((std::vector<std::string>{"agents::1::x", "agents::2::x", "agents::3::x"}),
+            index.FindSubstring("agents", 3));
+}
+
+/// \brief Checks substring queries against a linear search on a 5000 fields
+///        tree, whose values change as messages arrive.
+TEST(FieldIndex, SubstringMatchesLinearSearch) {
+  std::mt19937 generator(42);
+  std::vector<Field> fields = AgentFields(&generator);
+  FieldIndex index;
+  for (const Field& field : fields) {
+    index.Update(field.path, field.value);
+  }
+  ASSERT_EQ(fields.size(), index.Size());
+
+  const std::vector<std::string> queries{"a", "x", "::1", "velo", "agents::42::", "lane_id", "12", "-3", ".5", "::z"};
+  for (int update = 0; update < 3; ++update) {
+    for (const std::string& query : queries) {
+      EXPECT_EQ(LinearSubstring(fields, query), index.FindSubstring(query, kAllResults)) << query;
+    }
+    std::uniform_real_distribution<double> value(-1000., 1000.);
+    for (Field& field : fields) {
+      field.value = std::to_string(value(generator));
+      index.Update(field.path, field.value);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,129 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/field_path.hh"
+
+#include <stdexcept>
+#include <string>
+
+#include <ignition/msgs/geometry.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that scalar fields are read through nested and repeated
+///        fields.
+TEST(FieldPath, ReadsScalars) {
+  ignition::msgs::Pose_V poses;
+  poses.mutable_header()->mutable_stamp()->set_sec(12);
+  for (int i = 0; i < 3; ++i) {
+    ignition::msgs::Pose* pose = poses.add_pose();
+    pose->set_name("agent_" + std::to_string(i));
+    pose->set_id(i);
+    pose->mutable_position()->set_x(1.5 * i);
+  }
+  ignition::msgs::Header::Map* data = poses.mutable_header()->add_data();
+  data->set_key("frame");
+  data->add_value("world");
+
+  const google::protobuf::Descriptor* descriptor = poses.GetDescriptor();
+
+  const FieldPath x(descriptor, "pose::2::position::x");
+  EXPECT_EQ(x.Path(), "pose::2::position::x");
+  EXPECT_EQ(x.MessageType(), descriptor);
+  EXPECT_EQ(x.Field()->name(), "x");
+  ASSERT_TRUE(x.Read(poses).has_value());
+  EXPECT_EQ(std::get<double>(*x.Read(poses)), 3.);
+  EXPECT_EQ(x.ReadDouble(poses), 3.);
+
+  const FieldPath name(descriptor, "pose::1::name");
+  EXPECT_EQ(std::get<std::string>(*name.Read(poses)), "agent_1");
+  EXPECT_FALSE(name.ReadDouble(poses).has_value());
+
+  const FieldPath id(descriptor, "pose::1::id");
+  EXPECT_EQ(std::get<uint64_t>(*id.Read(poses)), 1u);
+  EXPECT_EQ(FieldPath::ToString(*id.Read(poses)), "1");
+
+  const FieldPath sec(descriptor, "header::stamp::sec");
+  EXPECT_EQ(std::get<int64_t>(*sec.Read(poses)), 12);
+  EXPECT_EQ(sec.ReadDouble(poses), 12.);
+
+  const FieldPath value(descriptor, "header::data::0::value::0");
+  EXPECT_EQ(std::get<std::string>(*value.Read(poses)), "world");
+
+  // Unset submessages read as their defaults.
+  const FieldPath z(descriptor, "pose::0::orientation::z");
+  EXPECT_EQ(std::get<double>(*z.Read(poses)), 0.);
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that enums are read by name, and by number as doubles.
+TEST(FieldPath, ReadsEnums) {
+  ignition::msgs::Geometry geometry;
+  geometry.set_type(ignition::msgs::Geometry::SPHERE);
+
+  const FieldPath type(geometry.GetDescriptor(), "type");
+  EXPECT_EQ(std::get<std::string>(*type.Read(geometry)), "SPHERE");
+  EXPECT_EQ(type.ReadDouble(geometry), static_cast<double>(ignition::msgs::Geometry::SPHERE));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that out of range indices read nothing.
+TEST(FieldPath, OutOfRangeIndices) {
+  ignition::msgs::Pose_V poses;
+  poses.add_pose()->mutable_header()->add_data()->set_key("frame");
+
+  const FieldPath x(poses.GetDescriptor(), "pose::1::position::x");
+  EXPECT_FALSE(x.Read(poses).has_value());
+  EXPECT_FALSE(x.ReadDouble(poses).has_value());
+
+  const FieldPath value(poses.GetDescriptor(), "pose::0::header::data::0::value::0");
+  EXPECT_FALSE(value.Read(poses).has_value());
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that invalid paths and message types throw.
+TEST(FieldPath, InvalidPaths) {
+  const google::protobuf::Descriptor* descriptor = ignition::msgs::Pose_V::descriptor();
+
+  EXPECT_THROW(FieldPath(nullptr, "pose::0::name"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, ""), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "poses::0::name"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::name"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::0"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::-1::name"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::0::position"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::0::name::x"), std::runtime_error);
+  EXPECT_THROW(FieldPath(descriptor, "pose::0::position::x::"), std::runtime_error);
+
+  const FieldPath name(descriptor, "pose::0::name");
+  EXPECT_THROW(name.Read(ignition::msgs::Pose()), std::runtime_error);
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that compiled paths are shared per message type.
+TEST(FieldPath, Compiled) {
+  const auto x = FieldPath::Compiled(ignition::msgs::Pose_V::descriptor(), "pose::0::position::x");
+  EXPECT_EQ(x, FieldPath::Compiled(ignition::msgs::Pose_V::descriptor(), "pose::0::position::x"));
+  EXPECT_NE(x, FieldPath::Compiled(ignition::msgs::Pose::descriptor(), "position::x"));
+  EXPECT_THROW(FieldPath::Compiled(ignition::msgs::Pose::descriptor(), "pose"), std::runtime_error);
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,130 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/playback_plugin/frame_cache.hh"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+// Payload size of the test entries.
+constexpr size_t kEntryBytes{4};
+
+// A memory budget no test gets to.
+constexpr size_t kUnboundedBytes{1024 * 1024};
+
+// @return An entry of @p _topic at @p _time, whose payload is @p _data.
+FrameCache::Entry MakeEntry(const nanoseconds& _time, const std::string& _topic,
+                            const std::string& _data = std::string(kEntryBytes, 'x')) {
+  return FrameCache::Entry{_time, _topic, "ignition.msgs.Clock", _data};
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that entries older than the time window are dropped.
+TEST(FrameCache, WindowEviction) {
+  FrameCache cache(seconds(2), kUnboundedBytes);
+  for (int i = 0; i <= 2; ++i) {
+    cache.Add(MakeEntry(seconds(i), "/clock"));
+  }
+  EXPECT_EQ(cache.Span(), seconds(2));
+  EXPECT_TRUE(cache.Contains(nanoseconds(0)));
+
+  cache.Add(MakeEntry(seconds(3), "/clock"));
+  EXPECT_EQ(cache.Span(), seconds(2));
+  EXPECT_EQ(cache.Bytes(), 3 * kEntryBytes);
+  EXPECT_FALSE(cache.Contains(milliseconds(500)));
+  EXPECT_TRUE(cache.Contains(seconds(1)));
+  EXPECT_TRUE(cache.Contains(seconds(3)));
+  EXPECT_FALSE(cache.Contains(seconds(4)));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that the oldest entries are dropped to keep the payload
+///        within the memory budget.
+TEST(FrameCache, BytesEviction) {
+  FrameCache cache(seconds(60), 2 * kEntryBytes + 1);
+  cache.Add(MakeEntry(seconds(0), "/clock"));
+  cache.Add(MakeEntry(seconds(1), "/clock"));
+  EXPECT_EQ(cache.Bytes(), 2 * kEntryBytes);
+  EXPECT_TRUE(cache.Contains(seconds(0)));
+
+  cache.Add(MakeEntry(seconds(2), "/clock"));
+  EXPECT_EQ(cache.Bytes(), 2 * kEntryBytes);
+  EXPECT_EQ(cache.Span(), seconds(1));
+  EXPECT_FALSE(cache.Contains(seconds(0)));
+
+  // An entry over the whole budget leaves nothing behind.
+  cache.Add(MakeEntry(seconds(3), "/clock", std::string(3 * kEntryBytes, 'x')));
+  EXPECT_EQ(cache.Bytes(), 0u);
+  EXPECT_FALSE(cache.Contains(seconds(3)));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that a lookup between two cached frames gets the latest
+///        entry of each topic up to that time.
+TEST(FrameCache, FrameAtBetweenFrames) {
+  FrameCache cache(seconds(60), kUnboundedBytes);
+  cache.Add(MakeEntry(seconds(0), "/agents", "a0"));
+  cache.Add(MakeEntry(seconds(1), "/clock", "c1"));
+  cache.Add(MakeEntry(seconds(2), "/agents", "a2"));
+  cache.Add(MakeEntry(seconds(2), "/clock", "c2"));
+
+  const std::vector<FrameCache::Entry> frame = cache.FrameAt(milliseconds(1500));
+  ASSERT_EQ(frame.size(), 2u);
+  EXPECT_EQ(frame[0].topic, "/agents");
+  EXPECT_EQ(frame[0].time, seconds(0));
+  EXPECT_EQ(frame[0].data, "a0");
+  EXPECT_EQ(frame[1].topic, "/clock");
+  EXPECT_EQ(frame[1].time, seconds(1));
+  EXPECT_EQ(frame[1].data, "c1");
+
+  // Before the first `/clock` entry only `/agents` was shown.
+  const std::vector<FrameCache::Entry> earlier = cache.FrameAt(milliseconds(500));
+  ASSERT_EQ(earlier.size(), 1u);
+  EXPECT_EQ(earlier[0].data, "a0");
+
+  const std::vector<FrameCache::Entry> latest = cache.FrameAt(seconds(2));
+  ASSERT_EQ(latest.size(), 2u);
+  EXPECT_EQ(latest[0].data, "a2");
+  EXPECT_EQ(latest[1].data, "c2");
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that an entry older than the newest one, i.e. a backwards
+///        jump, clears the cache.
+TEST(FrameCache, BackwardsJump) {
+  FrameCache cache(seconds(60), kUnboundedBytes);
+  cache.Add(MakeEntry(seconds(5), "/clock"));
+  cache.Add(MakeEntry(seconds(6), "/clock"));
+  cache.Add(MakeEntry(seconds(1), "/clock"));
+  EXPECT_EQ(cache.Bytes(), kEntryBytes);
+  EXPECT_EQ(cache.Span(), nanoseconds(0));
+  EXPECT_FALSE(cache.Contains(seconds(5)));
+  EXPECT_TRUE(cache.Contains(seconds(1)));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,258 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/lane_index.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/math/Vector3.hh>
+#include <maliput/api/junction.h>
+#include <maliput/api/road_geometry.h>
+#include <maliput/api/road_network.h>
+#include <maliput/api/segment.h>
+#include <maliput/plugin/create_road_network.h>
+
+#include "delphyne_gui/config.hh"
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+// Boxes scattered over a 1 km square, as large as lane pieces.
+std::vector<LaneIndex::Entry> RandomEntries(size_t _count, std::mt19937* _generator) {
+  std::uniform_real_distribution<double> position(-500., 500.);
+  std::uniform_real_distribution<double> size(1., 8.);
+  std::vector<LaneIndex::Entry> entries;
+  for (size_t i = 0; i < _count; ++i) {
+    const ignition::math::Vector3d min(position(*_generator), position(*_generator), position(*_generator) / 100.);
+    const ignition::math::Vector3d max = min + ignition::math::Vector3d(size(*_generator), size(*_generator), 5.);
+    entries.push_back(LaneIndex::Entry{nullptr, 0., 1., LaneIndex::Box{min, max}});
+  }
+  return entries;
+}
+
+bool Contains(const LaneIndex::Box& _box, const ignition::math::Vector3d& _point, double _margin = 0.) {
+  return _point.X() >= _box.min.X() - _margin && _point.X() <= _box.max.X() + _margin &&
+         _point.Y() >= _box.min.Y() - _margin && _point.Y() <= _box.max.Y() + _margin &&
+         _point.Z() >= _box.min.Z() - _margin && _point.Z() <= _box.max.Z() + _margin;
+}
+
+// @return Whether the ray hits @p _box, by sampling it every 5 cm.
+bool SampledHit(const LaneIndex::Box& _box, const ignition::math::Vector3d& _origin,
+                const ignition::math::Vector3d& _direction, double _maxDistance) {
+  // Skips the boxes far from the ray line, in the xy plane.
+  const ignition::math::Vector3d center = (_box.min + _box.max) * 0.5;
+  const ignition::math::Vector3d offset = center - _origin;
+  const double planarLength = std::hypot(_direction.X(), _direction.Y());
+  const double lineDistance = planarLength == 0.
+                                  ? std::hypot(offset.X(), offset.Y())
+                                  : std::abs(offset.X() * _direction.Y() - offset.Y() * _direction.X()) / planarLength;
+  if (lineDistance > _box.max.Distance(_box.min)) {
+    return false;
+  }
+  for (double t = 0.; t <= _maxDistance; t += 0.05) {
+    if (Contains(_box, _origin + _direction * t)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// @return The road network of @p _file, a road in the source tree roads
+//         directory, loaded with maliput multilane.
+std::unique_ptr<maliput::api::RoadNetwork> LoadRoad(const std::string& _file) {
+  return maliput::plugin::CreateRoadNetwork(
+      "maliput_multilane", {{"yaml_file", ignition::common::joinPaths(DELPHYNE_GUI_SOURCE_ROADS_PATH, _file)}});
+}
+
+// @return The point at @p _position of @p _lane, in the inertial frame.
+ignition::math::Vector3d PointAt(const maliput::api::Lane& _lane, const maliput::api::LanePosition& _position) {
+  const maliput::api::InertialPosition position = _lane.ToInertialPosition(_position);
+  return {position.x(), position.y(), position.z()};
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that an empty index finds nothing.
+TEST(LaneIndex, Empty) {
+  const LaneIndex index({});
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_TRUE(index.EntriesAt({0., 0., 0.}).empty());
+  EXPECT_TRUE(index.EntriesAlong({0., 0., 10.}, {0., 0., -1.}, 100.).empty());
+  EXPECT_FALSE(index.FindLane({0., 0., 0.}).has_value());
+  EXPECT_FALSE(index.CastRay({0., 0., 10.}, {0., 0., -1.}, 100.).has_value());
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks point queries against a linear search.
+TEST(LaneIndex, EntriesAtMatchesLinearSearch) {
+  std::mt19937 generator(42);
+  const std::vector<LaneIndex::Entry> entries = RandomEntries(5000, &generator);
+  const LaneIndex index(entries);
+  ASSERT_EQ(index.Size(), entries.size());
+
+  std::uniform_real_distribution<double> position(-520., 520.);
+  std::uniform_real_distribution<double> height(-5., 10.);
+  for (int i = 0; i < 2000; ++i) {
+    const ignition::math::Vector3d point(position(generator), position(generator), height(generator));
+    std::vector<double> expected;
+    for (const LaneIndex::Entry& entry : entries) {
+      if (Contains(entry.box, point)) {
+        expected.push_back(entry.box.min.X());
+      }
+    }
+    std::vector<double> found;
+    for (const LaneIndex::Entry* entry : index.EntriesAt(point)) {
+      found.push_back(entry->box.min.X());
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+  }
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks ray queries against sampling the rays, including vertical
+///        and axis aligned rays and rays starting off the grid.
+TEST(LaneIndex, EntriesAlongMatchesSampling) {
+  std::mt19937 generator(7);
+  const std::vector<LaneIndex::Entry> entries = RandomEntries(300, &generator);
+  const LaneIndex index(entries);
+
+  std::uniform_real_distribution<double> position(-600., 600.);
+  std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+  std::vector<std::pair<ignition::math::Vector3d, ignition::math::Vector3d>> rays{
+      {{0., 0., 50.}, {0., 0., -1.}},
+      {{-600., 10., 1.}, {1., 0., 0.}},
+      {{10., 600., 1.}, {0., -1., 0.}},
+  };
+  for (int i = 0; i < 30; ++i) {
+    const double yaw = angle(generator);
+    const ignition::math::Vector3d direction(std::cos(yaw), std::sin(yaw), -0.01);
+    rays.emplace_back(ignition::math::Vector3d(position(generator), position(generator), 3.),
+                      direction.Normalized());
+  }
+
+  constexpr double kMaxDistance{800.};
+  for (const auto& [origin, direction] : rays) {
+    const std::vector<std::pair<double, const LaneIndex::Entry*>> found =
+        index.EntriesAlong(origin, direction, kMaxDistance);
+    EXPECT_TRUE(std::is_sorted(found.begin(), found.end(),
+                               [](const auto& _lhs, const auto& _rhs) { return _lhs.first < _rhs.first; }));
+    size_t expected{0};
+    for (const LaneIndex::Entry& entry : entries) {
+      if (SampledHit(entry.box, origin, direction, kMaxDistance)) {
+        ++expected;
+        const auto it = std::find_if(found.begin(), found.end(),
+                                     [&entry](const auto& _hit) { return _hit.second->box.min == entry.box.min; });
+        ASSERT_NE(it, found.end());
+        EXPECT_TRUE(Contains(entry.box, origin + direction * it->first, 1e-9));
+      }
+    }
+    // Sampling may miss boxes that are barely grazed.
+    EXPECT_GE(found.size(), expected);
+    EXPECT_LE(found.size(), expected + 2);
+  }
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that points on a three lane straight road are found in
+///        their lane, at their (s, r, h) coordinates, and that points off
+///        the road are not.
+TEST(LaneIndex, FindLaneOnMultilaneRoad) {
+  const std::unique_ptr<maliput::api::RoadNetwork> roadNetwork = LoadRoad("straight_lanes.yaml");
+  ASSERT_NE(roadNetwork, nullptr);
+  const std::unique_ptr<LaneIndex> index = LaneIndex::Build(*roadNetwork->road_geometry());
+  ASSERT_NE(index, nullptr);
+  EXPECT_GT(index->Size(), 0u);
+
+  const maliput::api::Segment* segment = roadNetwork->road_geometry()->junction(0)->segment(0);
+  ASSERT_EQ(segment->num_lanes(), 3);
+  for (int i = 0; i < segment->num_lanes(); ++i) {
+    const maliput::api::Lane* lane = segment->lane(i);
+    for (const double s : {1., 100., 250.5, 499.}) {
+      // Lanes are 4 m wide, the points stay within their lane bounds.
+      for (const double r : {-1.5, 0., 1.5}) {
+        const std::optional<LaneIndex::Hit> hit = index->FindLane(PointAt(*lane, {s, r, 0.}));
+        ASSERT_TRUE(hit.has_value());
+        EXPECT_EQ(hit->lane, lane);
+        EXPECT_NEAR(hit->position.s(), s, 1e-3);
+        EXPECT_NEAR(hit->position.r(), r, 1e-3);
+        EXPECT_NEAR(hit->position.h(), 0., 1e-3);
+        EXPECT_NEAR(hit->distance, 0., 1e-3);
+      }
+    }
+  }
+
+  // The road runs along x, its lanes centered at y = 0, 4 and 8 m.
+  for (const ignition::math::Vector3d& point : {ignition::math::Vector3d(250., -10., 0.),
+                                                ignition::math::Vector3d(250., 20., 0.),
+                                                ignition::math::Vector3d(250., 4., 20.),
+                                                ignition::math::Vector3d(-20., 0., 0.),
+                                                ignition::math::Vector3d(520., 0., 0.)}) {
+    EXPECT_FALSE(index->FindLane(point).has_value());
+  }
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that rays cast at a three lane straight road hit the
+///        surface of the lane under their target, and that rays missing the
+///        road, or too short to reach it, hit nothing.
+TEST(LaneIndex, CastRayOnMultilaneRoad) {
+  const std::unique_ptr<maliput::api::RoadNetwork> roadNetwork = LoadRoad("straight_lanes.yaml");
+  ASSERT_NE(roadNetwork, nullptr);
+  const std::unique_ptr<LaneIndex> index = LaneIndex::Build(*roadNetwork->road_geometry());
+  ASSERT_NE(index, nullptr);
+
+  const maliput::api::Segment* segment = roadNetwork->road_geometry()->junction(0)->segment(0);
+  const ignition::math::Vector3d down(0., 0., -1.);
+  const ignition::math::Vector3d up(0., 0., 1.);
+  const ignition::math::Vector3d slanted = ignition::math::Vector3d(1., 0.5, -1.).Normalized();
+  for (int i = 0; i < segment->num_lanes(); ++i) {
+    const maliput::api::Lane* lane = segment->lane(i);
+    for (const double s : {10., 250., 490.}) {
+      const ignition::math::Vector3d target = PointAt(*lane, {s, 0.5, 0.});
+      for (const ignition::math::Vector3d& direction : {down, slanted}) {
+        const ignition::math::Vector3d origin = target - direction * 20.;
+        const std::optional<LaneIndex::Hit> hit = index->CastRay(origin, direction, 100.);
+        ASSERT_TRUE(hit.has_value());
+        EXPECT_EQ(hit->lane, lane);
+        EXPECT_NEAR(hit->distance, 20., 1e-2);
+        EXPECT_LT(hit->point.Distance(target), 1e-2);
+        EXPECT_NEAR(hit->position.s(), s, 1e-2);
+        EXPECT_NEAR(hit->position.r(), 0.5, 1e-2);
+        EXPECT_NEAR(hit->position.h(), 0., 1e-2);
+      }
+      // Too short to reach the road, or pointing away from it.
+      EXPECT_FALSE(index->CastRay(target + up * 20., down, 10.).has_value());
+      EXPECT_FALSE(index->CastRay(target + up * 20., up, 100.).has_value());
+    }
+  }
+
+  EXPECT_FALSE(index->CastRay(ignition::math::Vector3d(250., 20., 20.), down, 100.).has_value());
+  EXPECT_FALSE(index->CastRay(ignition::math::Vector3d(-20., 0., 20.), down, 100.).has_value());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,179 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/log_tools/log_index.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ignition/transport/log/Log.hh>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+// Number of time buckets of the test indices.
+constexpr int kBucketCount{10};
+
+// Payload sizes of the test log messages.
+constexpr size_t kBaselineBytes{3};
+constexpr size_t kBurstBytes{5};
+
+// @return A path for a file of the test @p _name.
+std::string TestPath(const std::string& _name) { return ::testing::TempDir() + "log_index_" + _name; }
+
+// Writes a log spanning 10 s to @p _path. `/baseline` gets a message every
+// second, the last two in the last bucket, and `/burst` ten messages in the
+// buckets 3 and 7.
+void WriteLog(const std::string& _path) {
+  std::remove(_path.c_str());
+  ignition::transport::log::Log log;
+  ASSERT_TRUE(log.Open(_path, std::ios_base::out));
+  const nanoseconds start = seconds(100);
+  const std::string baseline(kBaselineBytes, 'b');
+  const std::string burst(kBurstBytes, 'x');
+  for (int i = 0; i <= 10; ++i) {
+    ASSERT_TRUE(
+        log.InsertMessage(start + seconds(i), "/baseline", "ignition.msgs.Clock", baseline.data(), baseline.size()));
+  }
+  for (const int bucket : {3, 7}) {
+    for (int i = 0; i < 10; ++i) {
+      const nanoseconds time = start + seconds(bucket) + std::chrono::milliseconds(50 + 90 * i);
+      ASSERT_TRUE(log.InsertMessage(time, "/burst", "ignition.msgs.Clock", burst.data(), burst.size()));
+    }
+  }
+}
+
+// @return The contents of @p _path.
+std::string ReadFile(const std::string& _path) {
+  std::ifstream file(_path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Replaces @p _path contents with @p _contents.
+void WriteFile(const std::string& _path, const std::string& _contents) {
+  std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+  file << _contents;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that messages are counted per topic and time bucket.
+TEST(LogIndex, Buckets) {
+  const std::string logPath = TestPath("buckets.db");
+  const std::string indexPath = TestPath("buckets.idx");
+  WriteLog(logPath);
+  ASSERT_TRUE(LogIndex::Build(logPath, indexPath, kBucketCount));
+  const std::unique_ptr<LogIndex> index = LogIndex::Open(indexPath, logPath);
+  ASSERT_NE(index, nullptr);
+
+  EXPECT_EQ(index->Duration(), seconds(10));
+  EXPECT_EQ(index->BucketDuration(), seconds(1));
+  EXPECT_EQ(index->BucketCount(), kBucketCount);
+  ASSERT_EQ(index->Topics(), std::vector<std::string>({"/baseline", "/burst"}));
+
+  for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+    // The last message, at the log end, falls in the last bucket.
+    const uint32_t baselineCount = bucket == kBucketCount - 1 ? 2 : 1;
+    EXPECT_EQ(index->At(0, bucket).count, baselineCount);
+    EXPECT_EQ(index->At(0, bucket).bytes, baselineCount * kBaselineBytes);
+    const uint32_t burstCount = bucket == 3 || bucket == 7 ? 10 : 0;
+    EXPECT_EQ(index->At(1, bucket).count, burstCount);
+    EXPECT_EQ(index->At(1, bucket).bytes, burstCount * kBurstBytes);
+  }
+  EXPECT_EQ(index->TotalCounts(), std::vector<uint32_t>({1, 1, 1, 11, 1, 1, 1, 11, 1, 2}));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that bursts are found forwards and backwards, skipping the
+///        one being played when going back.
+TEST(LogIndex, Bursts) {
+  const std::string logPath = TestPath("bursts.db");
+  const std::string indexPath = TestPath("bursts.idx");
+  WriteLog(logPath);
+  const std::unique_ptr<LogIndex> index = LogIndex::OpenOrBuild(logPath, indexPath, kBucketCount);
+  ASSERT_NE(index, nullptr);
+
+  EXPECT_EQ(index->NextBurst(nanoseconds(0)), std::optional<nanoseconds>(seconds(3)));
+  EXPECT_EQ(index->NextBurst(seconds(3)), std::optional<nanoseconds>(seconds(7)));
+  EXPECT_FALSE(index->NextBurst(seconds(7)).has_value());
+
+  EXPECT_EQ(index->PreviousBurst(seconds(10)), std::optional<nanoseconds>(seconds(7)));
+  EXPECT_EQ(index->PreviousBurst(seconds(7) + std::chrono::milliseconds(500)),
+            std::optional<nanoseconds>(seconds(3)));
+  EXPECT_FALSE(index->PreviousBurst(seconds(3) + std::chrono::milliseconds(500)).has_value());
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that invalid, truncated and stale index files are not
+///        opened, and that OpenOrBuild() rebuilds them.
+TEST(LogIndex, InvalidFiles) {
+  const std::string logPath = TestPath("invalid.db");
+  const std::string indexPath = TestPath("invalid.idx");
+  WriteLog(logPath);
+  ASSERT_TRUE(LogIndex::Build(logPath, indexPath, kBucketCount));
+  const std::string contents = ReadFile(indexPath);
+
+  EXPECT_EQ(LogIndex::Open(TestPath("missing.idx")), nullptr);
+  WriteFile(indexPath, "not a log index");
+  EXPECT_EQ(LogIndex::Open(indexPath), nullptr);
+  WriteFile(indexPath, contents.substr(0, contents.size() - 1));
+  EXPECT_EQ(LogIndex::Open(indexPath), nullptr);
+
+  // An index of another log, with a different size, is stale.
+  WriteFile(indexPath, contents);
+  EXPECT_NE(LogIndex::Open(indexPath, logPath), nullptr);
+  EXPECT_EQ(LogIndex::Open(indexPath, indexPath), nullptr);
+
+  WriteFile(indexPath, "not a log index");
+  const std::unique_ptr<LogIndex> rebuilt = LogIndex::OpenOrBuild(logPath, indexPath, kBucketCount);
+  ASSERT_NE(rebuilt, nullptr);
+  EXPECT_EQ(rebuilt->BucketCount(), kBucketCount);
+
+  // A different bucket count is rebuilt too.
+  const std::unique_ptr<LogIndex> finer = LogIndex::OpenOrBuild(logPath, indexPath, 2 * kBucketCount);
+  ASSERT_NE(finer, nullptr);
+  EXPECT_EQ(finer->BucketCount(), 2 * kBucketCount);
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that a stopped build leaves no index behind.
+TEST(LogIndex, StopRequested) {
+  const std::string logPath = TestPath("stop.db");
+  const std::string indexPath = TestPath("stop.idx");
+  WriteLog(logPath);
+  std::remove(indexPath.c_str());
+
+  const std::atomic<bool> stopRequested{true};
+  EXPECT_FALSE(LogIndex::Build(logPath, indexPath, kBucketCount, &stopRequested));
+  EXPECT_EQ(LogIndex::OpenOrBuild(logPath, indexPath, kBucketCount, &stopRequested), nullptr);
+  EXPECT_EQ(LogIndex::Open(indexPath), nullptr);
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,162 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/log_tools/log_stats.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <delphyne/protobuf/agent_state_v.pb.h>
+#include <ignition/transport/log/Log.hh>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+// Payload of the `/clock` messages.
+const std::string kClockData{"tick"};
+
+// A truncated length delimited field, which does not parse.
+const std::string kMalformedData{"\x0a\x7f"};
+
+// @return A path for a log of the test @p _name.
+std::string LogPath(const std::string& _name) { return ::testing::TempDir() + "log_stats_" + _name + ".db"; }
+
+// @return An agent states message where `car1` drives along x at @p _speed
+//         and `car2` at 5 m/s.
+std::string AgentStates(double _speed) {
+  ignition::msgs::AgentState_V msg;
+  ignition::msgs::AgentState* car1 = msg.add_states();
+  car1->set_name("car1");
+  car1->mutable_linear_velocity()->set_x(_speed);
+  ignition::msgs::AgentState* car2 = msg.add_states();
+  car2->set_name("car2");
+  car2->mutable_linear_velocity()->set_y(3.);
+  car2->mutable_linear_velocity()->set_z(4.);
+  std::string data;
+  msg.SerializeToString(&data);
+  return data;
+}
+
+// Writes a log spanning 10 s to @p _path. `/clock` gets a message every
+// second up to 5 s and one more at 10 s. `/agents/state` gets one every two
+// seconds, where `car1` speeds up at 1 m/s², and a malformed one at 5 s.
+// @return The bytes written to `/agents/state`.
+size_t WriteLog(const std::string& _path) {
+  std::remove(_path.c_str());
+  ignition::transport::log::Log log;
+  EXPECT_TRUE(log.Open(_path, std::ios_base::out));
+  for (const int time : {0, 1, 2, 3, 4, 5, 10}) {
+    EXPECT_TRUE(
+        log.InsertMessage(seconds(time), "/clock", "ignition.msgs.Clock", kClockData.data(), kClockData.size()));
+  }
+  size_t agentBytes{0};
+  for (int time = 0; time <= 10; time += 2) {
+    const std::string data = AgentStates(time);
+    EXPECT_TRUE(
+        log.InsertMessage(seconds(time), "/agents/state", "ignition.msgs.AgentState_V", data.data(), data.size()));
+    agentBytes += data.size();
+    if (time == 4) {
+      EXPECT_TRUE(log.InsertMessage(seconds(5), "/agents/state", "ignition.msgs.AgentState_V", kMalformedData.data(),
+                                    kMalformedData.size()));
+      agentBytes += kMalformedData.size();
+    }
+  }
+  return agentBytes;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks the per topic counts, rates, intervals and gaps, and the
+///        per agent speeds and accelerations of a log.
+TEST(LogStats, Analyze) {
+  const std::string path = LogPath("analyze");
+  const size_t agentBytes = WriteLog(path);
+  const std::optional<LogStats::Summary> summary = LogStats::Analyze(path);
+  ASSERT_TRUE(summary.has_value());
+
+  EXPECT_EQ(summary->path, path);
+  EXPECT_EQ(summary->duration, seconds(10));
+  EXPECT_EQ(summary->decodeErrors, 1u);
+
+  ASSERT_EQ(summary->topics.size(), 2u);
+  const LogStats::TopicSummary& agentsTopic = summary->topics[0];
+  EXPECT_EQ(agentsTopic.topic, "/agents/state");
+  EXPECT_EQ(agentsTopic.count, 7u);
+  EXPECT_EQ(agentsTopic.bytes, agentBytes);
+  EXPECT_DOUBLE_EQ(agentsTopic.rate, 0.7);
+  EXPECT_EQ(agentsTopic.maxInterval, seconds(2));
+  // The malformed message halves two intervals, which are no gaps.
+  EXPECT_EQ(agentsTopic.gaps, 0u);
+  const LogStats::TopicSummary& clockTopic = summary->topics[1];
+  EXPECT_EQ(clockTopic.topic, "/clock");
+  EXPECT_EQ(clockTopic.count, 7u);
+  EXPECT_EQ(clockTopic.bytes, 7 * kClockData.size());
+  EXPECT_EQ(clockTopic.meanInterval, nanoseconds(seconds(10)) / 6);
+  EXPECT_EQ(clockTopic.maxInterval, seconds(5));
+  // Only the 5 s interval is longer than three times the previous ones.
+  EXPECT_EQ(clockTopic.gaps, 1u);
+
+  ASSERT_EQ(summary->agents.size(), 2u);
+  EXPECT_EQ(summary->agents[0].name, "car1");
+  EXPECT_EQ(summary->agents[0].samples, 6u);
+  EXPECT_DOUBLE_EQ(summary->agents[0].meanSpeed, 5.);
+  EXPECT_DOUBLE_EQ(summary->agents[0].maxSpeed, 10.);
+  EXPECT_DOUBLE_EQ(summary->agents[0].meanAcceleration, 1.);
+  EXPECT_DOUBLE_EQ(summary->agents[0].minAcceleration, 1.);
+  EXPECT_DOUBLE_EQ(summary->agents[0].maxAcceleration, 1.);
+  EXPECT_EQ(summary->agents[1].name, "car2");
+  EXPECT_EQ(summary->agents[1].samples, 6u);
+  EXPECT_DOUBLE_EQ(summary->agents[1].meanSpeed, 5.);
+  EXPECT_DOUBLE_EQ(summary->agents[1].maxSpeed, 5.);
+  EXPECT_DOUBLE_EQ(summary->agents[1].meanAcceleration, 0.);
+
+  EXPECT_FALSE(LogStats::Analyze(LogPath("missing")).has_value());
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks both CSV tables of a log analyzed along a missing one.
+TEST(LogStats, Csv) {
+  const std::string path = LogPath("csv");
+  const size_t agentBytes = WriteLog(path);
+  const std::vector<std::optional<LogStats::Summary>> summaries =
+      LogStats::AnalyzeAll({path, LogPath("missing")}, 2);
+  ASSERT_EQ(summaries.size(), 2u);
+  ASSERT_TRUE(summaries[0].has_value());
+  EXPECT_FALSE(summaries[1].has_value());
+
+  std::ostringstream topics;
+  LogStats::WriteTopicsCsv({summaries[0].value()}, &topics);
+  EXPECT_EQ(topics.str(),
+            "log,topic,duration_s,count,bytes,rate_hz,mean_interval_ms,max_interval_ms,gaps\n" + path +
+                ",/agents/state,10,7," + std::to_string(agentBytes) + ",0.7,1666.67,2000,0\n" + path +
+                ",/clock,10,7,28,0.7,1666.67,5000,1\n");
+
+  std::ostringstream agents;
+  LogStats::WriteAgentsCsv({summaries[0].value()}, &agents);
+  EXPECT_EQ(agents.str(),
+            "log,agent,duration_s,samples,mean_speed,max_speed,mean_acceleration,min_acceleration,max_acceleration\n" +
+                path + ",car1,10,6,5,10,1,1,1\n" + path + ",car2,10,6,5,5,0,0,0\n");
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,107 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/topic_interface_plugin/message_history.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+using internal::MessageHistory;
+
+// @return An entry of @p _topic received @p _ms milliseconds after the
+//         epoch, with @p _bytes bytes of data.
+MessageHistory::Entry MakeEntry(const std::string& _topic, int _ms, size_t _bytes = 1) {
+  return MessageHistory::Entry{MessageHistory::Clock::time_point(std::chrono::milliseconds(_ms)), _topic,
+                               "ignition.msgs.StringMsg", std::make_shared<const std::string>(_bytes, 'x')};
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that the oldest messages are evicted over the message count.
+TEST(MessageHistory, CountEviction) {
+  MessageHistory history(3, MessageHistory::Clock::duration::zero(), 0);
+  for (int i = 0; i < 5; ++i) {
+    history.Add(MakeEntry("/topic", i, 10));
+  }
+  ASSERT_EQ(3u, history.Size());
+  EXPECT_EQ(30u, history.Bytes());
+  EXPECT_EQ(MessageHistory::Clock::time_point(std::chrono::milliseconds(2)), history.At(0).time);
+  EXPECT_EQ(MessageHistory::Clock::time_point(std::chrono::milliseconds(4)), history.At(2).time);
+}
+
+/// \brief Checks that the messages older than the age budget, measured from
+///        the newest one, are evicted.
+TEST(MessageHistory, AgeEviction) {
+  MessageHistory history(0, std::chrono::milliseconds(100), 0);
+  history.Add(MakeEntry("/topic", 0));
+  history.Add(MakeEntry("/topic", 50));
+  history.Add(MakeEntry("/topic", 100));
+  EXPECT_EQ(3u, history.Size());
+  history.Add(MakeEntry("/topic", 160));
+  ASSERT_EQ(2u, history.Size());
+  EXPECT_EQ(MessageHistory::Clock::time_point(std::chrono::milliseconds(100)), history.At(0).time);
+  // A late message evicts all the other ones.
+  history.Add(MakeEntry("/topic", 1000));
+  ASSERT_EQ(1u, history.Size());
+  EXPECT_EQ(MessageHistory::Clock::time_point(std::chrono::milliseconds(1000)), history.At(0).time);
+}
+
+/// \brief Checks that the oldest messages are evicted over the byte budget,
+///        and that the newest one is kept even when over it.
+TEST(MessageHistory, ByteEviction) {
+  MessageHistory history(0, MessageHistory::Clock::duration::zero(), 100);
+  history.Add(MakeEntry("/topic", 0, 40));
+  history.Add(MakeEntry("/topic", 1, 40));
+  EXPECT_EQ(2u, history.Size());
+  EXPECT_EQ(80u, history.Bytes());
+  history.Add(MakeEntry("/topic", 2, 40));
+  ASSERT_EQ(2u, history.Size());
+  EXPECT_EQ(80u, history.Bytes());
+  EXPECT_EQ(MessageHistory::Clock::time_point(std::chrono::milliseconds(1)), history.At(0).time);
+
+  history.Add(MakeEntry("/topic", 3, 150));
+  ASSERT_EQ(1u, history.Size());
+  EXPECT_EQ(150u, history.Bytes());
+
+  history.Clear();
+  EXPECT_EQ(0u, history.Size());
+  EXPECT_EQ(0u, history.Bytes());
+}
+
+/// \brief Checks LatestOf() over interleaved topics.
+TEST(MessageHistory, LatestOf) {
+  MessageHistory history(0, MessageHistory::Clock::duration::zero(), 0);
+  EXPECT_EQ(0u, history.LatestOf("/a", 0));
+  history.Add(MakeEntry("/a", 0));
+  history.Add(MakeEntry("/b", 1));
+  history.Add(MakeEntry("/a", 2));
+  history.Add(MakeEntry("/b", 3));
+  EXPECT_EQ(0u, history.LatestOf("/a", 0));
+  EXPECT_EQ(0u, history.LatestOf("/a", 1));
+  EXPECT_EQ(2u, history.LatestOf("/a", 3));
+  EXPECT_EQ(3u, history.LatestOf("/b", 3));
+  // Indices past the newest message look from the newest one.
+  EXPECT_EQ(3u, history.LatestOf("/b", 10));
+  // Topics without messages at or before the index.
+  EXPECT_EQ(history.Size(), history.LatestOf("/b", 0));
+  EXPECT_EQ(history.Size(), history.LatestOf("/c", 3));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,203 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/recorder_plugin/raw_recorder.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+// A message reported by RawRecorder::Read().
+struct ReadMessage {
+  std::string topic;
+  std::string msgType;
+  std::string data;
+};
+
+// Drops reported by RawRecorder::Read().
+struct ReadDrops {
+  std::string topic;
+  uint64_t dropped{0};
+  uint64_t droppedBytes{0};
+};
+
+// Reads the recording at @p _path into @p _messages and @p _drops.
+// @return What RawRecorder::Read() returns.
+bool ReadRecording(const std::string& _path, std::vector<ReadMessage>* _messages, std::vector<ReadDrops>* _drops) {
+  return RawRecorder::Read(
+      _path,
+      [_messages](const std::string& _topic, const std::string& _msgType, const RawRecorder::Clock::time_point&,
+                  const std::string& _data) {
+        _messages->push_back(ReadMessage{_topic, _msgType, _data});
+      },
+      [_drops](const std::string& _topic, uint64_t _dropped, uint64_t _droppedBytes) {
+        _drops->push_back(ReadDrops{_topic, _dropped, _droppedBytes});
+      });
+}
+
+// @return A path for a recording of the test @p _name.
+std::string RecordingPath(const std::string& _name) { return ::testing::TempDir() + "raw_recorder_" + _name + ".rec"; }
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that recorded messages are read back in order, with their
+///        topic and type.
+TEST(RawRecorder, RoundTrip) {
+  const std::string path = RecordingPath("round_trip");
+  {
+    RawRecorder recorder(path, {"/a", "/b"}, 16);
+    recorder.Push(0, "ignition.msgs.StringMsg", std::make_shared<const std::string>("first"));
+    recorder.Push(1, "ignition.msgs.Double", std::make_shared<const std::string>(""));
+    recorder.Push(0, "ignition.msgs.StringMsg", std::make_shared<const std::string>("second"));
+    recorder.Close();
+    EXPECT_FALSE(recorder.Failed());
+    const std::vector<RawRecorder::TopicStats> stats = recorder.Stats();
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_EQ(2u, stats[0].messages);
+    EXPECT_EQ(11u, stats[0].bytes);
+    EXPECT_EQ(1u, stats[1].messages);
+    EXPECT_EQ(0u, stats[0].dropped + stats[1].dropped);
+  }
+
+  std::vector<ReadMessage> messages;
+  std::vector<ReadDrops> drops;
+  ASSERT_TRUE(ReadRecording(path, &messages, &drops));
+  EXPECT_TRUE(drops.empty());
+  // Messages of a topic keep their order.
+  std::vector<std::string> aData;
+  for (const ReadMessage& message : messages) {
+    if (message.topic == "/a") {
+      EXPECT_EQ("ignition.msgs.StringMsg", message.msgType);
+      aData.push_back(message.data);
+    } else {
+      EXPECT_EQ("/b", message.topic);
+      EXPECT_EQ("ignition.msgs.Double", message.msgType);
+      EXPECT_EQ("", message.data);
+    }
+  }
+  EXPECT_EQ(3u, messages.size());
+  EXPECT_EQ((std::vector<std::string>{"first", "second"}), aData);
+  std::remove(path.c_str());
+}
+
+/// \brief Checks that messages over the queue capacity are dropped, that
+///        the drops are recorded and that every pushed message is either
+///        read back or counted as dropped.
+TEST(RawRecorder, Drops) {
+  const std::string path = RecordingPath("drops");
+  constexpr int kPushes{1000};
+  RawRecorder::TopicStats stats;
+  {
+    RawRecorder recorder(path, {"/fast", "/idle"}, 1);
+    for (int i = 0; i < kPushes; ++i) {
+      recorder.Push(0, "ignition.msgs.StringMsg", std::make_shared<const std::string>("12345678"));
+    }
+    recorder.Close();
+    stats = recorder.Stats()[0];
+    // Messages pushed after Close() are dropped, and not recorded.
+    recorder.Push(0, "ignition.msgs.StringMsg", std::make_shared<const std::string>("late"));
+    EXPECT_EQ(stats.dropped + 1, recorder.Stats()[0].dropped);
+  }
+  EXPECT_EQ(static_cast<uint64_t>(kPushes), stats.messages + stats.dropped);
+  EXPECT_EQ(8u * stats.dropped, stats.droppedBytes);
+  EXPECT_GT(stats.dropped, 0u);
+
+  std::vector<ReadMessage> messages;
+  std::vector<ReadDrops> drops;
+  ASSERT_TRUE(ReadRecording(path, &messages, &drops));
+  EXPECT_EQ(stats.messages, messages.size());
+  ASSERT_FALSE(drops.empty());
+  // Drops are totals, the last record has the final ones.
+  EXPECT_EQ("/fast", drops.back().topic);
+  EXPECT_EQ(stats.dropped, drops.back().dropped);
+  EXPECT_EQ(stats.droppedBytes, drops.back().droppedBytes);
+  for (const ReadDrops& drop : drops) {
+    EXPECT_EQ("/fast", drop.topic);
+  }
+  std::remove(path.c_str());
+}
+
+/// \brief Checks that names and types longer than their size prefix allows
+///        are truncated, keeping the recording readable.
+TEST(RawRecorder, LongStringsAreTruncated) {
+  const std::string path = RecordingPath("long_strings");
+  const std::string longType(70000, 't');
+  {
+    RawRecorder recorder(path, {"/topic"}, 4);
+    recorder.Push(0, longType, std::make_shared<const std::string>("data"));
+    recorder.Close();
+  }
+
+  std::vector<ReadMessage> messages;
+  std::vector<ReadDrops> drops;
+  ASSERT_TRUE(ReadRecording(path, &messages, &drops));
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ("/topic", messages[0].topic);
+  EXPECT_EQ(longType.substr(0, 65535), messages[0].msgType);
+  EXPECT_EQ("data", messages[0].data);
+  std::remove(path.c_str());
+}
+
+/// \brief Checks that a truncated recording is reported as incomplete, while
+///        the messages of its complete chunks are still read.
+TEST(RawRecorder, TruncatedFile) {
+  const std::string path = RecordingPath("truncated_file");
+  // Messages of 1 MB fill a chunk each.
+  const auto data = std::make_shared<const std::string>(1 << 20, 'x');
+  {
+    RawRecorder recorder(path, {"/topic"}, 4);
+    for (int i = 0; i < 3; ++i) {
+      recorder.Push(0, "ignition.msgs.Bytes", data);
+    }
+    recorder.Close();
+  }
+  std::string contents;
+  {
+    std::ifstream file(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size() - 10);
+  }
+
+  std::vector<ReadMessage> messages;
+  std::vector<ReadDrops> drops;
+  EXPECT_FALSE(ReadRecording(path, &messages, &drops));
+  EXPECT_EQ(2u, messages.size());
+  for (const ReadMessage& message : messages) {
+    EXPECT_EQ(*data, message.data);
+  }
+
+  // Not a recording.
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "garbage";
+  }
+  messages.clear();
+  EXPECT_FALSE(ReadRecording(path, &messages, &drops));
+  EXPECT_TRUE(messages.empty());
+  std::remove(path.c_str());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
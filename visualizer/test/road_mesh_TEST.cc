@@ -0,0 +1,168 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/road_network_viewer/road_mesh.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+// Size of the cache entry header: magic, version and mesh count.
+constexpr size_t kHeaderSize{12};
+
+// @return A path for a cache entry of the test @p _name.
+std::string EntryPath(const std::string& _name) { return ::testing::TempDir() + "road_mesh_" + _name + ".meshes"; }
+
+// @return A surface made of two triangles and a marking made of one.
+std::vector<RoadMesh> Meshes() {
+  RoadMesh surface;
+  surface.name = "s0/surface";
+  surface.kind = RoadMesh::Kind::kSurface;
+  surface.positions = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 0.f};
+  surface.normals = {0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f};
+  surface.indices = {0, 1, 2, 0, 2, 3};
+  RoadMesh marking;
+  marking.name = "s0/markings";
+  marking.kind = RoadMesh::Kind::kMarking;
+  marking.positions = {0.f, 0.f, 0.02f, 1.f, 0.f, 0.02f, 1.f, 0.15f, 0.02f};
+  marking.normals = {0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f};
+  marking.indices = {0, 1, 2};
+  return {surface, marking};
+}
+
+// @return The contents of @p _path.
+std::string ReadFile(const std::string& _path) {
+  std::ifstream file(_path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Replaces @p _path contents with @p _contents.
+void WriteFile(const std::string& _path, const std::string& _contents) {
+  std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+  file << _contents;
+}
+
+// @return @p _contents with the 32 bits at @p _offset replaced by @p _value.
+std::string WithUint32(std::string _contents, size_t _offset, uint32_t _value) {
+  std::memcpy(&_contents[_offset], &_value, sizeof(_value));
+  return _contents;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that saved meshes are loaded back unchanged.
+TEST(RoadMeshCache, RoundTrip) {
+  const std::string path = EntryPath("round_trip");
+  const std::vector<RoadMesh> meshes = Meshes();
+  ASSERT_TRUE(RoadMeshCache::Save(path, meshes));
+
+  const std::optional<std::vector<RoadMesh>> loaded = RoadMeshCache::Load(path);
+  ASSERT_TRUE(loaded.has_value());
+  ASSERT_EQ(loaded->size(), meshes.size());
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    EXPECT_EQ((*loaded)[i].name, meshes[i].name);
+    EXPECT_EQ((*loaded)[i].kind, meshes[i].kind);
+    EXPECT_EQ((*loaded)[i].positions, meshes[i].positions);
+    EXPECT_EQ((*loaded)[i].normals, meshes[i].normals);
+    EXPECT_EQ((*loaded)[i].indices, meshes[i].indices);
+  }
+
+  // Saving again replaces the entry.
+  ASSERT_TRUE(RoadMeshCache::Save(path, {meshes[1]}));
+  const std::optional<std::vector<RoadMesh>> replaced = RoadMeshCache::Load(path);
+  ASSERT_TRUE(replaced.has_value());
+  ASSERT_EQ(replaced->size(), 1u);
+  EXPECT_EQ(replaced->front().name, meshes[1].name);
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that missing entries and entries of another format are
+///        not loaded.
+TEST(RoadMeshCache, MissingEntry) {
+  const std::string path = EntryPath("missing");
+  std::remove(path.c_str());
+  EXPECT_FALSE(RoadMeshCache::Load(path).has_value());
+
+  WriteFile(path, "not a road mesh cache entry");
+  EXPECT_FALSE(RoadMeshCache::Load(path).has_value());
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that entries truncated anywhere are rejected.
+TEST(RoadMeshCache, TruncatedEntry) {
+  const std::string path = EntryPath("truncated");
+  ASSERT_TRUE(RoadMeshCache::Save(path, Meshes()));
+  const std::string contents = ReadFile(path);
+  for (size_t size = 0; size < contents.size(); ++size) {
+    WriteFile(path, contents.substr(0, size));
+    EXPECT_FALSE(RoadMeshCache::Load(path).has_value()) << "at size " << size;
+  }
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that entries with sizes beyond the file, an unknown mesh
+///        kind or indices past the vertices are rejected.
+TEST(RoadMeshCache, CorruptEntry) {
+  const std::string path = EntryPath("corrupt");
+  const std::vector<RoadMesh> meshes = Meshes();
+  ASSERT_TRUE(RoadMeshCache::Save(path, meshes));
+  const std::string contents = ReadFile(path);
+
+  // Offsets of the first mesh fields: kind, then sized arrays.
+  const size_t kindOffset = kHeaderSize;
+  const size_t nameOffset = kindOffset + 1;
+  const size_t positionsOffset = nameOffset + 4 + meshes[0].name.size();
+  const size_t normalsOffset = positionsOffset + 4 + meshes[0].positions.size() * sizeof(float);
+  const size_t indicesOffset = normalsOffset + 4 + meshes[0].normals.size() * sizeof(float);
+
+  std::vector<std::string> corrupt{
+      // Mesh counts that would need gigabytes, or just more than the file.
+      WithUint32(contents, 8, 0xffffffff),
+      WithUint32(contents, 8, 3),
+      // Arrays larger than the file.
+      WithUint32(contents, nameOffset, 0xffffffff),
+      WithUint32(contents, positionsOffset, 0x7fffffff),
+      // Normals not matching the positions.
+      WithUint32(contents, normalsOffset, 9),
+      // A partial triangle.
+      WithUint32(contents, indicesOffset, 5),
+      // An index past the four vertices.
+      WithUint32(contents, indicesOffset + 4 + 2 * sizeof(uint32_t), 4),
+  };
+  std::string unknownKind = contents;
+  unknownKind[kindOffset] = 7;
+  corrupt.push_back(unknownKind);
+
+  for (size_t i = 0; i < corrupt.size(); ++i) {
+    WriteFile(path, corrupt[i]);
+    EXPECT_FALSE(RoadMeshCache::Load(path).has_value()) << "corruption " << i;
+  }
+  WriteFile(path, contents);
+  EXPECT_TRUE(RoadMeshCache::Load(path).has_value());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
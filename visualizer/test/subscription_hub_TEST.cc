@@ -0,0 +1,96 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/subscription_hub.hh"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+// Publishes @p _msg through @p _publisher until @p _received holds or a
+// second passes, so that the transport discovery has time to complete.
+// @return Whether @p _received holds.
+bool PublishUntil(ignition::transport::Node::Publisher* _publisher, const ignition::msgs::StringMsg& _msg,
+                  const std::function<bool()>& _received) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!_received() && std::chrono::steady_clock::now() < deadline) {
+    _publisher->Publish(_msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return _received();
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that topic names with and without the leading slash share a
+///        single subscription and both receive the messages.
+TEST(SubscriptionHub, MixedTopicNames) {
+  SubscriptionHub* hub = SubscriptionHub::Instance();
+  std::atomic<int> decoded{0};
+  std::atomic<int> raw{0};
+  auto unslashed = hub->Subscribe<ignition::msgs::StringMsg>(
+      "subscription_hub_test/mixed", [&decoded](const ignition::msgs::StringMsg&) { ++decoded; });
+  auto slashed = hub->SubscribeRaw(
+      "/subscription_hub_test/mixed",
+      [&raw](const SubscriptionHub::DataPtr&, const ignition::transport::MessageInfo&) { ++raw; });
+  ASSERT_NE(nullptr, unslashed);
+  ASSERT_NE(nullptr, slashed);
+  EXPECT_EQ("/subscription_hub_test/mixed", unslashed->Topic());
+  EXPECT_EQ("/subscription_hub_test/mixed", slashed->Topic());
+
+  const auto stats = hub->Stats();
+  ASSERT_EQ(1u, stats.count("/subscription_hub_test/mixed"));
+  EXPECT_EQ(0u, stats.count("subscription_hub_test/mixed"));
+  EXPECT_EQ(2u, stats.at("/subscription_hub_test/mixed").subscribers);
+  EXPECT_EQ(2u, hub->Stats("subscription_hub_test/mixed").subscribers);
+
+  ignition::transport::Node node;
+  auto publisher = node.Advertise<ignition::msgs::StringMsg>("subscription_hub_test/mixed");
+  ignition::msgs::StringMsg msg;
+  msg.set_data("message");
+  ASSERT_TRUE(PublishUntil(&publisher, msg, [&decoded, &raw]() { return decoded > 0 && raw > 0; }));
+  // Each message reaches each subscriber once.
+  EXPECT_EQ(hub->Stats("/subscription_hub_test/mixed").messages, static_cast<uint64_t>(decoded.load()));
+  EXPECT_EQ(decoded.load(), raw.load());
+
+  // Dropping one of the names keeps the other subscribed.
+  unslashed.reset();
+  EXPECT_EQ(1u, hub->Stats("subscription_hub_test/mixed").subscribers);
+  const int rawBefore = raw;
+  EXPECT_TRUE(PublishUntil(&publisher, msg, [&raw, rawBefore]() { return raw > rawBefore; }));
+
+  slashed.reset();
+  EXPECT_EQ(0u, hub->Stats().count("/subscription_hub_test/mixed"));
+}
+
+/// \brief Checks that invalid topic names are rejected.
+TEST(SubscriptionHub, InvalidTopicName) {
+  const SubscriptionHub::RawCallback callback = [](const SubscriptionHub::DataPtr&,
+                                                    const ignition::transport::MessageInfo&) {};
+  EXPECT_EQ(nullptr, SubscriptionHub::Instance()->SubscribeRaw("invalid@topic", callback));
+  EXPECT_EQ(0u, SubscriptionHub::Instance()->Stats().size());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,184 @@
+// Copyright 2022 Toyota Research Institute
+
+#include "visualizer/teleop_plugin/teleop_session.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace delphyne {
+namespace gui {
+namespace test {
+namespace {
+
+// Control tick period the sessions are saved and loaded at.
+constexpr int kTickPeriodMs{10};
+
+// Size of the session file header, see TeleopSession::Save().
+constexpr size_t kHeaderSize{24};
+
+// @return A path for a session of the test @p _name.
+std::string SessionPath(const std::string& _name) { return ::testing::TempDir() + "teleop_session_" + _name + ".bin"; }
+
+bool operator==(const TeleopSession::KeyState& _lhs, const TeleopSession::KeyState& _rhs) {
+  return _lhs.throttleKeyPressed == _rhs.throttleKeyPressed && _lhs.keepCurrentThrottle == _rhs.keepCurrentThrottle &&
+         _lhs.brakeKeyPressed == _rhs.brakeKeyPressed && _lhs.keepCurrentBrake == _rhs.keepCurrentBrake &&
+         _lhs.newSteeringAngle == _rhs.newSteeringAngle && _lhs.steeringSteps == _rhs.steeringSteps;
+}
+
+// @return @p _count ticks of keys held for a while and occasional steering,
+//         like a driver would press them.
+std::vector<TeleopSession::KeyState> DriverInputs(size_t _count) {
+  std::mt19937 generator(11);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<int> steps(-3, 3);
+  std::vector<TeleopSession::KeyState> inputs;
+  TeleopSession::KeyState held;
+  for (size_t i = 0; i < _count; ++i) {
+    if (percent(generator) < 5) {
+      held.throttleKeyPressed = !held.throttleKeyPressed;
+    }
+    if (percent(generator) < 3) {
+      held.brakeKeyPressed = !held.brakeKeyPressed;
+    }
+    if (percent(generator) < 2) {
+      held.keepCurrentThrottle = !held.keepCurrentThrottle;
+    }
+    if (percent(generator) < 2) {
+      held.keepCurrentBrake = !held.keepCurrentBrake;
+    }
+    TeleopSession::KeyState state = held;
+    state.steeringSteps = percent(generator) < 10 ? steps(generator) : 0;
+    state.newSteeringAngle = percent(generator) < 1;
+    inputs.push_back(state);
+  }
+  return inputs;
+}
+
+// @return The contents of @p _path.
+std::string ReadFile(const std::string& _path) {
+  std::ifstream file(_path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Replaces @p _path contents with @p _contents.
+void WriteFile(const std::string& _path, const std::string& _contents) {
+  std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+  file << _contents;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that a recorded session replays the recorded inputs, tick
+///        by tick, before and after a save and load, so the replayed
+///        commands are the recorded ones.
+TEST(TeleopSession, RoundTrip) {
+  const std::vector<TeleopSession::KeyState> inputs = DriverInputs(5000);
+  TeleopSession recorded;
+  for (const TeleopSession::KeyState& input : inputs) {
+    recorded.Record(input);
+  }
+  ASSERT_EQ(recorded.TickCount(), inputs.size());
+
+  const std::string path = SessionPath("round_trip");
+  ASSERT_TRUE(recorded.Save(path, kTickPeriodMs));
+  TeleopSession loaded;
+  ASSERT_TRUE(loaded.Load(path, kTickPeriodMs));
+  EXPECT_EQ(loaded.TickCount(), inputs.size());
+
+  for (TeleopSession* session : {&recorded, &loaded}) {
+    session->Rewind();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const std::optional<TeleopSession::KeyState> replayed = session->ReplayNext();
+      ASSERT_TRUE(replayed.has_value());
+      EXPECT_TRUE(replayed.value() == inputs[i]) << "at tick " << i;
+    }
+    EXPECT_FALSE(session->ReplayNext().has_value());
+  }
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that sessions recorded at another tick period are rejected.
+TEST(TeleopSession, TickPeriodMismatch) {
+  TeleopSession session;
+  session.Record(TeleopSession::KeyState{true, false, false, false, false, 0});
+  const std::string path = SessionPath("tick_period");
+  ASSERT_TRUE(session.Save(path, kTickPeriodMs));
+  EXPECT_FALSE(session.Load(path, 2 * kTickPeriodMs));
+  EXPECT_TRUE(session.Load(path, kTickPeriodMs));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that truncated sessions, and sessions whose event count
+///        exceeds the file, are rejected and keep the loaded session.
+TEST(TeleopSession, Truncated) {
+  TeleopSession session;
+  for (const TeleopSession::KeyState& input : DriverInputs(500)) {
+    session.Record(input);
+  }
+  const std::string path = SessionPath("truncated");
+  ASSERT_TRUE(session.Save(path, kTickPeriodMs));
+  const std::string contents = ReadFile(path);
+
+  for (const size_t size : {size_t{0}, kHeaderSize - 1, kHeaderSize, contents.size() - 1}) {
+    WriteFile(path, contents.substr(0, size));
+    EXPECT_FALSE(session.Load(path, kTickPeriodMs)) << "at size " << size;
+    EXPECT_EQ(session.TickCount(), 500u);
+  }
+
+  // An event count that would need gigabytes.
+  std::string corrupt = contents;
+  const uint32_t eventCount{0xffffffff};
+  std::memcpy(&corrupt[12], &eventCount, sizeof(eventCount));
+  WriteFile(path, corrupt);
+  EXPECT_FALSE(session.Load(path, kTickPeriodMs));
+}
+
+//////////////////////////////////////////////////
+
+/// \brief Checks that sessions whose ticks go backwards, repeat or run past
+///        the tick count are rejected.
+TEST(TeleopSession, OutOfOrderTicks) {
+  TeleopSession session;
+  for (int i = 0; i < 4; ++i) {
+    session.Record(TeleopSession::KeyState{false, false, false, false, false, 1});
+  }
+  const std::string path = SessionPath("out_of_order");
+  ASSERT_TRUE(session.Save(path, kTickPeriodMs));
+  const std::string contents = ReadFile(path);
+  ASSERT_EQ(contents.size(), kHeaderSize + 4 * 8);
+
+  // Events are 8 bytes, their tick first.
+  const auto withTick = [&contents](size_t _event, uint32_t _tick) {
+    std::string corrupt = contents;
+    std::memcpy(&corrupt[kHeaderSize + 8 * _event], &_tick, sizeof(_tick));
+    return corrupt;
+  };
+  for (const std::string& corrupt : {withTick(2, 0), withTick(2, 1), withTick(3, 4), withTick(3, 1000)}) {
+    WriteFile(path, corrupt);
+    EXPECT_FALSE(session.Load(path, kTickPeriodMs));
+  }
+  WriteFile(path, contents);
+  EXPECT_TRUE(session.Load(path, kTickPeriodMs));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}  // namespace test
+}  // namespace gui
+}  // namespace delphyne
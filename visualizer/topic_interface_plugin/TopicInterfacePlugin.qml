@@ -39,91 +39,163 @@ import QtQuick.Controls.Styles 1.4
 import QtQuick.Controls.Material 2.1
 import QtQuick.Layouts 1.3
 
-TreeView {
-  objectName: "treeView"
-  id: tree
-  model: MessageModel
-
+Rectangle {
+  color: "transparent"
   Layout.minimumWidth: 400
   Layout.minimumHeight: 300
   anchors.fill: parent
 
-  property int itemHeight: 30;
+  // Search of fields by path or value.
+  RowLayout {
+    id: searchBar
+    anchors.top: parent.top
+    anchors.left: parent.left
+    anchors.right: parent.right
+    height: 40
 
-  // @{ Color properties.
-  property color oddColor: (Material.theme == Material.Light) ?
-                            Material.color(Material.Grey, Material.Shade100):
-                            Material.color(Material.Grey, Material.Shade800);
+    TextField {
+      id: searchText
+      Layout.fillWidth: true
+      placeholderText: qsTr("Field path or value, ^ for prefixes...")
+      onTextChanged: {
+        var indices = TopicInterfacePlugin.Search(text)
+        for (var i = 0; i < indices.length; ++i) {
+          tree.expand(indices[i])
+        }
+      }
+    }
 
-  property color evenColor: (Material.theme == Material.Light) ?
-                             Material.color(Material.Grey, Material.Shade200):
-                             Material.color(Material.Grey, Material.Shade900);
+    Text {
+      text: TopicInterfacePlugin.searchStatus
+      font.pointSize: 10
+    }
+  }
 
-  property color highlightColor: Material.accentColor;
-  // @}
+  // Freeze / scrub controls of the message history.
+  RowLayout {
+    id: historyBar
+    visible: TopicInterfacePlugin.hasHistory
+    anchors.top: searchBar.bottom
+    anchors.left: parent.left
+    anchors.right: parent.right
+    height: visible ? 40 : 0
 
-  // @{ Bar policies.
-  verticalScrollBarPolicy: Qt.ScrollBarAsNeeded
-  horizontalScrollBarPolicy: Qt.ScrollBarAlwaysOff
-  // }
+    Button {
+      text: TopicInterfacePlugin.frozen ? "Live" : "Freeze"
+      onClicked: {
+        TopicInterfacePlugin.frozen = !TopicInterfacePlugin.frozen
+      }
+    }
 
+    Slider {
+      id: historySlider
+      Layout.fillWidth: true
+      enabled: TopicInterfacePlugin.frozen && TopicInterfacePlugin.historySize > 1
+      minimumValue: 0
+      maximumValue: Math.max(0, TopicInterfacePlugin.historySize - 1)
+      stepSize: 1
+      value: TopicInterfacePlugin.historyPosition
+      onValueChanged: {
+        if (TopicInterfacePlugin.frozen) {
+          TopicInterfacePlugin.historyPosition = value
+        }
+      }
+    }
 
-  // @{ Header properties.
-  headerVisible: false
-  headerDelegate: Rectangle {
-      visible: false
-  }
-  TableViewColumn {
-    title: "Name"
-    role: "name"
+    Text {
+      text: TopicInterfacePlugin.historyStatus
+      font.pointSize: 10
+    }
   }
-  // @}
 
-  // @{ Selection properties.
-  selection: ItemSelectionModel {
-    model: tree.model
-  }
-  selectionMode: SelectionMode.SingleSelection
-  // @}
-
-  // @{ Delegates
-  // Builds a row of the tree.
-  rowDelegate: Rectangle {
-    id: row
-    color: (styleData.selected)? highlightColor : (styleData.row % 2 == 0) ? evenColor : oddColor
-    height: itemHeight;
-  }
+  TreeView {
+    objectName: "treeView"
+    id: tree
+    model: TopicInterfacePlugin.model
 
-  // Builds the data of the row.
-  itemDelegate: Item {
-    Text {
-      anchors.verticalCenter: parent.verticalCenter
-      color: styleData.textColor
-      elide: styleData.elideMode
-      text: model === null ? "" : model.name + ": " + model.data
-      font.pointSize: 12
-      y: itemHeight * 0.2
+    anchors.top: historyBar.visible ? historyBar.bottom : searchBar.bottom
+    anchors.bottom: parent.bottom
+    anchors.left: parent.left
+    anchors.right: parent.right
+
+    property int itemHeight: 30;
+
+    // @{ Color properties.
+    property color oddColor: (Material.theme == Material.Light) ?
+                              Material.color(Material.Grey, Material.Shade100):
+                              Material.color(Material.Grey, Material.Shade800);
+
+    property color evenColor: (Material.theme == Material.Light) ?
+                               Material.color(Material.Grey, Material.Shade200):
+                               Material.color(Material.Grey, Material.Shade900);
+
+    property color highlightColor: Material.accentColor;
+    // @}
+
+    // @{ Bar policies.
+    verticalScrollBarPolicy: Qt.ScrollBarAsNeeded
+    horizontalScrollBarPolicy: Qt.ScrollBarAlwaysOff
+    // }
+
+
+    // @{ Header properties.
+    headerVisible: false
+    headerDelegate: Rectangle {
+        visible: false
     }
-  }
-  // @}
-
-  // @{ Style
-  style: TreeViewStyle {
-    branchDelegate: Rectangle {
-      height: itemHeight
-      width: itemHeight
-      color: "transparent"
-      // Adds a + or a - sign depending on the expanded state of the node.
-      Image {
-        id: branchImage
-        fillMode: Image.Pad
-        anchors.right: parent.right
+    TableViewColumn {
+      title: "Name"
+      role: "name"
+    }
+    // @}
+
+    // @{ Selection properties.
+    selection: ItemSelectionModel {
+      model: tree.model
+    }
+    selectionMode: SelectionMode.SingleSelection
+    // @}
+
+    // @{ Delegates
+    // Builds a row of the tree.
+    rowDelegate: Rectangle {
+      id: row
+      color: (styleData.selected)? highlightColor : (styleData.row % 2 == 0) ? evenColor : oddColor
+      height: itemHeight;
+    }
+
+    // Builds the data of the row.
+    itemDelegate: Item {
+      Text {
         anchors.verticalCenter: parent.verticalCenter
-        sourceSize.height: itemHeight * 0.4
-        sourceSize.width: itemHeight * 0.4
-        source: styleData.isExpanded ? "minus.png" : "plus.png"
+        color: (model !== null && model.match) ? tree.highlightColor : styleData.textColor
+        elide: styleData.elideMode
+        text: model === null ? "" : model.name + ": " + model.data
+        font.bold: model !== null && model.match
+        font.pointSize: 12
+        y: itemHeight * 0.2
+      }
+    }
+    // @}
+
+    // @{ Style
+    style: TreeViewStyle {
+      branchDelegate: Rectangle {
+        height: itemHeight
+        width: itemHeight
+        color: "transparent"
+        // Adds a + or a - sign depending on the expanded state of the node.
+        Image {
+          id: branchImage
+          fillMode: Image.Pad
+          anchors.right: parent.right
+          anchors.verticalCenter: parent.verticalCenter
+          sourceSize.height: itemHeight * 0.4
+          sourceSize.width: itemHeight * 0.4
+          source: styleData.isExpanded ? "minus.png" : "plus.png"
+        }
       }
     }
+    // @}
   }
-  // @}
 }
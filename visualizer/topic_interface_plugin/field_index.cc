@@ -0,0 +1,186 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "field_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace delphyne {
+namespace gui {
+namespace internal {
+namespace {
+
+// Separator of the path elements.
+constexpr char kPathSeparator[] = "::";
+
+// @returns A lower case copy of @p _str.
+std::string ToLower(const std::string& _str) {
+  std::string result(_str);
+  std::transform(result.begin(), result.end(), result.begin(),
+                 [](unsigned char _c) { return static_cast<char>(std::tolower(_c)); });
+  return result;
+}
+
+// @returns The sorted, unique trigrams of @p _str.
+std::vector<uint32_t> Trigrams(const std::string& _str) {
+  std::vector<uint32_t> trigrams;
+  for (size_t i = 0; i + 3 <= _str.size(); ++i) {
+    trigrams.push_back(static_cast<uint32_t>(static_cast<unsigned char>(_str[i])) << 16 |
+                       static_cast<uint32_t>(static_cast<unsigned char>(_str[i + 1])) << 8 |
+                       static_cast<uint32_t>(static_cast<unsigned char>(_str[i + 2])));
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  return trigrams;
+}
+
+}  // namespace
+
+void FieldIndex::Update(const std::string& _path, const std::string& _value) {
+  const auto it = ids.find(_path);
+  if (it != ids.end()) {
+    Field& field = fields[it->second];
+    field.lowerValue = ToLower(_value);
+    if (field.removed) {
+      field.removed = false;
+      --removedCount;
+    }
+    return;
+  }
+
+  const uint32_t id = static_cast<uint32_t>(fields.size());
+  fields.push_back(Field{_path, ToLower(_path), ToLower(_value)});
+  ids.emplace(_path, id);
+  const std::string& lowerPath = fields.back().lowerPath;
+  for (const uint32_t trigram : Trigrams(lowerPath)) {
+    trigramIds[trigram].push_back(id);
+  }
+  pathIds.emplace(lowerPath, id);
+  const size_t separator = lowerPath.rfind(kPathSeparator);
+  nameIds.emplace(separator == std::string::npos ? lowerPath : lowerPath.substr(separator + 2), id);
+}
+
+void FieldIndex::Remove(const std::string& _path) {
+  const auto it = ids.find(_path);
+  if (it == ids.end() || fields[it->second].removed) {
+    return;
+  }
+  Field& field = fields[it->second];
+  field.removed = true;
+  field.lowerValue.clear();
+  ++removedCount;
+}
+
+std::vector<std::string> FieldIndex::FindSubstring(const std::string& _query, size_t _maxResults) const {
+  const std::string query = ToLower(_query);
+  if (query.empty()) {
+    return {};
+  }
+
+  std::vector<uint32_t> matches;
+  if (query.size() >= 3) {
+    // Candidates are in the posting lists of all the query trigrams, starting
+    // from the shortest one.
+    std::vector<const std::vector<uint32_t>*> lists;
+    bool hasAllTrigrams{true};
+    for (const uint32_t trigram : Trigrams(query)) {
+      const auto it = trigramIds.find(trigram);
+      if (it == trigramIds.end()) {
+        hasAllTrigrams = false;
+        break;
+      }
+      lists.push_back(&it->second);
+    }
+    if (hasAllTrigrams) {
+      std::sort(lists.begin(), lists.end(),
+                [](const auto* _lhs, const auto* _rhs) { return _lhs->size() < _rhs->size(); });
+      std::vector<uint32_t> candidates = *lists.front();
+      for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        std::vector<uint32_t> intersection;
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+      }
+      for (const uint32_t id : candidates) {
+        if (fields[id].lowerPath.find(query) != std::string::npos) {
+          matches.push_back(id);
+        }
+      }
+    }
+  } else {
+    for (uint32_t id = 0; id < fields.size(); ++id) {
+      if (fields[id].lowerPath.find(query) != std::string::npos) {
+        matches.push_back(id);
+      }
+    }
+  }
+
+  for (uint32_t id = 0; id < fields.size(); ++id) {
+    if (fields[id].lowerValue.find(query) != std::string::npos) {
+      matches.push_back(id);
+    }
+  }
+  return ToPaths(std::move(matches), _maxResults);
+}
+
+std::vector<std::string> FieldIndex::FindPrefix(const std::string& _query, size_t _maxResults) const {
+  const std::string query = ToLower(_query);
+  if (query.empty()) {
+    return {};
+  }
+
+  std::vector<uint32_t> matches;
+  for (auto it = pathIds.lower_bound(query); it != pathIds.end() && it->first.compare(0, query.size(), query) == 0;
+       ++it) {
+    matches.push_back(it->second);
+  }
+  for (auto it = nameIds.lower_bound(query); it != nameIds.end() && it->first.compare(0, query.size(), query) == 0;
+       ++it) {
+    matches.push_back(it->second);
+  }
+  return ToPaths(std::move(matches), _maxResults);
+}
+
+std::vector<std::string> FieldIndex::ToPaths(std::vector<uint32_t> _ids, size_t _maxResults) const {
+  std::sort(_ids.begin(), _ids.end());
+  _ids.erase(std::unique(_ids.begin(), _ids.end()), _ids.end());
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < _ids.size() && paths.size() < _maxResults; ++i) {
+    if (!fields[_ids[i]].removed) {
+      paths.push_back(fields[_ids[i]].path);
+    }
+  }
+  return paths;
+}
+
+}  // namespace internal
+}  // namespace gui
+}  // namespace delphyne
@@ -0,0 +1,114 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace delphyne {
+namespace gui {
+namespace internal {
+
+/// @brief Case insensitive search index over message field paths and values.
+/// @details Fields are identified by their path, e.g. `model::3::pose::x`.
+///          Removed fields keep their index entries, so that a field coming
+///          back, e.g. a repeated entry of the shown message, is not indexed
+///          again, but are left out of the results. Paths are indexed by
+///          trigram for substring queries and kept sorted for prefix
+///          queries. Values change with every message, so instead of being
+///          indexed they are kept lower cased and scanned at query time,
+///          which costs less than reindexing them on each update.
+///          It is not thread-safe.
+class FieldIndex {
+ public:
+  /// @brief Adds a field, or updates its value when it exists.
+  /// @param _path The field path.
+  /// @param _value The field value, empty for compound fields.
+  void Update(const std::string& _path, const std::string& _value);
+
+  /// @brief Removes a field, until it is updated again.
+  /// @param _path The field path.
+  void Remove(const std::string& _path);
+
+  /// @return The number of fields, not counting the removed ones.
+  size_t Size() const { return ids.size() - removedCount; }
+
+  /// @brief Finds the fields whose path or value contain @p _query.
+  /// @param _query The text to find.
+  /// @param _maxResults Maximum number of fields to return.
+  /// @return The paths of the matching fields, in insertion order.
+  std::vector<std::string> FindSubstring(const std::string& _query, size_t _maxResults) const;
+
+  /// @brief Finds the fields whose path, or the last element of it, start
+  ///        with @p _query.
+  /// @param _query The text to find.
+  /// @param _maxResults Maximum number of fields to return.
+  /// @return The paths of the matching fields, in insertion order.
+  std::vector<std::string> FindPrefix(const std::string& _query, size_t _maxResults) const;
+
+ private:
+  // An indexed field.
+  struct Field {
+    std::string path;
+    std::string lowerPath;
+    std::string lowerValue;
+    bool removed{false};
+  };
+
+  // Collects the paths of @p _ids, sorted, up to @p _maxResults.
+  std::vector<std::string> ToPaths(std::vector<uint32_t> _ids, size_t _maxResults) const;
+
+  // Fields, by id.
+  std::vector<Field> fields;
+
+  // Field ids, by path.
+  std::unordered_map<std::string, uint32_t> ids;
+
+  // Number of removed fields.
+  size_t removedCount{0};
+
+  // Ids of the fields whose lower cased path contains each trigram. Ids are
+  // appended in increasing order, so lists are sorted.
+  std::unordered_map<uint32_t, std::vector<uint32_t>> trigramIds;
+
+  // Field ids by lower cased path, for prefix queries.
+  std::map<std::string, uint32_t> pathIds;
+
+  // Field ids by lower cased last path element, for prefix queries.
+  std::multimap<std::string, uint32_t> nameIds;
+};
+
+}  // namespace internal
+}  // namespace gui
+}  // namespace delphyne
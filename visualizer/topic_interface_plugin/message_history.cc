@@ -0,0 +1,74 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "message_history.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace delphyne {
+namespace gui {
+namespace internal {
+
+MessageHistory::MessageHistory(size_t _maxMessages, const Clock::duration& _maxAge, size_t _maxBytes)
+    : maxMessages(_maxMessages), maxAge(_maxAge), maxBytes(_maxBytes) {}
+
+void MessageHistory::Add(Entry _entry) {
+  bytes += _entry.data->size();
+  entries.push_back(std::move(_entry));
+  const Clock::time_point newest = entries.back().time;
+  // The newest message is always kept, even over the byte budget.
+  while (entries.size() > 1 && ((maxMessages > 0 && entries.size() > maxMessages) ||
+                                (maxAge > Clock::duration::zero() && newest - entries.front().time > maxAge) ||
+                                (maxBytes > 0 && bytes > maxBytes))) {
+    bytes -= entries.front().data->size();
+    entries.pop_front();
+  }
+}
+
+void MessageHistory::Clear() {
+  entries.clear();
+  bytes = 0;
+}
+
+size_t MessageHistory::LatestOf(const std::string& _topic, size_t _index) const {
+  if (entries.empty()) {
+    return 0;
+  }
+  for (size_t i = std::min(_index, entries.size() - 1) + 1; i > 0; --i) {
+    if (entries[i - 1].topic == _topic) {
+      return i - 1;
+    }
+  }
+  return entries.size();
+}
+
+}  // namespace internal
+}  // namespace gui
+}  // namespace delphyne
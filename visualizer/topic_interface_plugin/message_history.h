@@ -0,0 +1,105 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2022, Woven Planet. All rights reserved.
+// Copyright (c) 2021-2022, Toyota Research Institute. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace delphyne {
+namespace gui {
+namespace internal {
+
+/// @brief Ring of the latest serialized messages of one or more topics.
+/// @details Messages are kept serialized, shared with their other consumers,
+///          and only parsed by the caller when they are looked at. The oldest
+///          messages are evicted once the history exceeds any of its message
+///          count, age or byte budgets. Age is measured from the newest
+///          message. It is not thread-safe.
+class MessageHistory {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief A recorded message.
+  struct Entry {
+    /// Reception time.
+    Clock::time_point time;
+    /// Topic of the message.
+    std::string topic;
+    /// Message type, e.g. "ignition.msgs.Scene".
+    std::string msgType;
+    /// Serialized message.
+    std::shared_ptr<const std::string> data;
+  };
+
+  /// @brief Constructs an empty history.
+  /// @param _maxMessages Maximum number of messages, zero for no limit.
+  /// @param _maxAge Maximum age of the messages, zero for no limit.
+  /// @param _maxBytes Maximum size of the serialized messages, zero for no
+  ///        limit.
+  MessageHistory(size_t _maxMessages, const Clock::duration& _maxAge, size_t _maxBytes);
+
+  /// @brief Appends @p _entry, evicting the oldest messages over budget.
+  void Add(Entry _entry);
+
+  /// @brief Removes all the messages.
+  void Clear();
+
+  /// @return The number of messages.
+  size_t Size() const { return entries.size(); }
+
+  /// @return The size of the serialized messages.
+  size_t Bytes() const { return bytes; }
+
+  /// @return The @p _index -th oldest message.
+  /// @pre @p _index is less than Size().
+  const Entry& At(size_t _index) const { return entries[_index]; }
+
+  /// @return The index of the newest message of @p _topic at or before
+  ///         @p _index, or Size() when there is none.
+  size_t LatestOf(const std::string& _topic, size_t _index) const;
+
+ private:
+  const size_t maxMessages;
+  const Clock::duration maxAge;
+  const size_t maxBytes;
+
+  // Messages, oldest first.
+  std::deque<Entry> entries;
+
+  // Size of the serialized messages in `entries`.
+  size_t bytes{0};
+};
+
+}  // namespace internal
+}  // namespace gui
+}  // namespace delphyne
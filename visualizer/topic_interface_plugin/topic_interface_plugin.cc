@@ -36,16 +36,25 @@
 #include <map>
 #include <regex>
 #include <sstream>
+#include <unordered_set>
 #include <utility>
 
 #include <ignition/common/Console.hh>
 #include <ignition/gui/Application.hh>
 #include <ignition/plugin/Register.hh>
 
+#include "visualizer/plugin_metrics.hh"
+
 namespace delphyne {
 namespace gui {
 namespace {
 
+// Topic to watch when none is configured.
+constexpr char kDefaultTopicName[] = "/echo";
+
+// History budget when none is configured.
+constexpr double kDefaultHistoryMegabytes{16.};
+
 // Serializes a @p _value into @p _os. Provides a valid operator overload for
 // internal::Message::EnumValue so the following function's lambda can be
 // resolved.
@@ -103,59 +112,305 @@ std::string GetRepeatedName(const std::string _fullName) {
                                   : (scopedName.substr(pos + strlen("::")) + ": " + lastName);
 }
 
+// Time spent refreshing a topic tree out of its latest message, searching
+// the trees, and handling received messages and their payload size.
+const PluginMetrics::CounterHandle kRefreshMetrics =
+    PluginMetrics::Instance()->Register("TopicInterfacePlugin", "refresh");
+const PluginMetrics::CounterHandle kSearchMetrics =
+    PluginMetrics::Instance()->Register("TopicInterfacePlugin", "search");
+const PluginMetrics::CounterHandle kMessageMetrics =
+    PluginMetrics::Instance()->Register("TopicInterfacePlugin", "message");
+
 }  // namespace
 
 TopicInterfacePlugin::TopicInterfacePlugin() : ignition::gui::Plugin() {
   messageModel = new MessageModel;
-  ignition::gui::App()->Engine()->rootContext()->setContextProperty("MessageModel", messageModel);
+  messageModel->setParent(this);
 }
 
-QStandardItemModel* TopicInterfacePlugin::Model() {
-  std::lock_guard<std::mutex> lock(mutex);
-  return reinterpret_cast<QStandardItemModel*>(messageModel);
-}
+QStandardItemModel* TopicInterfacePlugin::Model() { return messageModel; }
 
 void TopicInterfacePlugin::LoadConfig(const tinyxml2::XMLElement* _pluginElem) {
   if (title.empty()) {
     title = "Topic interface";
   }
 
+  // Topic names and rate caps.
+  std::vector<std::pair<std::string, double>> topicConfigs;
   if (_pluginElem) {
     // Widget UI title.
     if (auto xmlTitle = _pluginElem->FirstChildElement("title")) {
-      title = xmlTitle->GetText();
+      if (xmlTitle->GetText()) {
+        title = xmlTitle->GetText();
+      }
     }
     // Transport configuration.
-    if (auto xmlTopicName = _pluginElem->FirstChildElement("topic")) {
-      topicName = xmlTopicName->GetText();
+    for (auto xmlTopicName = _pluginElem->FirstChildElement("topic"); xmlTopicName != nullptr;
+         xmlTopicName = xmlTopicName->NextSiblingElement("topic")) {
+      if (!xmlTopicName->GetText()) {
+        ignwarn << "Ignoring empty <topic>." << std::endl;
+        continue;
+      }
+      double maxRate{0.};
+      xmlTopicName->QueryDoubleAttribute("max_rate", &maxRate);
+      topicConfigs.emplace_back(xmlTopicName->GetText(), maxRate);
+    }
+    // Message history.
+    if (auto xmlHistory = _pluginElem->FirstChildElement("history")) {
+      unsigned int maxMessages{0};
+      double maxSeconds{0.};
+      double maxMegabytes{0.};
+      xmlHistory->QueryUnsignedAttribute("messages", &maxMessages);
+      xmlHistory->QueryDoubleAttribute("seconds", &maxSeconds);
+      xmlHistory->QueryDoubleAttribute("megabytes", &maxMegabytes);
+      if (maxMessages == 0 && maxSeconds <= 0. && maxMegabytes <= 0.) {
+        maxMegabytes = kDefaultHistoryMegabytes;
+      }
+      history = std::make_unique<internal::MessageHistory>(
+          maxMessages, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(maxSeconds)),
+          static_cast<size_t>(maxMegabytes * 1024. * 1024.));
     }
     // Visibility per widget.
     for (auto xmlHideWidgetElement = _pluginElem->FirstChildElement("hide"); xmlHideWidgetElement != nullptr;
          xmlHideWidgetElement = xmlHideWidgetElement->NextSiblingElement("hide")) {
-      hideWidgets.push_back(xmlHideWidgetElement->GetText());
+      if (xmlHideWidgetElement->GetText()) {
+        hideWidgets.push_back(xmlHideWidgetElement->GetText());
+      }
     }
   }
+  if (topicConfigs.empty()) {
+    topicConfigs.emplace_back(kDefaultTopicName, 0.);
+  }
 
-  // Subscribe
-  if (!node.Subscribe(topicName, &TopicInterfacePlugin::OnMessage, this)) {
-    ignerr << "Failed to subscribe to topic [" << topicName << "]" << std::endl;
+  for (const auto& topicConfig : topicConfigs) {
+    auto topic = std::make_unique<TopicView>();
+    topic->name = topicConfig.first;
+    if (topicConfig.second > 0.) {
+      topic->minPeriod =
+          std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / topicConfig.second));
+    }
+    // A single topic shows its fields at the root of the tree.
+    if (topicConfigs.size() == 1) {
+      topic->root = messageModel->invisibleRootItem();
+    } else {
+      topic->root = new QStandardItem(QString::fromStdString(topic->name));
+      topic->root->setData(QVariant(QString::fromStdString(topic->name)), MessageModel::kNameRole);
+      topic->root->setData(QVariant(QString("topic")), MessageModel::kTypeRole);
+      topic->root->setData(QVariant(QString("")), MessageModel::kDataRole);
+      topic->root->setData(QVariant(false), MessageModel::kMatchRole);
+      messageModel->appendRow(topic->root);
+      topic->indexPrefix = topic->name + "::";
+      indexedItems.emplace(topic->name, topic->root);
+      fieldIndex.Update(topic->name, "");
+    }
+
+    // Subscribe. Messages are kept serialized, in the history too, and
+    // parsed only when shown.
+    TopicView* topicView = topic.get();
+    topic->subscription = SubscriptionHub::Instance()->SubscribeRaw(
+        topic->name,
+        [this, topicView](const SubscriptionHub::DataPtr& _msgData, const ignition::transport::MessageInfo& _info) {
+          OnMessage(topicView, _msgData, _info);
+        });
+    if (topic->subscription == nullptr) {
+      ignerr << "Failed to subscribe to topic [" << topic->name << "]" << std::endl;
+    }
+    topics.push_back(std::move(topic));
+  }
+
+  refreshTimer.start(kRefreshPeriodInMs, this);
+}
+
+void TopicInterfacePlugin::timerEvent(QTimerEvent* _event) {
+  if (_event->timerId() != refreshTimer.timerId()) {
+    return;
+  }
+  if (frozen) {
+    return;
+  }
+  const Clock::time_point now = Clock::now();
+  for (const std::unique_ptr<TopicView>& topic : topics) {
+    if (now - topic->lastRefresh < topic->minPeriod) {
+      continue;
+    }
+    SubscriptionHub::DataPtr msgData;
+    std::string msgType;
+    {
+      std::lock_guard<std::mutex> lock(topic->mutex);
+      msgData = std::move(topic->latestData);
+      topic->latestData = nullptr;
+      msgType = topic->latestType;
+    }
+    if (msgData != nullptr) {
+      topic->lastRefresh = now;
+      Refresh(topic.get(), msgType, *msgData);
+    }
   }
 
-  // Configures the callback that will be used to update the view.
-  connect(this, SIGNAL(MessageReceived()), this, SLOT(OnMessageReceived()));
+  if (history != nullptr) {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    const int size = static_cast<int>(history->Size());
+    if (size != historySize) {
+      historySize = size;
+      historyPosition = std::max(0, size - 1);
+      historyStatus = QString("Live, %1 messages, %2 KB").arg(size).arg(history->Bytes() / 1024);
+      HistoryChanged();
+    }
+  }
 }
 
-void TopicInterfacePlugin::OnMessageReceived() {
-  auto root = messageModel->invisibleRootItem();
+void TopicInterfacePlugin::SetFrozen(bool _frozen) {
+  if (history == nullptr || frozen == _frozen) {
+    return;
+  }
+  frozen = _frozen;
+  FrozenChanged();
+  if (!frozen) {
+    // Makes the next refresh update the history properties.
+    historySize = -1;
+    return;
+  }
+  size_t size{0};
+  {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    size = history->Size();
+  }
+  historySize = static_cast<int>(size);
+  if (size > 0) {
+    ShowHistory(size - 1);
+  }
+}
 
+void TopicInterfacePlugin::SetHistoryPosition(int _historyPosition) {
+  if (!frozen || historySize <= 0 || _historyPosition == historyPosition) {
+    return;
+  }
+  ShowHistory(static_cast<size_t>(std::clamp(_historyPosition, 0, historySize - 1)));
+}
+
+void TopicInterfacePlugin::ShowHistory(size_t _index) {
+  std::lock_guard<std::mutex> lock(historyMutex);
+  if (_index >= history->Size()) {
+    return;
+  }
+  for (const std::unique_ptr<TopicView>& topic : topics) {
+    const size_t topicIndex = history->LatestOf(topic->name, _index);
+    if (topicIndex < history->Size()) {
+      const internal::MessageHistory::Entry& entry = history->At(topicIndex);
+      Refresh(topic.get(), entry.msgType, *entry.data);
+    } else {
+      // The topic had no message yet at @p _index.
+      topic->visitedItems.clear();
+      RemoveMissingItems(topic.get());
+    }
+  }
+  const internal::MessageHistory::Entry& shown = history->At(_index);
+  const double age = std::chrono::duration<double>(history->At(history->Size() - 1).time - shown.time).count();
+  historyPosition = static_cast<int>(_index);
+  historyStatus = QString("Frozen, message %1 of %2 (%3), %4 s before the newest")
+                      .arg(_index + 1)
+                      .arg(history->Size())
+                      .arg(QString::fromStdString(shown.topic))
+                      .arg(age, 0, 'f', 3);
+  HistoryChanged();
+}
+
+void TopicInterfacePlugin::Refresh(TopicView* _topic, const google::protobuf::Message& _msg) {
+  const PluginMetrics::Scope metrics(kRefreshMetrics);
   // @{ Load the message values.
-  std::lock_guard<std::mutex> lock(mutex);
-  VisitMessages("", root, message.get(), true /* top level item */);
+  internal::Message message("", &_msg, false /* is not repeated */);
+  _topic->visitedItems.clear();
+  VisitMessages("", _topic->root, &message, true /* top level item */, _topic);
   // @}
+  RemoveMissingItems(_topic);
+}
+
+void TopicInterfacePlugin::RemoveMissingItems(TopicView* _topic) {
+  std::vector<std::string> missingNames;
+  for (const auto& nameItem : _topic->items) {
+    if (_topic->visitedItems.count(nameItem.second) == 0) {
+      missingNames.push_back(nameItem.first);
+    }
+  }
+  if (missingNames.empty()) {
+    return;
+  }
+  // Names extend their parent's name, so sorting them longest first removes
+  // children before their parents, which would delete them.
+  std::sort(missingNames.begin(), missingNames.end(),
+            [](const std::string& _lhs, const std::string& _rhs) { return _lhs.size() > _rhs.size(); });
+  for (const std::string& name : missingNames) {
+    QStandardItem* item = _topic->items.at(name);
+    _topic->items.erase(name);
+    const std::string path = _topic->indexPrefix + name;
+    indexedItems.erase(path);
+    fieldIndex.Remove(path);
+    matchedItems.erase(std::remove(matchedItems.begin(), matchedItems.end(), item), matchedItems.end());
+    // The item of the top level message is not in the model.
+    if (item->model() == nullptr) {
+      delete item;
+      continue;
+    }
+    QStandardItem* parent = item->parent() != nullptr ? item->parent() : messageModel->invisibleRootItem();
+    parent->removeRow(item->row());
+  }
+}
+
+QVariantList TopicInterfacePlugin::Search(const QString& _query) {
+  const PluginMetrics::Scope metrics(kSearchMetrics);
+  const Clock::time_point start = Clock::now();
+  for (QStandardItem* item : matchedItems) {
+    item->setData(QVariant(false), MessageModel::kMatchRole);
+  }
+  matchedItems.clear();
+
+  const std::string query = _query.trimmed().toStdString();
+  if (query.empty()) {
+    searchStatus = "";
+    SearchStatusChanged();
+    return {};
+  }
+  const std::vector<std::string> paths = query[0] == '^' ? fieldIndex.FindPrefix(query.substr(1), kMaxSearchResults)
+                                                         : fieldIndex.FindSubstring(query, kMaxSearchResults);
+
+  QVariantList expandIndices;
+  std::unordered_set<QStandardItem*> expandedItems;
+  for (const std::string& path : paths) {
+    const auto it = indexedItems.find(path);
+    if (it == indexedItems.end()) {
+      continue;
+    }
+    it->second->setData(QVariant(true), MessageModel::kMatchRole);
+    matchedItems.push_back(it->second);
+    // Ancestors are expanded from the root down.
+    std::vector<QStandardItem*> ancestors;
+    for (QStandardItem* parent = it->second->parent(); parent != nullptr; parent = parent->parent()) {
+      ancestors.push_back(parent);
+    }
+    for (auto ancestor = ancestors.rbegin(); ancestor != ancestors.rend(); ++ancestor) {
+      if (expandedItems.insert(*ancestor).second) {
+        expandIndices.append(QVariant::fromValue((*ancestor)->index()));
+      }
+    }
+  }
+
+  const double searchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  searchStatus = QString("%1 matches in %2 ms").arg(matchedItems.size()).arg(searchMs, 0, 'f', 3);
+  SearchStatusChanged();
+  return expandIndices;
+}
+
+void TopicInterfacePlugin::Refresh(TopicView* _topic, const std::string& _msgType, const std::string& _msgData) {
+  std::unique_ptr<google::protobuf::Message> msg = SubscriptionHub::NewMessage(_msgType);
+  if (msg == nullptr || !msg->ParseFromString(_msgData)) {
+    ignerr << "Unable to parse a [" << _msgType << "] message of [" << _topic->name << "]" << std::endl;
+    return;
+  }
+  Refresh(_topic, *msg);
 }
 
 void TopicInterfacePlugin::VisitMessages(const std::string& _name, QStandardItem* _parent, internal::Message* _message,
-                                         bool _isTopLevel) {
+                                         bool _isTopLevel, TopicView* _topic) {
   // Does not visit blacklisted items.
   // amendedName is the name of the field but it applies a lower case transformation
   // and removes the "::X::" of the name when it represents a repeated field.
@@ -171,19 +426,21 @@ void TopicInterfacePlugin::VisitMessages(const std::string& _name, QStandardItem
 
   QStandardItem* item{nullptr};
   bool shouldAppendToParent{false};
-  if (items.find(_name) != items.end()) {
-    item = items.at(_name);
+  const auto it = _topic->items.find(_name);
+  if (it != _topic->items.end()) {
+    item = it->second;
   } else {
     item = new QStandardItem(name);
-    items.emplace(_name, item);
+    _topic->items.emplace(_name, item);
     shouldAppendToParent = true;
   }
+  _topic->visitedItems.insert(item);
 
   QString data("");
   if (_message->IsCompound()) {
     for (const auto& name_child : _message->Children()) {
       VisitMessages(name_child.first, _isTopLevel ? _parent : item, name_child.second.get(),
-                    false /* not a top level element */);
+                    false /* not a top level element */, _topic);
     }
   } else {
     std::stringstream ss;
@@ -193,19 +450,36 @@ void TopicInterfacePlugin::VisitMessages(const std::string& _name, QStandardItem
   // When the item is a top level message, it is not added to the UI but its
   // children are.
   if (!_isTopLevel) {
-    item->setData(QVariant(name), MessageModel::kNameRole);
-    item->setData(QVariant(QString::fromStdString(_message->TypeName())), MessageModel::kTypeRole);
-    item->setData(QVariant(data), MessageModel::kDataRole);
+    const std::string path = _topic->indexPrefix + _name;
     if (shouldAppendToParent) {
+      item->setData(QVariant(name), MessageModel::kNameRole);
+      item->setData(QVariant(QString::fromStdString(_message->TypeName())), MessageModel::kTypeRole);
+      item->setData(QVariant(data), MessageModel::kDataRole);
+      item->setData(QVariant(false), MessageModel::kMatchRole);
       _parent->appendRow(item);
+      indexedItems.emplace(path, item);
+      fieldIndex.Update(path, data.toStdString());
+    } else if (item->data(MessageModel::kDataRole).toString() != data) {
+      // Only changed leaves are updated in the model and the search index.
+      item->setData(QVariant(data), MessageModel::kDataRole);
+      fieldIndex.Update(path, data.toStdString());
     }
   }
 }
 
-void TopicInterfacePlugin::OnMessage(const google::protobuf::Message& _msg) {
-  std::lock_guard<std::mutex> lock(mutex);
-  message = std::make_unique<internal::Message>("", &_msg, false /* is not repeated */);
-  emit MessageReceived();
+void TopicInterfacePlugin::OnMessage(TopicView* _topic, const SubscriptionHub::DataPtr& _msgData,
+                                     const ignition::transport::MessageInfo& _info) {
+  const PluginMetrics::Scope metrics(kMessageMetrics, _msgData->size());
+  if (frozen) {
+    return;
+  }
+  if (history != nullptr) {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    history->Add(internal::MessageHistory::Entry{Clock::now(), _topic->name, _info.Type(), _msgData});
+  }
+  std::lock_guard<std::mutex> lock(_topic->mutex);
+  _topic->latestData = _msgData;
+  _topic->latestType = _info.Type();
 }
 
 }  // namespace gui
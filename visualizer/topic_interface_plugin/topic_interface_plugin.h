@@ -29,17 +29,23 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <ignition/gui/Plugin.hh>
 #include <ignition/transport.hh>
 
+#include "field_index.h"
 #include "message.h"
+#include "message_history.h"
+#include "visualizer/subscription_hub.hh"
 
 namespace delphyne {
 namespace gui {
@@ -50,6 +56,7 @@ class MessageModel : public QStandardItemModel {
   static constexpr int kNameRole{101};
   static constexpr int kTypeRole{102};
   static constexpr int kDataRole{103};
+  static constexpr int kMatchRole{104};
 
   /// @brief roles and names of the model
   QHash<int, QByteArray> roleNames() const override {
@@ -57,27 +64,57 @@ class MessageModel : public QStandardItemModel {
         {kNameRole, "name"},
         {kTypeRole, "type"},
         {kDataRole, "data"},
+        {kMatchRole, "match"},
     };
   }
 };
 
 /// @brief Implements a topic interface plugin.
-/// @details The plugin subscribes to an ignition topic and updates in the UI
-///          the value of the message when it is received. Note that this plugin
-///          would subscribe to a topic in particular but will use Google
-///          protobuf's introspection and reflection API to parse the message
-///          and get its fields.
+/// @details The plugin subscribes to ignition topics and updates in the UI
+///          the value of their messages when they are received. Note that
+///          this plugin will use Google protobuf's introspection and
+///          reflection API to parse the messages and get their fields.
 ///          - Use `<topic>ignition_topic_name</topic>` to configure the topic
-///            name.
+///            name. Several `<topic>` elements can be given, each topic is
+///            then shown under its own root item. A `max_rate` attribute, in
+///            Hz, caps how often a topic is parsed and refreshed, e.g.
+///            `<topic max_rate="2">agents/state</topic>`. Messages received
+///            in between replace each other and are never parsed.
 ///          - Via the xml plugin configuration one can generate a blacklist of
 ///            types. Use multiple nodes like
 ///            `<hide>attribute0::attribute1::attribute2</hide>` to omit
 ///            displaying that specific element and all its descendants.
 ///          - Use `<title>My fancy title</title>` to select the widget display
 ///            title.
+///          - Use `<history messages="1000" seconds="30" megabytes="16"/>`
+///            to keep the latest serialized messages of the topics, within
+///            any of the given budgets (16 MB when none is given). Freezing
+///            the panel stops recording and lets the user scrub through the
+///            history, only the looked at messages are parsed.
+///          The search box finds fields whose path or value contain the
+///          query, or, when the query starts with `^`, whose path or name
+///          start with the rest of it. Matches are highlighted and their
+///          ancestors expanded. The search index is updated as fields
+///          are added or change value.
+///          Each instance owns its model, exposed to its QML as the `model`
+///          property, so several instances can live in the same window.
 class TopicInterfacePlugin : public ignition::gui::Plugin {
   Q_OBJECT
 
+  Q_PROPERTY(QStandardItemModel* model READ Model CONSTANT)
+
+  Q_PROPERTY(bool hasHistory READ HasHistory CONSTANT)
+
+  Q_PROPERTY(bool frozen READ Frozen WRITE SetFrozen NOTIFY FrozenChanged)
+
+  Q_PROPERTY(int historySize READ HistorySize NOTIFY HistoryChanged)
+
+  Q_PROPERTY(int historyPosition READ HistoryPosition WRITE SetHistoryPosition NOTIFY HistoryChanged)
+
+  Q_PROPERTY(QString historyStatus READ HistoryStatus NOTIFY HistoryChanged)
+
+  Q_PROPERTY(QString searchStatus READ SearchStatus NOTIFY SearchStatusChanged)
+
  public:
   /// @brief Constructor.
   TopicInterfacePlugin();
@@ -91,28 +128,129 @@ class TopicInterfacePlugin : public ignition::gui::Plugin {
   /// @return Pointer to the model of msgs & fields
   QStandardItemModel* Model();
 
-  /// @brief Callback executed when there is a new message from the topic.
-  /// @details Update the message.
-  /// @details @p _msg is converted into a Message and set to be
-  ///          displayed.
-  /// @param _msg The received message.
-  void OnMessage(const google::protobuf::Message& _msg);
+  /// @return Whether the messages history is kept.
+  Q_INVOKABLE bool HasHistory() const { return history != nullptr; }
 
- public slots:
+  /// @{ frozen accessors. While frozen, the history is neither recorded nor
+  ///    the live messages shown.
+  Q_INVOKABLE bool Frozen() const { return frozen; }
 
-  /// @brief Updates the UI with the values of messageModel.
-  /// @details Visits nodes in messageModel and creates / updates QStandardItems
-  ///          which are nested as a tree. New nodes in the tree are also
-  ///          registered in a dictionary for future quick reference when
-  ///          repeatedly calling this method.
-  void OnMessageReceived();
+  Q_INVOKABLE void SetFrozen(bool _frozen);
+  /// @}
+
+  /// @return The number of messages in the history.
+  Q_INVOKABLE int HistorySize() const { return historySize; }
+
+  /// @{ historyPosition accessors. The position is the index of the shown
+  ///    message in the history, it can only be set while frozen.
+  Q_INVOKABLE int HistoryPosition() const { return historyPosition; }
+
+  Q_INVOKABLE void SetHistoryPosition(int _historyPosition);
+  /// @}
+
+  /// @return A description of the history and the shown message.
+  Q_INVOKABLE QString HistoryStatus() const { return historyStatus; }
+
+  /// @brief Highlights the fields matching @p _query, see the class
+  ///        description for the query syntax.
+  /// @param _query The query, an empty one clears the highlights.
+  /// @return The indices of the items to expand to show the matches, parents
+  ///         first.
+  Q_INVOKABLE QVariantList Search(const QString& _query);
+
+  /// @return The number of matches of the last search and its duration.
+  Q_INVOKABLE QString SearchStatus() const { return searchStatus; }
 
  signals:
+  /// Signals to notify that the properties have changed.
+  void FrozenChanged();
+  void HistoryChanged();
+  void SearchStatusChanged();
 
-  /// @brief Triggered from OnMessage() to synchronize the UI update.
-  void MessageReceived();
+ protected:
+  /// @brief Refreshes the topics with new messages whose rate cap allows it.
+  void timerEvent(QTimerEvent* _event) override;
 
  private:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Period to look for new messages to display.
+  static constexpr int kRefreshPeriodInMs{20};
+
+  /// @brief Maximum number of highlighted search matches.
+  static constexpr size_t kMaxSearchResults{500};
+
+  /// @brief A watched topic.
+  struct TopicView {
+    /// @brief The topic name.
+    std::string name;
+
+    /// @brief Minimum time between refreshes, zero when not capped.
+    Clock::duration minPeriod{Clock::duration::zero()};
+
+    /// @brief Time of the last refresh.
+    Clock::time_point lastRefresh;
+
+    /// @brief Parent item of the topic fields.
+    QStandardItem* root{nullptr};
+
+    /// @brief Prefix of the topic fields paths in the search index.
+    std::string indexPrefix;
+
+    /// @brief Keeps a record of items and their names to avoid creating
+    ///        unnecessary new items.
+    std::unordered_map<std::string, QStandardItem*> items;
+
+    /// @brief Items visited by the ongoing refresh, the other ones are not
+    ///        in the shown message.
+    std::unordered_set<QStandardItem*> visitedItems;
+
+    /// @brief Latest serialized message not displayed yet, and its type.
+    ///        Protected by `mutex`.
+    SubscriptionHub::DataPtr latestData;
+    std::string latestType;
+
+    /// @brief Mutex to protect `latestData` between threads.
+    std::mutex mutex;
+
+    /// @brief Subscription to the topic, shared with the other plugins.
+    /// @details Declared last, so it is destroyed before the members its
+    ///          callback uses.
+    std::unique_ptr<SubscriptionHub::Subscription> subscription;
+  };
+
+  /// @brief Callback executed when there is a new message from a topic.
+  /// @details Records @p _msgData in the history, when kept, and keeps it,
+  ///          without parsing it, until the next refresh of @p _topic.
+  /// @param _topic The topic of @p _msgData.
+  /// @param _msgData The received message.
+  /// @param _info Meta-information about the message received.
+  void OnMessage(TopicView* _topic, const SubscriptionHub::DataPtr& _msgData,
+                 const ignition::transport::MessageInfo& _info);
+
+  /// @brief Parses @p _msgData of type @p _msgType and shows it in @p _topic.
+  void Refresh(TopicView* _topic, const std::string& _msgType, const std::string& _msgData);
+
+  /// @brief Shows, for each topic, the newest message at or before
+  ///        @p _index in the history and updates the history properties.
+  void ShowHistory(size_t _index);
+
+  /// @brief Updates the UI with the values of @p _msg.
+  /// @details Visits nodes in @p _msg and creates / updates QStandardItems
+  ///          which are nested as a tree. New nodes in the tree are also
+  ///          registered in a dictionary for future quick reference when
+  ///          repeatedly calling this method. Items missing from @p _msg are
+  ///          removed.
+  /// @param _topic The topic of @p _msg.
+  /// @param _msg The message to display.
+  void Refresh(TopicView* _topic, const google::protobuf::Message& _msg);
+
+  /// @brief Removes the items of @p _topic not visited by the last refresh,
+  ///        i.e. the fields and repeated entries missing from the shown
+  ///        message, e.g. when scrubbing back to an older one.
+  /// @param _topic The refreshed topic.
+  void RemoveMissingItems(TopicView* _topic);
+
   /// @brief Visits nodes in @p _message and adds them as new rows of a
   ///        @p _parent item when they are not there.
   /// @details This function implements a visitor pattern and is called
@@ -126,32 +264,52 @@ class TopicInterfacePlugin : public ignition::gui::Plugin {
   /// @param _message The message to fill in an UI item.
   /// @param _isTopLevel Whether @p _message is a top level item in the
   ///        tree hierarchy.
-  void VisitMessages(const std::string& _name, QStandardItem* _parent, internal::Message* _message, bool _isTopLevel);
-
-  /// @brief The type of the message to receive.
-  std::string msgType{};
-
-  /// @brief The topic name to listen to.
-  std::string topicName{"/echo"};
+  /// @param _topic The topic of @p _message.
+  void VisitMessages(const std::string& _name, QStandardItem* _parent, internal::Message* _message, bool _isTopLevel,
+                     TopicView* _topic);
 
   /// @brief List of message types to hide.
   std::vector<std::string> hideWidgets;
 
-  /// @brief Latest received message
-  std::unique_ptr<internal::Message> message;
+  /// @brief ComponentsModel componentsModel;
+  MessageModel* messageModel{nullptr};
 
-  /// @brief Transport node.
-  ignition::transport::Node node;
+  /// @brief Triggers an event every `kRefreshPeriodInMs`.
+  QBasicTimer refreshTimer;
 
-  /// @brief Mutex to protect message changes between threads.
-  std::mutex mutex;
+  /// @brief Serialized messages of all the topics, protected by
+  ///        `historyMutex`. Null when the history is not kept.
+  std::unique_ptr<internal::MessageHistory> history;
 
-  /// @brief ComponentsModel componentsModel;
-  MessageModel* messageModel{nullptr};
+  /// @brief Mutex to protect `history` between threads.
+  std::mutex historyMutex;
+
+  /// @brief See Frozen().
+  std::atomic<bool> frozen{false};
+
+  /// @brief See HistorySize().
+  int historySize{0};
+
+  /// @brief See HistoryPosition().
+  int historyPosition{0};
+
+  /// @brief See HistoryStatus().
+  QString historyStatus;
+
+  /// @brief Search index of the fields of all the topics.
+  internal::FieldIndex fieldIndex;
+
+  /// @brief Items of the fields in `fieldIndex`, keyed by their path.
+  std::unordered_map<std::string, QStandardItem*> indexedItems;
+
+  /// @brief Items highlighted by the last search.
+  std::vector<QStandardItem*> matchedItems;
+
+  /// @brief See SearchStatus().
+  QString searchStatus;
 
-  /// @brief Keeps a record of items and their names to avoid creating
-  ///        unnecessary new items.
-  std::unordered_map<std::string, QStandardItem*> items;
+  /// @brief The watched topics.
+  std::vector<std::unique_ptr<TopicView>> topics;
 };
 
 }  // namespace gui
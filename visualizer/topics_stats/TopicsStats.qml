@@ -89,6 +89,14 @@ Rectangle {
         role: "bandwidth"
         title: "Bandwidth"
     }
+    TableViewColumn {
+        role: "subscribers"
+        title: "Subscribers"
+    }
+    TableViewColumn {
+        role: "parseSaved"
+        title: "Parse saved"
+    }
     model: ListModel {
       id: tableModel
       // This list will be updated dynamically when
@@ -112,11 +120,13 @@ Rectangle {
       target: TopicsStats
       onDisplayedTopicDataChanged: {
         tableModel.clear()
-        for (var i = 0; i < TopicsStats.displayedTopicData.length; i = i + 4)  {
+        for (var i = 0; i < TopicsStats.displayedTopicData.length; i = i + 6)  {
           tableModel.append({"topic": TopicsStats.displayedTopicData[i],
                              "messages": TopicsStats.displayedTopicData[i+1],
                              "frequency" : TopicsStats.displayedTopicData[i+2],
-                             "bandwidth" : TopicsStats.displayedTopicData[i+3]})
+                             "bandwidth" : TopicsStats.displayedTopicData[i+3],
+                             "subscribers" : TopicsStats.displayedTopicData[i+4],
+                             "parseSaved" : TopicsStats.displayedTopicData[i+5]})
         }
       }
   }
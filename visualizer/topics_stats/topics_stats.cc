@@ -29,13 +29,17 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "topics_stats.hh"
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 #include <ignition/common/Console.hh>
 #include <ignition/plugin/Register.hh>
 
+#include "visualizer/plugin_metrics.hh"
+
 namespace delphyne {
 namespace gui {
 namespace {
@@ -67,6 +71,11 @@ std::string GetBandwidth(uint64_t _bytesInASec) {
   return ToStringWithPrecision(_bytesInASec, 2 /* decimal places */, units);
 }
 
+// Time spent counting each received message, along with its bytes, and on
+// the timer that refreshes the topic list and the table.
+const PluginMetrics::CounterHandle kMessageMetrics = PluginMetrics::Instance()->Register("TopicsStats", "message");
+const PluginMetrics::CounterHandle kTimerMetrics = PluginMetrics::Instance()->Register("TopicsStats", "timer");
+
 }  // namespace
 
 TopicsStats::TopicsStats() : Plugin() { timer.start(kTimerPeriodInMs, this); }
@@ -75,8 +84,9 @@ void TopicsStats::LoadConfig(const tinyxml2::XMLElement* /*_pluginElem*/) {
   if (this->title.empty()) this->title = "Topics Stats";
 }
 
-void TopicsStats::OnMessage(const char* /*_msgData*/, const size_t _size,
-                            const ignition::transport::MessageInfo& _info) {
+void TopicsStats::OnMessage(const SubscriptionHub::DataPtr& _msgData, const ignition::transport::MessageInfo& _info) {
+  const size_t size = _msgData->size();
+  const PluginMetrics::Scope metrics(kMessageMetrics, size);
   const auto topic = _info.Topic();
 
   const auto& statsPair = rawData.find(topic);
@@ -92,7 +102,7 @@ void TopicsStats::OnMessage(const char* /*_msgData*/, const size_t _size,
   statsPair->second.numMessagesInLastSec++;
 
   // Update the number of bytes received during the last second.
-  statsPair->second.numBytesInLastSec += _size;
+  statsPair->second.numBytesInLastSec += size;
 }
 
 QStringList TopicsStats::DisplayedTopicData() const { return displayedTopicData; }
@@ -105,6 +115,7 @@ void TopicsStats::SetDisplayedTopicData(const QStringList& _data) {
 void TopicsStats::SearchTopic(const QString& _topic) { topicFilter = _topic.toStdString(); }
 
 void TopicsStats::timerEvent(QTimerEvent*) {
+  const PluginMetrics::Scope metrics(kTimerMetrics);
   // Get all the unique topics.
   std::vector<std::string> topics;
   node.TopicList(topics);
@@ -114,7 +125,7 @@ void TopicsStats::timerEvent(QTimerEvent*) {
     auto topic = prevTopics.at(i);
     if (std::find(topics.begin(), topics.end(), topic) == topics.end()) {
       // Unsubscribe from the topic.
-      node.Unsubscribe(topic);
+      subscriptions.erase(topic);
       // Do not track stats for this topic anymore.
       rawData.erase(topic);
     }
@@ -125,14 +136,15 @@ void TopicsStats::timerEvent(QTimerEvent*) {
     const std::string& topic = topics.at(i);
     if (std::find(prevTopics.begin(), prevTopics.end(), topic) == prevTopics.end()) {
       // Subscribe to the topic.
-      auto cb =
-          std::bind(&TopicsStats::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      if (!node.SubscribeRaw(topic, cb)) {
-        ignerr << "Error subscribing to [" << topic << "]" << std::endl;
-        continue;
-      }
       // Start tracking stats for this topic.
       rawData[topic] = BasicStats();
+      auto subscription = SubscriptionHub::Instance()->SubscribeRaw(
+          topic, std::bind(&TopicsStats::OnMessage, this, std::placeholders::_1, std::placeholders::_2));
+      if (subscription == nullptr) {
+        rawData.erase(topic);
+        continue;
+      }
+      subscriptions[topic] = std::move(subscription);
     }
   }
 
@@ -156,6 +168,10 @@ void TopicsStats::UpdateGUIStats() {
     displayedTopicData.append(
         QString::fromStdString(ToStringWithPrecision(topicData.second.numMessagesInLastSec, 0, "Hz")));
     displayedTopicData.append(QString::fromStdString(GetBandwidth(topicData.second.numBytesInLastSec)));
+    const SubscriptionHub::TopicStats hubStats = SubscriptionHub::Instance()->Stats(topicData.first);
+    displayedTopicData.append(QString::number(hubStats.subscribers));
+    displayedTopicData.append(QString::fromStdString(ToStringWithPrecision(
+        std::chrono::duration<double, std::milli>(hubStats.decodeTimeSaved).count(), 1, "ms")));
   }
   DisplayedTopicDataChanged();
 }
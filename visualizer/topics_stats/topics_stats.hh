@@ -31,16 +31,21 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <ignition/gui/Plugin.hh>
 #include <ignition/transport/Node.hh>
 
+#include "visualizer/subscription_hub.hh"
+
 namespace delphyne {
 namespace gui {
 
-/// \brief Show stats of all topics.
+/// \brief Show stats of all topics, along with how many subscribers share
+///        each topic through the SubscriptionHub and the parse time sharing
+///        saved.
 class TopicsStats : public ignition::gui::Plugin {
   Q_OBJECT
 
@@ -90,10 +95,9 @@ class TopicsStats : public ignition::gui::Plugin {
   /// \brief Function called each time a topic update is received.
   /// Note that this callback uses the generic signature, hence it may receive
   /// messages with different types.
-  /// \param[in] _msgData string of a serialized protobuf message.
-  /// \param[in] _size Number of bytes in the serialized message data.
+  /// \param[in] _msgData The serialized protobuf message.
   /// \param[in] _info Meta-information about the message received.
-  void OnMessage(const char* _msgData, const size_t _size, const ignition::transport::MessageInfo& _info);
+  void OnMessage(const SubscriptionHub::DataPtr& _msgData, const ignition::transport::MessageInfo& _info);
 
   /// \brief Update the stats of the GUI.
   void UpdateGUIStats();
@@ -111,8 +115,9 @@ class TopicsStats : public ignition::gui::Plugin {
 
   /// \brief Table data to be passed to the table.
   ///  The list is expected to be comformed using blocks of
-  ///  [`topic`, `messages`, `frequency`, `bandwidth`]. In the QML file
-  ///   this is parsed to get the four values for each row.
+  ///  [`topic`, `messages`, `frequency`, `bandwidth`, `subscribers`,
+  ///  `parse saved`]. In the QML file this is parsed to get the six values
+  ///  for each row.
   QStringList displayedTopicData;
 
   /// \brief Holds a user search by topic.
@@ -123,6 +128,9 @@ class TopicsStats : public ignition::gui::Plugin {
 
   /// \brief Transport node to obtain information of the topics.
   ignition::transport::Node node;
+
+  /// \brief Subscriptions of the topics in `rawData`, keyed by topic.
+  std::map<std::string, std::unique_ptr<SubscriptionHub::Subscription>> subscriptions;
 };
 
 }  // namespace gui
@@ -28,12 +28,20 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 
 #include <delphyne/utility/package.h>
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
+#include <tinyxml2.h>
 
 #ifndef Q_MOC_RUN
 #include <ignition/gui/Application.hh>
@@ -43,6 +51,8 @@
 
 #include "delphyne_gui/config.hh"
 #include "global_attributes.hh"
+#include "plugin_metrics.hh"
+#include "startup_tracer.hh"
 
 namespace delphyne_gui {
 namespace visualizer {
@@ -55,6 +65,17 @@ constexpr char kDefaultLayout[] = "layout_with_teleop.config";
 /// Environment variable to look for user custom plugins.
 constexpr char kVisualizerPluginPath[] = "VISUALIZER_PLUGIN_PATH";
 
+/// Plugins that need a render engine, they are left out of headless runs.
+constexpr const char* kRenderingPlugins[] = {"Scene3D", "Grid3D"};
+
+/// Period to check whether a headless run must end.
+constexpr int kHeadlessPollPeriodInMs = 100;
+
+/// Set by the SIGINT and SIGTERM handlers to end a headless run.
+volatile std::sig_atomic_t stopRequested = 0;
+
+void OnStopSignal(int /*_signal*/) { stopRequested = 1; }
+
 /////////////////////////////////////////////////
 /// \brief Get the path of the default configuration file for Delphyne.
 /// \return The default configuration path.
@@ -64,8 +85,50 @@ std::string defaultConfigPath() {
   return ignition::common::joinPaths(homePath, ".delphyne", "delphyne.config");
 }
 
+/////////////////////////////////////////////////
+/// \brief Copies a layout to run it headless: rendering plugins are removed,
+///        deferred plugins are replaced by the plugin they wrap so the full
+///        plugin set loads, and the exit dialog is disabled.
+/// \param[in] _path The layout to copy.
+/// \return The path of the copy, or an empty string when it fails.
+std::string headlessLayout(const std::string& _path) {
+  tinyxml2::XMLDocument doc;
+  if (doc.LoadFile(_path.c_str()) != tinyxml2::XML_SUCCESS) {
+    ignerr << "Unable to read layout [" << _path << "]" << std::endl;
+    return "";
+  }
+  tinyxml2::XMLElement* elem = doc.FirstChildElement("plugin");
+  while (elem != nullptr) {
+    tinyxml2::XMLElement* next = elem->NextSiblingElement("plugin");
+    const std::string filename = elem->Attribute("filename") ? elem->Attribute("filename") : "";
+    const tinyxml2::XMLElement* wrapped = elem->FirstChildElement("plugin");
+    if (filename == "DeferredPlugin" && wrapped != nullptr) {
+      doc.InsertAfterChild(elem, wrapped->DeepClone(&doc));
+      doc.DeleteChild(elem);
+    } else if (std::find(std::begin(kRenderingPlugins), std::end(kRenderingPlugins), filename) !=
+               std::end(kRenderingPlugins)) {
+      ignmsg << "Headless: skipping plugin [" << filename << "]" << std::endl;
+      doc.DeleteChild(elem);
+    }
+    elem = next;
+  }
+  if (auto window = doc.FirstChildElement("window")) {
+    if (auto dialogOnExit = window->FirstChildElement("dialog_on_exit")) {
+      dialogOnExit->SetText("false");
+    }
+  }
+  const std::string copyName = "visualizer_headless_" + std::to_string(QCoreApplication::applicationPid()) + ".config";
+  const std::string copyPath = ignition::common::joinPaths(QDir::tempPath().toStdString(), copyName);
+  if (doc.SaveFile(copyPath.c_str()) != tinyxml2::XML_SUCCESS) {
+    ignerr << "Unable to write layout [" << copyPath << "]" << std::endl;
+    return "";
+  }
+  return copyPath;
+}
+
 /////////////////////////////////////////////////
 int Main(int argc, char** argv) {
+  const auto startTime = delphyne::gui::StartupTracer::Clock::now();
   static const std::string initialConfigFile =
       ignition::common::joinPaths(DELPHYNE_INITIAL_CONFIG_PATH, kDefaultLayout);
 
@@ -76,6 +139,14 @@ int Main(int argc, char** argv) {
     delphyne::gui::GlobalAttributes::ParseArguments(argc - 1, &(argv[1]));
   }
 
+  // Startup phases are traced when a trace file is given.
+  std::unique_ptr<delphyne::gui::StartupTracer> tracer;
+  if (delphyne::gui::GlobalAttributes::HasArgument("trace-startup")) {
+    tracer = std::make_unique<delphyne::gui::StartupTracer>(
+        delphyne::gui::GlobalAttributes::GetArgument("trace-startup"), startTime);
+    tracer->AddSpan("ParseArguments", "phase", startTime, delphyne::gui::StartupTracer::Clock::now());
+  }
+
   // If we run the visualizer as a child process (like a demo written in
   // python), we need to ensure that it's not using a block buffer
   // to display everything that goes to the stdout in realtime.
@@ -86,16 +157,31 @@ int Main(int argc, char** argv) {
     }
   }
 
+  // Headless runs use Qt's offscreen platform and record plugin metrics until
+  // they end, after the given duration or on SIGINT / SIGTERM.
+  const bool headless = delphyne::gui::GlobalAttributes::HasArgument("headless") &&
+                        delphyne::gui::GlobalAttributes::GetArgument("headless") == "yes";
+  if (headless) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    delphyne::gui::PluginMetrics::Instance()->Enable();
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+  }
+
   // Parse custom config file from args.
-  delphyne::utility::PackageManager* package_manager = delphyne::utility::PackageManager::Instance();
-  if (delphyne::gui::GlobalAttributes::HasArgument("package")) {
-    package_manager->Use(
-        std::make_unique<delphyne::utility::BundledPackage>(delphyne::gui::GlobalAttributes::GetArgument("package")));
-  } else {
-    package_manager->Use(std::make_unique<delphyne::utility::SystemPackage>());
+  {
+    const delphyne::gui::StartupTracer::Scope scope(tracer.get(), "PackageManager", "phase");
+    delphyne::utility::PackageManager* package_manager = delphyne::utility::PackageManager::Instance();
+    if (delphyne::gui::GlobalAttributes::HasArgument("package")) {
+      package_manager->Use(std::make_unique<delphyne::utility::BundledPackage>(
+          delphyne::gui::GlobalAttributes::GetArgument("package")));
+    } else {
+      package_manager->Use(std::make_unique<delphyne::utility::SystemPackage>());
+    }
   }
 
   // Initialize app
+  auto appScope = std::make_unique<delphyne::gui::StartupTracer::Scope>(tracer.get(), "Application", "phase");
   ignition::gui::Application app(argc, argv);
 
   // Set the default location for saving user settings.
@@ -107,19 +193,47 @@ int Main(int argc, char** argv) {
   // Then look for plugins on compile-time defined path.
   // Plugins installed by delphyne_gui end up here
   app.AddPluginPath(PLUGIN_INSTALL_PATH);
+  appScope.reset();
+
+  // ign-gui only signals each plugin once it is added to the window, so the
+  // load of a plugin is not timed by itself. Each span goes from the previous
+  // plugin being added to this one: it covers the plugin library loading, its
+  // construction and LoadConfig() and its card creation, along with the
+  // layout parsing in between.
+  auto lastPluginTime = delphyne::gui::StartupTracer::Clock::now();
+  if (tracer) {
+    QObject::connect(&app, &ignition::gui::Application::PluginAdded, [&tracer, &lastPluginTime](const QString& _name) {
+      const auto now = delphyne::gui::StartupTracer::Clock::now();
+      tracer->AddSpan("Until " + _name.toStdString() + " added", "plugin_gap", lastPluginTime, now);
+      lastPluginTime = now;
+    });
+  }
 
   // Attempt to load window layout from parsed arguments.
-  bool layout_loaded = delphyne::gui::GlobalAttributes::HasArgument("layout") &&
-                       app.LoadConfig(delphyne::gui::GlobalAttributes::GetArgument("layout"));
-  // If no layout was found, attempt to use the default config file.
-  layout_loaded = layout_loaded || app.LoadDefaultConfig();
-  // If that's not available either, load it from initial config file.
-  layout_loaded = layout_loaded || app.LoadConfig(initialConfigFile);
+  auto layoutScope = std::make_unique<delphyne::gui::StartupTracer::Scope>(tracer.get(), "LoadLayout", "phase");
+  lastPluginTime = delphyne::gui::StartupTracer::Clock::now();
+  bool layout_loaded = false;
+  if (headless) {
+    // Headless runs ignore the user's default config file to be repeatable.
+    const std::string layout = headlessLayout(delphyne::gui::GlobalAttributes::HasArgument("layout")
+                                                  ? delphyne::gui::GlobalAttributes::GetArgument("layout")
+                                                  : initialConfigFile);
+    layout_loaded = !layout.empty() && app.LoadConfig(layout);
+    std::remove(layout.c_str());
+  } else {
+    layout_loaded = delphyne::gui::GlobalAttributes::HasArgument("layout") &&
+                    app.LoadConfig(delphyne::gui::GlobalAttributes::GetArgument("layout"));
+    // If no layout was found, attempt to use the default config file.
+    layout_loaded = layout_loaded || app.LoadDefaultConfig();
+    // If that's not available either, load it from initial config file.
+    layout_loaded = layout_loaded || app.LoadConfig(initialConfigFile);
+  }
   // If no layout has been loaded so far, exit the application.
   if (!layout_loaded) {
     ignerr << "Unable to load a configuration file, exiting." << std::endl;
     return 1;
   }
+  layoutScope.reset();
 
   // Create main window
   // this is a placeholder comment to ease comparisons with visualizer0.cc
@@ -127,9 +241,56 @@ int Main(int argc, char** argv) {
   auto win = app.findChild<ignition::gui::MainWindow*>()->QuickWindow();
   win->setProperty("title", kVersionStr);
 
+  // The trace ends once the event loop handles its first event, i.e. when the
+  // window starts showing.
+  if (tracer) {
+    const auto loopStartTime = delphyne::gui::StartupTracer::Clock::now();
+    QTimer::singleShot(0, [&tracer, loopStartTime, startTime]() {
+      const auto now = delphyne::gui::StartupTracer::Clock::now();
+      tracer->AddSpan("FirstEvent", "phase", loopStartTime, now);
+      tracer->AddSpan("Startup", "total", startTime, now);
+      tracer->Write();
+    });
+  }
+
+  // Headless runs poll for their end.
+  QTimer headlessTimer;
+  if (headless) {
+    // Without a duration, the run lasts until a signal arrives.
+    double durationSec{0.};
+    if (delphyne::gui::GlobalAttributes::HasArgument("headless-duration")) {
+      const std::string duration = delphyne::gui::GlobalAttributes::GetArgument("headless-duration");
+      std::istringstream durationStream(duration);
+      if (!(durationStream >> durationSec) || !(durationStream >> std::ws).eof() || !std::isfinite(durationSec) ||
+          durationSec < 0.) {
+        ignerr << "Invalid --headless-duration [" << duration << "], expected a non negative number of seconds."
+               << std::endl;
+        return 1;
+      }
+    }
+    const auto runEnd = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(durationSec));
+    QObject::connect(&headlessTimer, &QTimer::timeout, [&app, runEnd, durationSec]() {
+      if (stopRequested || (durationSec > 0. && std::chrono::steady_clock::now() >= runEnd)) {
+        app.quit();
+      }
+    });
+    headlessTimer.start(kHeadlessPollPeriodInMs);
+  }
+
   // Run window
   app.exec();
 
+  if (headless) {
+    if (delphyne::gui::GlobalAttributes::HasArgument("metrics-report")) {
+      delphyne::gui::PluginMetrics::Instance()->WriteReport(
+          delphyne::gui::GlobalAttributes::GetArgument("metrics-report"));
+    } else {
+      delphyne::gui::PluginMetrics::Instance()->WriteReport(std::cout);
+    }
+  }
+
   return 0;
 }
 